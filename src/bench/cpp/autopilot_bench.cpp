@@ -0,0 +1,991 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include "autopilot_bench.h"
+
+#include <wpi/timestamp.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <numbers>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "autopilot/autopilot.h"
+#include "autopilot/intercept.h"
+#include "autopilot/moving_target.h"
+#include "autopilot/rollout.h"
+#include "autopilot/runner.h"
+#include "autopilot/static_autopilot.h"
+#include "autopilot/target_set.h"
+#include "autopilot/telemetry.h"
+#include "autopilot/triple_buffer.h"
+#include "autopilot/velocity_field.h"
+
+namespace autopilot {
+/**
+ * Exposes Autopilot's private kernels to the benchmarks.
+ */
+struct APBenchAccess {
+  static units::meter_t SwirlyLength(Autopilot& ap, units::radian_t theta,
+                                     units::meter_t radius) {
+    return ap.CalculateSwirlyLength(theta, radius);
+  }
+
+  static units::meters_per_second_t MaxVelocity(
+      Autopilot& ap, units::meter_t dist, units::meters_per_second_t endVelo) {
+    return ap.CalculateMaxVelocity(dist, endVelo);
+  }
+};
+}  // namespace autopilot
+
+using namespace autopilot;
+
+namespace {
+// Inputs are cycled so that every call sees fresh data, but the set is small
+// enough to stay in L1.
+constexpr size_t kInputs = 256;
+
+struct Inputs {
+  std::vector<frc::Pose2d> poses;
+  std::vector<frc::Translation2d> velocities;
+  std::vector<double> values;
+  size_t next = 0;
+
+  size_t Next() {
+    next = (next + 1) % kInputs;
+    return next;
+  }
+};
+
+APProfile BenchProfile() {
+  return APProfile(APConstraints(4.5_mps, 3.0_mps_sq, 2.0))
+      .WithErrorXY(2_cm)
+      .WithErrorTheta(2_deg)
+      .WithBeelineRadius(8_cm);
+}
+
+// BenchProfile as compile time constants
+constexpr APStaticProfile kBenchStaticProfile{
+    .velocity = 4.5,
+    .acceleration = 3.0,
+    .jerk = 2.0,
+    .errorXY = 0.02,
+    .errorTheta = 2.0 * std::numbers::pi / 180.0,
+    .beelineRadius = 0.08};
+constexpr APStaticProfile kBenchStaticFastProfile{
+    .velocity = 4.5,
+    .acceleration = 3.0,
+    .jerk = 2.0,
+    .errorXY = 0.02,
+    .errorTheta = 2.0 * std::numbers::pi / 180.0,
+    .beelineRadius = 0.08,
+    .mathMode = APMathMode::kFast};
+constexpr APStaticProfile kBenchStaticFrictionProfile{
+    .velocity = 4.5,
+    .acceleration = 3.0,
+    .jerk = 2.0,
+    .errorXY = 0.02,
+    .errorTheta = 2.0 * std::numbers::pi / 180.0,
+    .beelineRadius = 0.08,
+    .frictionCircle = true};
+constexpr APStaticProfile kBenchStaticBrakingProfile{
+    .velocity = 4.5,
+    .acceleration = 3.0,
+    .jerk = 2.0,
+    .errorXY = 0.02,
+    .errorTheta = 2.0 * std::numbers::pi / 180.0,
+    .beelineRadius = 0.08,
+    .deceleration = 8.0,
+    .velocityX = 3.0,
+    .velocityY = 1.5};
+
+// Poses spread 1-6 m around the origin, with random headings and velocities
+std::shared_ptr<Inputs> MakeInputs(double minDist, double maxDist) {
+  std::mt19937 rng{5805};
+  std::uniform_real_distribution<double> angle(-3.14159, 3.14159);
+  std::uniform_real_distribution<double> dist(minDist, maxDist);
+  std::uniform_real_distribution<double> speed(-2.0, 2.0);
+
+  auto inputs = std::make_shared<Inputs>();
+  for (size_t i = 0; i < kInputs; ++i) {
+    frc::Rotation2d dir{units::radian_t{angle(rng)}};
+    inputs->poses.emplace_back(
+        frc::Translation2d{units::meter_t{dist(rng)}, dir},
+        frc::Rotation2d{units::radian_t{angle(rng)}});
+    inputs->velocities.emplace_back(units::meter_t{speed(rng)},
+                                    units::meter_t{speed(rng)});
+    inputs->values.push_back(angle(rng));
+  }
+  return inputs;
+}
+
+struct ErrorStats {
+  double max = 0.0;
+  double sum = 0.0;
+  size_t count = 0;
+
+  void Add(double exact, double approx) {
+    double error = exact == 0.0 ? std::abs(approx)
+                                : std::abs((approx - exact) / exact);
+    max = std::max(max, error);
+    sum += error;
+    ++count;
+  }
+};
+
+void PrintRow(const char* name, const ErrorStats& error, double bound,
+              const bench::Stats& exact, const bench::Stats& fast) {
+  std::printf("%-24s %12.3g %12.3g %12.3g %10.1f %10.1f %8.2fx\n", name,
+              error.max, error.sum / error.count, bound, exact.p50, fast.p50,
+              exact.p50 / fast.p50);
+}
+
+// Compares the fast kernels against the exact ones over every angle atan2 can
+// produce and distances from 0 to 20 m, then times both.
+void FastMathReport(const bench::Options& options) {
+  Autopilot exact{BenchProfile()};
+  Autopilot fast{BenchProfile()};
+  fast.WithMathMode(APMathMode::kFast);
+
+  constexpr int kSteps = 200000;
+  constexpr double kMaxDist = 20.0;
+
+  ErrorStats swirly;
+  for (int i = 0; i <= kSteps; ++i) {
+    units::radian_t theta{std::numbers::pi * (2.0 * i / kSteps - 1.0)};
+    for (double radius : {0.01, 1.0, 10.0}) {
+      swirly.Add(
+          APBenchAccess::SwirlyLength(exact, theta, units::meter_t{radius})
+              .value(),
+          APBenchAccess::SwirlyLength(fast, theta, units::meter_t{radius})
+              .value());
+    }
+  }
+
+  ErrorStats velocity;
+  for (int i = 0; i <= kSteps; ++i) {
+    units::meter_t dist{kMaxDist * i / kSteps};
+    velocity.Add(APBenchAccess::MaxVelocity(exact, dist, 0_mps).value(),
+                 APBenchAccess::MaxVelocity(fast, dist, 0_mps).value());
+  }
+
+  // End to end, as a fraction of the commanded speed
+  auto inputs = MakeInputs(0.1, kMaxDist);
+  APTarget target = APTarget{frc::Pose2d{}}.WithEntryAngle(90_deg);
+  ErrorStats calculate;
+  for (size_t i = 0; i < kInputs; ++i) {
+    APResult a =
+        exact.Calculate(inputs->poses[i], inputs->velocities[i], target);
+    APResult b =
+        fast.Calculate(inputs->poses[i], inputs->velocities[i], target);
+    calculate.Add(std::hypot(a.vx.value(), a.vy.value()),
+                  std::hypot(b.vx.value(), b.vy.value()));
+  }
+
+  auto time = [&](Autopilot& ap, int kernel) {
+    return bench::Measure(
+        [&ap, &inputs, &target, kernel] {
+          size_t i = inputs->Next();
+          units::meter_t dist = inputs->poses[i].Translation().Norm();
+          if (kernel == 0) {
+            bench::DoNotOptimize(APBenchAccess::SwirlyLength(
+                ap, units::radian_t{inputs->values[i]}, dist));
+          } else if (kernel == 1) {
+            bench::DoNotOptimize(APBenchAccess::MaxVelocity(ap, dist, 0_mps));
+          } else {
+            bench::DoNotOptimize(ap.Calculate(
+                inputs->poses[i], inputs->velocities[i], target));
+          }
+        },
+        options);
+  };
+
+  std::printf("%-24s %12s %12s %12s %10s %10s %9s\n", "kernel", "max rel err",
+              "mean rel err", "bound", "exact p50", "fast p50", "speedup");
+  PrintRow("CalculateSwirlyLength", swirly, fast::kSwirlyScaleError,
+           time(exact, 0), time(fast, 0));
+  PrintRow("CalculateMaxVelocity", velocity, fast::kPow2Over3Error,
+           time(exact, 1), time(fast, 1));
+  PrintRow("Calculate (speed)", calculate,
+           fast::kSwirlyScaleError + fast::kPow2Over3Error, time(exact, 2),
+           time(fast, 2));
+}
+
+// Compares the estimator against rollouts with a perfectly tracking
+// drivetrain
+void EtaReport(const bench::Options& options) {
+  Autopilot ap{BenchProfile()};
+  APRolloutEngine engine{ap, APRolloutOptions{.timeout = 30_s}};
+  std::vector<APRolloutSample> path(2048);
+  std::mt19937 rng{2025};
+  std::uniform_real_distribution<double> angle(-3.14159, 3.14159);
+  std::uniform_real_distribution<double> dist(0.5, 8.0);
+  std::uniform_real_distribution<double> speed(-2.0, 2.0);
+
+  constexpr int kScenarios = 500;
+  ErrorStats relative;
+  double maxAbsolute = 0.0;
+  int within5 = 0;
+  for (int i = 0; i < kScenarios; ++i) {
+    frc::Pose2d start{
+        frc::Translation2d{units::meter_t{dist(rng)},
+                           frc::Rotation2d{units::radian_t{angle(rng)}}},
+        frc::Rotation2d{}};
+    frc::Translation2d velocity{units::meter_t{speed(rng)},
+                                units::meter_t{speed(rng)}};
+    APTarget target{frc::Pose2d{}};
+    if (i % 2 == 0) {
+      target = target.WithEntryAngle(units::radian_t{angle(rng)});
+    }
+    double rollout = engine.Run(start, velocity, target, path).time.value();
+    double estimate =
+        ap.EstimateTimeToTarget(start, velocity, target).value();
+    relative.Add(rollout, estimate);
+    within5 += std::abs(estimate - rollout) <= 0.05 * rollout ? 1 : 0;
+    maxAbsolute = std::max(maxAbsolute, std::abs(rollout - estimate));
+  }
+
+  auto inputs = MakeInputs(0.5, 8.0);
+  APTarget target = APTarget{frc::Pose2d{}}.WithEntryAngle(90_deg);
+  bench::Stats cost = bench::Measure(
+      [&] {
+        size_t i = inputs->Next();
+        bench::DoNotOptimize(ap.EstimateTimeToTarget(
+            inputs->poses[i], inputs->velocities[i], target));
+      },
+      options);
+
+  std::printf("%d rollouts: max rel err %.3f, mean rel err %.3f, "
+              "max abs err %.3f s, %d within 5%%\n",
+              kScenarios, relative.max, relative.sum / relative.count,
+              maxAbsolute, within5);
+  std::printf("EstimateTimeToTarget: %.1f ns/call (p50 %.1f)\n", cost.mean,
+              cost.p50);
+}
+
+// Candidate scoring poses scattered over a 16 x 8 m field, facing random
+// directions with entry angles
+std::vector<APTarget> MakeCandidates(size_t count) {
+  std::mt19937 rng{count};
+  std::uniform_real_distribution<double> x(0.0, 16.0);
+  std::uniform_real_distribution<double> y(0.0, 8.0);
+  std::uniform_real_distribution<double> angle(-3.14159, 3.14159);
+  std::vector<APTarget> targets;
+  for (size_t i = 0; i < count; ++i) {
+    frc::Rotation2d heading{units::radian_t{angle(rng)}};
+    targets.push_back(
+        APTarget{frc::Pose2d{units::meter_t{x(rng)}, units::meter_t{y(rng)},
+                             heading}}
+            .WithEntryAngle(heading));
+  }
+  return targets;
+}
+
+size_t BruteForceBest(Autopilot& ap, const std::vector<APTarget>& targets,
+                      const frc::Pose2d& pose,
+                      const frc::Translation2d& velocity) {
+  size_t best = 0;
+  units::second_t bestTime{std::numeric_limits<double>::infinity()};
+  for (size_t i = 0; i < targets.size(); ++i) {
+    units::second_t time = ap.EstimateTimeToTarget(pose, velocity, targets[i]);
+    if (time < bestTime) {
+      best = i;
+      bestTime = time;
+    }
+  }
+  return best;
+}
+
+// Checks that the pruned search agrees with trying every candidate
+void TargetSetReport(const bench::Options&) {
+  Autopilot ap{BenchProfile()};
+  auto inputs = MakeInputs(0.0, 8.0);
+  for (size_t count : {12, 100, 1000}) {
+    std::vector<APTarget> targets = MakeCandidates(count);
+    APTargetSet set{ap, targets};
+    size_t agree = 0;
+    for (size_t i = 0; i < kInputs; ++i) {
+      frc::Pose2d pose{inputs->poses[i].Translation() +
+                           frc::Translation2d{8_m, 4_m},
+                       inputs->poses[i].Rotation()};
+      auto best = set.Best(pose, inputs->velocities[i]);
+      size_t expected =
+          BruteForceBest(ap, targets, pose, inputs->velocities[i]);
+      agree += best && best->index == expected ? 1 : 0;
+    }
+    std::printf("%5zu candidates: %zu/%zu states agree with brute force\n",
+                count, agree, kInputs);
+  }
+}
+
+// Streams records through a ring to another thread, retrying whenever the
+// ring is full, and checks that every record arrives exactly once and in
+// order
+void TelemetryReport(const bench::Options&) {
+  constexpr int kRecords = 1000000;
+  APTelemetryRing ring{1024};
+  auto start = std::chrono::steady_clock::now();
+  std::thread producer{[&ring] {
+    APRecord record;
+    for (int i = 0; i < kRecords; ++i) {
+      record.x = i;
+      while (!ring.TryPush(record)) {
+        std::this_thread::yield();
+      }
+    }
+  }};
+
+  APRecord record;
+  int received = 0;
+  int mismatched = 0;
+  while (received < kRecords) {
+    if (!ring.TryPop(record)) {
+      std::this_thread::yield();
+      continue;
+    }
+    mismatched += record.x == received ? 0 : 1;
+    ++received;
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  producer.join();
+
+  std::printf("%d records: %d mismatched, ring full %llu times, "
+              "%.1f ns/record\n",
+              kRecords, mismatched,
+              static_cast<unsigned long long>(ring.Dropped()),
+              std::chrono::duration<double, std::nano>(elapsed).count() /
+                  kRecords);
+}
+
+// Measures how far each mode's command is from the velocity it was given,
+// as an acceleration, and checks that the batched and compile time paths
+// agree with the scalar one under the friction circle
+void FrictionCircleReport(const bench::Options&) {
+  auto inputs = MakeInputs(0.0, 6.0);
+  const APTarget target =
+      APTarget{frc::Pose2d{}}.WithEntryAngle(frc::Rotation2d{90_deg});
+  const double limit = BenchProfile().Constraints().acceleration.value();
+
+  for (bool frictionCircle : {false, true}) {
+    Autopilot ap{APProfile(BenchProfile()).WithConstraints(
+        APConstraints(BenchProfile().Constraints())
+            .withFrictionCircle(frictionCircle))};
+    const double period = ap.Period().value();
+    double worst = 0.0;
+    size_t above = 0;
+    for (size_t i = 0; i < kInputs; ++i) {
+      const frc::Translation2d& v = inputs->velocities[i];
+      APResult out = ap.Calculate(inputs->poses[i], v, target);
+      const double accel = std::hypot(out.vx.value() - v.X().value(),
+                                      out.vy.value() - v.Y().value()) /
+                           period;
+      worst = std::max(worst, accel);
+      above += accel > limit * (1.0 + 1e-9) ? 1 : 0;
+    }
+    std::printf("%-16s max commanded accel %6.2f m/s^2, %zu/%zu calls above "
+                "%.1f m/s^2\n",
+                frictionCircle ? "friction circle:" : "along goal:", worst,
+                above, kInputs, limit);
+  }
+
+  Autopilot ap{APProfile(BenchProfile()).WithConstraints(
+      APConstraints(BenchProfile().Constraints()).withFrictionCircle())};
+  StaticAutopilot<kBenchStaticFrictionProfile> staticAp;
+  std::vector<double> x, y, heading, vx, vy;
+  APTargetBatch targets;
+  for (size_t i = 0; i < kInputs; ++i) {
+    x.push_back(inputs->poses[i].X().value());
+    y.push_back(inputs->poses[i].Y().value());
+    heading.push_back(inputs->poses[i].Rotation().Radians().value());
+    vx.push_back(inputs->velocities[i].X().value());
+    vy.push_back(inputs->velocities[i].Y().value());
+    targets.Add(target);
+  }
+  std::vector<APResult> batch(kInputs);
+  ap.Calculate(APStateBatch{x, y, heading, vx, vy, {}}, targets, batch);
+
+  double maxBatch = 0.0;
+  double maxStatic = 0.0;
+  for (size_t i = 0; i < kInputs; ++i) {
+    APResult expected =
+        ap.Calculate(inputs->poses[i], inputs->velocities[i], target);
+    APResult compiled =
+        staticAp.Calculate(inputs->poses[i], inputs->velocities[i], target);
+    maxBatch =
+        std::max({maxBatch, std::abs((batch[i].vx - expected.vx).value()),
+                  std::abs((batch[i].vy - expected.vy).value())});
+    maxStatic =
+        std::max({maxStatic, std::abs((compiled.vx - expected.vx).value()),
+                  std::abs((compiled.vy - expected.vy).value())});
+  }
+  std::printf("friction circle agreement: batch max |dv| %.3g m/s, static "
+              "max |dv| %.3g m/s\n",
+              maxBatch, maxStatic);
+}
+
+// Checks that commands respect the deceleration and robot relative axis
+// limits, and that the batched and compile time paths agree with the scalar
+// one when those limits are set
+void BrakingReport(const bench::Options&) {
+  auto inputs = MakeInputs(0.0, 6.0);
+  const APTarget target =
+      APTarget{frc::Pose2d{}}.WithEntryAngle(frc::Rotation2d{90_deg});
+  StaticAutopilot<kBenchStaticBrakingProfile> staticAp;
+  Autopilot ap{StaticAutopilot<kBenchStaticBrakingProfile>::Profile()};
+  const double period = ap.Period().value();
+
+  // Follow every command perfectly for a while. Once any velocity away from
+  // the target is braked off, commands stay within the axis limits.
+  constexpr int kTicks = 150;
+  constexpr int kSettleTicks = 50;
+  double maxForward = 0.0;
+  double maxSideways = 0.0;
+  for (size_t i = 0; i < kInputs; ++i) {
+    frc::Pose2d pose = inputs->poses[i];
+    frc::Translation2d v = inputs->velocities[i];
+    for (int tick = 0; tick < kTicks; ++tick) {
+      APResult out = ap.Calculate(pose, v, target);
+      v = frc::Translation2d{units::meter_t{out.vx.value()},
+                             units::meter_t{out.vy.value()}};
+      pose = frc::Pose2d{pose.Translation() + v * period, pose.Rotation()};
+      if (tick < kSettleTicks) {
+        continue;
+      }
+      const double c = pose.Rotation().Cos();
+      const double s = pose.Rotation().Sin();
+      maxForward = std::max(
+          maxForward, std::abs(out.vx.value() * c + out.vy.value() * s));
+      maxSideways = std::max(
+          maxSideways, std::abs(out.vy.value() * c - out.vx.value() * s));
+    }
+  }
+  std::printf("axis limits 3.0/1.5 m/s: max forward %.3f m/s, max sideways "
+              "%.3f m/s\n",
+              maxForward, maxSideways);
+
+  // With the friction circle, changes against the velocity may use the
+  // deceleration limit and all others the acceleration limit
+  APConstraints constraints = ap.Profile().Constraints();
+  Autopilot friction{APProfile(ap.Profile())
+                         .WithConstraints(constraints.withFrictionCircle())};
+  double maxSpeedUp = 0.0;
+  double maxBrake = 0.0;
+  for (size_t i = 0; i < kInputs; ++i) {
+    const frc::Translation2d& v = inputs->velocities[i];
+    APResult out = friction.Calculate(inputs->poses[i], v, target);
+    const double dx = out.vx.value() - v.X().value();
+    const double dy = out.vy.value() - v.Y().value();
+    const double accel = std::hypot(dx, dy) / period;
+    if (dx * v.X().value() + dy * v.Y().value() < 0.0) {
+      maxBrake = std::max(maxBrake, accel);
+    } else {
+      maxSpeedUp = std::max(maxSpeedUp, accel);
+    }
+  }
+  std::printf("friction circle: max accel %.2f m/s^2 (limit 3.0), max "
+              "braking %.2f m/s^2 (limit 8.0)\n",
+              maxSpeedUp, maxBrake);
+
+  std::vector<double> x, y, heading, vx, vy;
+  APTargetBatch targets;
+  for (size_t i = 0; i < kInputs; ++i) {
+    x.push_back(inputs->poses[i].X().value());
+    y.push_back(inputs->poses[i].Y().value());
+    heading.push_back(inputs->poses[i].Rotation().Radians().value());
+    vx.push_back(inputs->velocities[i].X().value());
+    vy.push_back(inputs->velocities[i].Y().value());
+    targets.Add(target);
+  }
+  std::vector<APResult> batch(kInputs);
+  ap.Calculate(APStateBatch{x, y, heading, vx, vy, {}}, targets, batch);
+  double maxBatch = 0.0;
+  double maxStatic = 0.0;
+  for (size_t i = 0; i < kInputs; ++i) {
+    APResult expected =
+        ap.Calculate(inputs->poses[i], inputs->velocities[i], target);
+    APResult compiled =
+        staticAp.Calculate(inputs->poses[i], inputs->velocities[i], target);
+    maxBatch =
+        std::max({maxBatch, std::abs((batch[i].vx - expected.vx).value()),
+                  std::abs((batch[i].vy - expected.vy).value())});
+    maxStatic =
+        std::max({maxStatic, std::abs((compiled.vx - expected.vx).value()),
+                  std::abs((compiled.vy - expected.vy).value())});
+  }
+  std::printf("braking agreement: batch max |dv| %.3g m/s, static max |dv| "
+              "%.3g m/s\n",
+              maxBatch, maxStatic);
+}
+
+// Streams a counter through a triple buffer and checks that the consumer
+// only ever sees whole values, in order, then runs an APRunner at 200 Hz
+// against a 50 Hz robot loop
+void RunnerReport(const bench::Options&) {
+  struct Value {
+    uint64_t a = 0;
+    uint64_t b = 0;
+  };
+  constexpr uint64_t kValues = 1000000;
+  APTripleBuffer<Value> buffer;
+  std::atomic<bool> done{false};
+  std::thread producer{[&] {
+    for (uint64_t i = 1; i <= kValues; ++i) {
+      buffer.Write(Value{i, ~i});
+      if (i % 64 == 0) {
+        std::this_thread::yield();
+      }
+    }
+    done.store(true, std::memory_order_release);
+  }};
+
+  uint64_t reads = 0;
+  uint64_t fresh = 0;
+  uint64_t torn = 0;
+  uint64_t reordered = 0;
+  uint64_t last = 0;
+  for (;;) {
+    const bool finished = done.load(std::memory_order_acquire);
+    bool published;
+    const Value& value = buffer.Read(&published);
+    ++reads;
+    fresh += published ? 1 : 0;
+    torn += value.b == ~value.a || value.a == 0 ? 0 : 1;
+    reordered += value.a < last ? 1 : 0;
+    last = value.a;
+    if (finished && !published) {
+      break;
+    }
+    std::this_thread::yield();
+  }
+  producer.join();
+  std::printf("triple buffer: %llu writes, %llu reads, %llu fresh, "
+              "%llu torn, %llu out of order, last %llu\n",
+              static_cast<unsigned long long>(kValues),
+              static_cast<unsigned long long>(reads),
+              static_cast<unsigned long long>(fresh),
+              static_cast<unsigned long long>(torn),
+              static_cast<unsigned long long>(reordered),
+              static_cast<unsigned long long>(last));
+
+  APRunner runner{Autopilot{BenchProfile()}, 5_ms};
+  runner.SetTarget(APTarget{frc::Pose2d{8_m, 4_m, frc::Rotation2d{}}});
+  runner.Start();
+  size_t valid = 0;
+  double maxAge = 0.0;
+  constexpr int kLoops = 100;
+  for (int i = 0; i < kLoops; ++i) {
+    const double now = wpi::Now() * 1e-6;
+    runner.SetState(
+        APTimestampedPose{frc::Pose2d{2_m, 2_m, frc::Rotation2d{}},
+                          units::second_t{now - 0.04}},
+        frc::ChassisSpeeds{});
+    const APRunnerOutput output = runner.Latest();
+    if (output.valid) {
+      ++valid;
+      maxAge = std::max(maxAge, now - output.timestamp.value());
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  runner.Stop();
+  const APRunnerStats stats = runner.Stats();
+  std::printf("runner: %llu ticks in %d robot loops, %zu valid reads, "
+              "oldest read %.2f ms\n",
+              static_cast<unsigned long long>(stats.ticks), kLoops, valid,
+              maxAge * 1e3);
+  std::printf("runner: %llu overruns, %llu late, tick mean %.1f us, "
+              "max %.1f us, max jitter %.2f ms\n",
+              static_cast<unsigned long long>(stats.overruns),
+              static_cast<unsigned long long>(stats.late),
+              stats.meanDuration.value() * 1e6,
+              stats.maxDuration.value() * 1e6, stats.maxJitter.value() * 1e3);
+}
+
+// Checks that the compile time autopilot agrees with the runtime one
+void StaticReport(const bench::Options& options) {
+  Autopilot ap{BenchProfile()};
+  StaticAutopilot<kBenchStaticProfile> staticAp;
+  auto inputs = MakeInputs(0.0, 6.0);
+  const APTarget targets[] = {
+      APTarget{frc::Pose2d{}},
+      APTarget{frc::Pose2d{}}.WithEntryAngle(frc::Rotation2d{90_deg}),
+      APTarget{frc::Pose2d{1_m, 2_m, frc::Rotation2d{30_deg}}}
+          .WithEntryAngle(frc::Rotation2d{-120_deg})
+          .WithVelocity(1_mps)
+          .WithRotationRadius(2_m)};
+
+  double maxVelocity = 0.0;
+  double maxHeading = 0.0;
+  for (const APTarget& target : targets) {
+    for (size_t i = 0; i < kInputs; ++i) {
+      APResult expected =
+          ap.Calculate(inputs->poses[i], inputs->velocities[i], target);
+      APResult actual =
+          staticAp.Calculate(inputs->poses[i], inputs->velocities[i], target);
+      maxVelocity = std::max(
+          {maxVelocity, std::abs((actual.vx - expected.vx).value()),
+           std::abs((actual.vy - expected.vy).value())});
+      maxHeading = std::max(
+          maxHeading,
+          std::abs((actual.targetAngle - expected.targetAngle)
+                       .Radians()
+                       .value()));
+    }
+  }
+
+  auto far = MakeInputs(1.0, 6.0);
+  APPreparedTarget prepared = ap.Prepare(targets[1]);
+  bench::Stats runtime = bench::Measure(
+      [&] {
+        size_t i = far->Next();
+        bench::DoNotOptimize(
+            ap.Calculate(far->poses[i], far->velocities[i], prepared));
+      },
+      options);
+  bench::Stats compiled = bench::Measure(
+      [&] {
+        size_t i = far->Next();
+        bench::DoNotOptimize(
+            staticAp.Calculate(far->poses[i], far->velocities[i], prepared));
+      },
+      options);
+
+  std::printf("%zu calls: max |dv| %.3g m/s, max |dtheta| %.3g rad\n",
+              std::size(targets) * kInputs, maxVelocity, maxHeading);
+  std::printf("swirly/prepared p50: runtime %.1f ns, static %.1f ns, "
+              "%.2fx\n",
+              runtime.p50, compiled.p50, runtime.p50 / compiled.p50);
+}
+}  // namespace
+
+// Follows every command perfectly towards targets rolling at up to 2 m/s,
+// once chasing where each target is and once intercepting it, and compares
+// how long each takes to come within 10 cm. Then times warm and cold
+// solves.
+void InterceptReport(const bench::Options& options) {
+  Autopilot ap{BenchProfile()};
+  const double period = ap.Period().value();
+  std::mt19937 rng{1690};
+  std::uniform_real_distribution<double> angle(-3.14159, 3.14159);
+  std::uniform_real_distribution<double> dist(2.0, 6.0);
+  std::uniform_real_distribution<double> speed(0.5, 2.0);
+
+  constexpr int kScenarios = 200;
+  constexpr int kTimeoutTicks = 1000;
+  constexpr double kCaptureRadius = 0.1;
+  std::vector<APMovingTarget> scenarios;
+  for (int i = 0; i < kScenarios; ++i) {
+    const frc::Rotation2d dir{units::radian_t{angle(rng)}};
+    const frc::Rotation2d heading{units::radian_t{angle(rng)}};
+    scenarios.emplace_back(
+        APTarget{frc::Pose2d{frc::Translation2d{units::meter_t{dist(rng)},
+                                                dir},
+                             heading}},
+        frc::Translation2d{units::meter_t{speed(rng)},
+                           frc::Rotation2d{units::radian_t{angle(rng)}}});
+  }
+
+  // Ticks until capture, or kTimeoutTicks
+  auto run = [&](const APMovingTarget& start, bool intercept,
+                 double& estimates) {
+    APInterceptor interceptor{ap};
+    frc::Pose2d pose;
+    frc::ChassisSpeeds v;
+    for (int tick = 0; tick < kTimeoutTicks; ++tick) {
+      const APMovingTarget target{
+          start.Target().WithReference(frc::Pose2d{
+              start.PositionAt(units::second_t{tick * period}),
+              start.Target().Reference().Rotation()}),
+          start.Velocity()};
+      if ((target.Target().Reference().Translation() - pose.Translation())
+              .Norm()
+              .value() < kCaptureRadius) {
+        return tick;
+      }
+      APResult out = intercept ? interceptor.Calculate(pose, v, target)
+                               : ap.Calculate(pose, v, target.Target());
+      if (intercept) {
+        estimates += interceptor.Last()->estimates;
+      }
+      v = frc::ChassisSpeeds{.vx = out.vx, .vy = out.vy};
+      pose = frc::Pose2d{
+          pose.Translation() +
+              frc::Translation2d{units::meter_t{out.vx.value() * period},
+                                 units::meter_t{out.vy.value() * period}},
+          pose.Rotation()};
+    }
+    return kTimeoutTicks;
+  };
+
+  struct Outcome {
+    int captured = 0;
+    double ticks = 0.0;
+  };
+  Outcome chase;
+  Outcome intercept;
+  double estimates = 0.0;
+  double interceptTicks = 0.0;
+  double unused = 0.0;
+  int faster = 0;
+  for (const APMovingTarget& scenario : scenarios) {
+    const int chaseTicks = run(scenario, false, unused);
+    const int ticks = run(scenario, true, estimates);
+    interceptTicks += ticks;
+    faster += ticks < chaseTicks ? 1 : 0;
+    for (auto [outcome, n] : {std::pair{&chase, chaseTicks},
+                              std::pair{&intercept, ticks}}) {
+      if (n < kTimeoutTicks) {
+        ++outcome->captured;
+        outcome->ticks += n;
+      }
+    }
+  }
+  for (auto [name, outcome] : {std::pair{"chase", chase},
+                               std::pair{"intercept", intercept}}) {
+    std::printf("%-9s captured %3d/%d within %.0f s, mean %.2f s\n", name,
+                outcome.captured, kScenarios, kTimeoutTicks * period,
+                outcome.captured > 0
+                    ? outcome.ticks * period / outcome.captured
+                    : 0.0);
+  }
+  std::printf("intercept faster in %d/%d, %.2f estimates per tick\n",
+              faster, kScenarios, estimates / interceptTicks);
+
+  // Each call moves the robot and target on by one tick, as in a control
+  // loop
+  auto time = [&](bool warm) {
+    APInterceptor interceptor{ap};
+    size_t i = 0;
+    int tick = 0;
+    return bench::Measure(
+        [&] {
+          if (++tick == 100) {
+            tick = 0;
+            i = (i + 1) % scenarios.size();
+          }
+          if (!warm) {
+            interceptor.Reset();
+          }
+          const APMovingTarget& start = scenarios[i];
+          const frc::Pose2d pose{
+              start.Target().Reference().Translation() * (tick / 150.0),
+              frc::Rotation2d{}};
+          bench::DoNotOptimize(interceptor.Solve(
+              pose, frc::Translation2d{}, start));
+        },
+        options);
+  };
+  const bench::Stats warm = time(true);
+  const bench::Stats cold = time(false);
+  std::printf("Solve p50: warm %.1f ns, cold %.1f ns\n", warm.p50,
+              cold.p50);
+}
+
+void RegisterAutopilotBenchmarks(bench::Suite& suite) {
+  auto ap = std::make_shared<Autopilot>(BenchProfile());
+  auto fastAp = std::make_shared<Autopilot>(BenchProfile());
+  fastAp->WithMathMode(APMathMode::kFast);
+  auto far = MakeInputs(1.0, 6.0);
+
+  APTarget plain{frc::Pose2d{}};
+  APTarget entry = plain.WithEntryAngle(frc::Rotation2d{90_deg});
+
+  suite.Add("Calculate/beeline", [ap, far, plain] {
+    size_t i = far->Next();
+    bench::DoNotOptimize(
+        ap->Calculate(far->poses[i], far->velocities[i], plain));
+  });
+
+  suite.Add("Calculate/swirly", [ap, far, entry] {
+    size_t i = far->Next();
+    bench::DoNotOptimize(
+        ap->Calculate(far->poses[i], far->velocities[i], entry));
+  });
+
+  suite.Add("Calculate/swirly/prepared",
+            [ap, far, prepared = ap->Prepare(entry)] {
+              size_t i = far->Next();
+              bench::DoNotOptimize(
+                  ap->Calculate(far->poses[i], far->velocities[i], prepared));
+            });
+
+  suite.Add("Calculate/swirly/fast", [fastAp, far, entry] {
+    size_t i = far->Next();
+    bench::DoNotOptimize(
+        fastAp->Calculate(far->poses[i], far->velocities[i], entry));
+  });
+
+  // Baked once into a temporary file, then mapped back in
+  auto bakedAp = std::make_shared<Autopilot>(BenchProfile());
+  auto field = std::make_shared<std::optional<APVelocityField>>();
+  const std::string fieldPath =
+      (std::filesystem::temp_directory_path() / "autopilot_bench_field.bin")
+          .string();
+  const APTarget baked[] = {entry};
+  if (APVelocityField::Bake(*bakedAp, baked, 8_m, units::meter_t{0.1},
+                            fieldPath)) {
+    *field = APVelocityField::Load(fieldPath);
+  }
+  if (*field) {
+    bakedAp->WithVelocityField(&**field);
+    suite.Add("Calculate/swirly/baked",
+              [bakedAp, field, far, prepared = bakedAp->Prepare(entry)] {
+                size_t i = far->Next();
+                bench::DoNotOptimize(bakedAp->Calculate(
+                    far->poses[i], far->velocities[i], prepared));
+              });
+  }
+
+  auto rotatingAp = std::make_shared<Autopilot>(
+      APProfile(BenchProfile())
+          .WithConstraints(
+              APConstraints(4.5_mps, 3.0_mps_sq, 2.0)
+                  .withRotationVelocity(units::radians_per_second_t{6.0})
+                  .withRotationAcceleration(
+                      units::radians_per_second_squared_t{12.0})
+                  .withRotationJerk(40.0)));
+  suite.Add("Calculate/swirly/rotation", [rotatingAp, far, entry] {
+    size_t i = far->Next();
+    bench::DoNotOptimize(
+        rotatingAp->Calculate(far->poses[i], far->velocities[i], entry));
+  });
+
+  auto staticAp = std::make_shared<StaticAutopilot<kBenchStaticProfile>>();
+  suite.Add("StaticAutopilot/beeline", [staticAp, far, plain] {
+    size_t i = far->Next();
+    bench::DoNotOptimize(
+        staticAp->Calculate(far->poses[i], far->velocities[i], plain));
+  });
+
+  suite.Add("StaticAutopilot/swirly/prepared",
+            [staticAp, far, prepared = staticAp->Prepare(entry)] {
+              size_t i = far->Next();
+              bench::DoNotOptimize(staticAp->Calculate(
+                  far->poses[i], far->velocities[i], prepared));
+            });
+
+  auto staticFastAp =
+      std::make_shared<StaticAutopilot<kBenchStaticFastProfile>>();
+  suite.Add("StaticAutopilot/swirly/fast",
+            [staticFastAp, far, prepared = staticFastAp->Prepare(entry)] {
+              size_t i = far->Next();
+              bench::DoNotOptimize(staticFastAp->Calculate(
+                  far->poses[i], far->velocities[i], prepared));
+            });
+
+  // Drained on the same thread, so the ring never fills
+  auto recordedAp = std::make_shared<Autopilot>(BenchProfile());
+  auto ring = std::make_shared<APTelemetryRing>(1024);
+  recordedAp->WithTelemetry(ring.get());
+  suite.Add("Calculate/swirly/telemetry", [recordedAp, ring, far, entry] {
+    size_t i = far->Next();
+    bench::DoNotOptimize(
+        recordedAp->Calculate(far->poses[i], far->velocities[i], entry));
+    APRecord record;
+    ring->TryPop(record);
+  });
+
+  suite.Add("Calculate/zero-offset", [ap, far, entry] {
+    size_t i = far->Next();
+    bench::DoNotOptimize(ap->Calculate(frc::Pose2d{}, far->velocities[i],
+                                       entry));
+  });
+
+  // Half the poses fall inside the 2 cm tolerance
+  auto near = MakeInputs(0.0, 0.04);
+  suite.Add("AtTarget", [ap, near, entry] {
+    size_t i = near->Next();
+    bench::DoNotOptimize(ap->AtTarget(near->poses[i], entry));
+  });
+
+  suite.Add("CalculateSwirlyLength", [ap, far] {
+    size_t i = far->Next();
+    bench::DoNotOptimize(APBenchAccess::SwirlyLength(
+        *ap, units::radian_t{far->values[i]},
+        far->poses[i].Translation().Norm()));
+  });
+
+  suite.Add("CalculateMaxVelocity", [ap, far] {
+    size_t i = far->Next();
+    bench::DoNotOptimize(APBenchAccess::MaxVelocity(
+        *ap, far->poses[i].Translation().Norm(), 0_mps));
+  });
+
+  suite.Add("CalculateSwirlyLength/fast", [fastAp, far] {
+    size_t i = far->Next();
+    bench::DoNotOptimize(APBenchAccess::SwirlyLength(
+        *fastAp, units::radian_t{far->values[i]},
+        far->poses[i].Translation().Norm()));
+  });
+
+  suite.Add("CalculateMaxVelocity/fast", [fastAp, far] {
+    size_t i = far->Next();
+    bench::DoNotOptimize(APBenchAccess::MaxVelocity(
+        *fastAp, far->poses[i].Translation().Norm(), 0_mps));
+  });
+
+  suite.Add("EstimateTimeToTarget", [ap, far, entry] {
+    size_t i = far->Next();
+    bench::DoNotOptimize(
+        ap->EstimateTimeToTarget(far->poses[i], far->velocities[i], entry));
+  });
+
+  // A 3-6 m drive to an entry angle, about 150 steps at 20 ms
+  auto engine = std::make_shared<APRolloutEngine>(*ap);
+  auto path = std::make_shared<std::vector<APRolloutSample>>(1024);
+  auto rollouts = MakeInputs(3.0, 6.0);
+  suite.Add("Rollout/20ms", [engine, path, rollouts, entry] {
+    size_t i = rollouts->Next();
+    bench::DoNotOptimize(engine->Run(rollouts->poses[i],
+                                     rollouts->velocities[i], entry, *path));
+  });
+
+  auto coarse = std::make_shared<APRolloutEngine>(
+      *ap, APRolloutOptions{.step = 100_ms, .sampleEvery = 2});
+  suite.Add("Rollout/100ms", [coarse, path, rollouts, entry] {
+    size_t i = rollouts->Next();
+    bench::DoNotOptimize(coarse->Run(rollouts->poses[i],
+                                     rollouts->velocities[i], entry, *path));
+  });
+
+  for (size_t count : {12, 1000}) {
+    auto targets =
+        std::make_shared<std::vector<APTarget>>(MakeCandidates(count));
+    auto set = std::make_shared<APTargetSet>(*ap, *targets);
+    std::string suffix = "/" + std::to_string(count);
+    suite.Add("APTargetSet::Best" + suffix, [set, far] {
+      size_t i = far->Next();
+      bench::DoNotOptimize(set->Best(far->poses[i], far->velocities[i]));
+    });
+    suite.Add("BruteForceBest" + suffix, [ap, targets, far] {
+      size_t i = far->Next();
+      bench::DoNotOptimize(
+          BruteForceBest(*ap, *targets, far->poses[i], far->velocities[i]));
+    });
+  }
+
+  suite.AddReport("fastmath accuracy vs speed", FastMathReport);
+  suite.AddReport("eta vs rollout", EtaReport);
+  suite.AddReport("target set vs brute force", TargetSetReport);
+  suite.AddReport("telemetry ring", TelemetryReport);
+  suite.AddReport("static vs runtime", StaticReport);
+  suite.AddReport("async runner", RunnerReport);
+  suite.AddReport("friction circle", FrictionCircleReport);
+  suite.AddReport("braking limits", BrakingReport);
+  suite.AddReport("intercept vs chase", InterceptReport);
+}
@@ -0,0 +1,137 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include "bench.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+using namespace bench;
+
+InstructionCounter::InstructionCounter() {
+#ifdef __linux__
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+}
+
+InstructionCounter::~InstructionCounter() {
+#ifdef __linux__
+  if (m_fd >= 0) {
+    close(m_fd);
+  }
+#endif
+}
+
+void InstructionCounter::Start() {
+#ifdef __linux__
+  ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+  ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+uint64_t InstructionCounter::Stop() {
+  uint64_t count = 0;
+#ifdef __linux__
+  ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+  if (read(m_fd, &count, sizeof(count)) != sizeof(count)) {
+    count = 0;
+  }
+#endif
+  return count;
+}
+
+double bench::ClockOverhead() {
+  using Clock = std::chrono::steady_clock;
+  static const double overhead = [] {
+    std::vector<double> samples(10000);
+    for (double& sample : samples) {
+      auto start = Clock::now();
+      auto end = Clock::now();
+      sample = std::chrono::duration<double, std::nano>(end - start).count();
+    }
+    std::nth_element(samples.begin(), samples.begin() + samples.size() / 2,
+                     samples.end());
+    return samples[samples.size() / 2];
+  }();
+  return overhead;
+}
+
+Stats bench::Summarize(std::vector<double>& bursts,
+                       std::vector<double>& singles, double overhead,
+                       std::optional<double> instructions) {
+  if (bursts.empty() || singles.empty()) {
+    return Stats{0, 0, 0, 0, instructions};
+  }
+  auto percentile = [](const std::vector<double>& sorted, double p) {
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1));
+    return sorted[index];
+  };
+  std::sort(bursts.begin(), bursts.end());
+  double mean = std::accumulate(bursts.begin(), bursts.end(), 0.0) /
+                static_cast<double>(bursts.size());
+
+  for (double& sample : singles) {
+    sample = std::max(sample - overhead, 0.0);
+  }
+  std::sort(singles.begin(), singles.end());
+  return Stats{mean, percentile(bursts, 0.50), percentile(singles, 0.99),
+               singles.back(), instructions};
+}
+
+void Suite::AddReport(std::string name,
+                      std::function<void(const Options&)> fn) {
+  m_reports.push_back(Report{std::move(name), std::move(fn)});
+}
+
+void Suite::Run(std::string_view filter, const Options& options) const {
+  auto matches = [&](const std::string& name) {
+    return filter.empty() || name.find(filter) != std::string::npos;
+  };
+
+  std::printf("%-40s %10s %10s %10s %10s %12s\n", "case", "ns/call", "p50",
+              "p99", "max", "instr/call");
+  for (const Case& c : m_cases) {
+    if (!matches(c.name)) {
+      continue;
+    }
+    Stats stats = c.measure(options);
+    std::printf("%-40s %10.1f %10.1f %10.1f %10.1f ", c.name.c_str(),
+                stats.mean, stats.p50, stats.p99, stats.max);
+    if (stats.instructions) {
+      std::printf("%12.1f\n", *stats.instructions);
+    } else {
+      std::printf("%12s\n", "n/a");
+    }
+  }
+
+  for (const Report& r : m_reports) {
+    if (!matches(r.name)) {
+      continue;
+    }
+    std::printf("\n== %s ==\n", r.name.c_str());
+    r.fn(options);
+  }
+}
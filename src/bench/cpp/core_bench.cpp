@@ -0,0 +1,395 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include "core_bench.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <numbers>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "autopilot/core.h"
+#include "autopilot/scalar.h"
+
+using namespace autopilot;
+
+namespace {
+// Inputs are cycled so that every call sees fresh data, but the set is small
+// enough to stay in L1.
+constexpr size_t kInputs = 256;
+
+struct Inputs {
+  std::vector<core::Pose> poses;
+  std::vector<core::Velocity> velocities;
+  size_t next = 0;
+
+  size_t Next() {
+    next = (next + 1) % kInputs;
+    return next;
+  }
+};
+
+// The same profile as the Autopilot cases
+constexpr core::Profile kBenchProfile{
+    .velocity = 4.5,
+    .acceleration = 3.0,
+    .jerk = 2.0,
+    .errorXY = 0.02,
+    .errorTheta = 2.0 * std::numbers::pi / 180.0,
+    .beelineRadius = 0.08};
+
+core::Rotation FromAngle(double angle) {
+  return core::Rotation{std::cos(angle), std::sin(angle)};
+}
+
+// Poses spread minDist-maxDist m around the origin, with random headings and
+// velocities
+std::shared_ptr<Inputs> MakeInputs(double minDist, double maxDist) {
+  std::mt19937 rng{5805};
+  std::uniform_real_distribution<double> angle(-3.14159, 3.14159);
+  std::uniform_real_distribution<double> dist(minDist, maxDist);
+  std::uniform_real_distribution<double> speed(-2.0, 2.0);
+
+  auto inputs = std::make_shared<Inputs>();
+  for (size_t i = 0; i < kInputs; ++i) {
+    const core::Rotation dir = FromAngle(angle(rng));
+    const double d = dist(rng);
+    inputs->poses.push_back(
+        core::Pose{d * dir.cos, d * dir.sin, FromAngle(angle(rng))});
+    inputs->velocities.push_back(
+        core::Velocity{speed(rng), speed(rng), speed(rng)});
+  }
+  return inputs;
+}
+
+// The kernels the scalar types report compares
+enum class Kernel { kPush, kCorrect, kSwirlyLength, kCalculate };
+
+// Arguments for every kernel, converted to T up front so that the timings
+// leave the conversions out
+template <typename T>
+struct ScalarCase {
+  core::BasicLimits<T> limits;
+  core::BasicTarget<T> target;
+  T dt{};
+  std::vector<core::BasicPose<T>> poses;
+  std::vector<core::BasicVelocity<T>> velocities;
+  std::vector<core::BasicVector<T>> goals;
+  std::vector<T> angles;
+  std::vector<T> steps;
+};
+
+template <typename T>
+ScalarCase<T> MakeScalarCase(const core::Profile& profile,
+                             const core::Target& target) {
+  std::mt19937 rng{254};
+  std::uniform_real_distribution<double> angle(-3.14159, 3.14159);
+  std::uniform_real_distribution<double> dist(0.1, 6.0);
+  std::uniform_real_distribution<double> speed(-4.0, 4.0);
+  std::uniform_real_distribution<double> step(0.0, 0.2);
+
+  ScalarCase<T> c;
+  c.limits = core::Fold<T>(profile);
+  c.target = core::Cast<T>(target);
+  c.dt = core::detail::Narrow<T>(profile.period);
+  for (size_t i = 0; i < kInputs; ++i) {
+    const core::Rotation dir = FromAngle(angle(rng));
+    const double d = dist(rng);
+    c.poses.push_back(core::Cast<T>(
+        core::Pose{d * dir.cos, d * dir.sin, FromAngle(angle(rng))}));
+    c.velocities.push_back(core::Cast<T>(
+        core::Velocity{speed(rng), speed(rng), speed(rng)}));
+    c.goals.push_back(core::Cast<T>(core::Vector{speed(rng), speed(rng)}));
+    c.angles.push_back(core::detail::Narrow<T>(angle(rng)));
+    c.steps.push_back(core::detail::Narrow<T>(step(rng)));
+  }
+  return c;
+}
+
+template <Kernel K, typename T>
+auto Apply(const ScalarCase<T>& c, size_t i) {
+  const size_t j = (i + 1) % kInputs;
+  if constexpr (K == Kernel::kPush) {
+    return core::Push(c.velocities[i].vx, c.goals[i].x, c.steps[i],
+                      c.steps[j]);
+  } else if constexpr (K == Kernel::kCorrect) {
+    return core::Correct(
+        c.limits,
+        core::BasicVector<T>{c.velocities[i].vx, c.velocities[i].vy},
+        c.goals[i], c.poses[i].rotation, c.dt);
+  } else if constexpr (K == Kernel::kSwirlyLength) {
+    return core::SwirlyLength(c.limits, c.angles[i], c.poses[i].x);
+  } else {
+    return core::Calculate(c.limits, c.poses[i], c.velocities[i], c.target,
+                           c.dt);
+  }
+}
+
+// Every output as doubles: a scalar, a vector or a velocity and omega
+template <typename T>
+std::array<double, 3> ToDoubles(T value) {
+  return {static_cast<double>(value), 0.0, 0.0};
+}
+
+template <typename T>
+std::array<double, 3> ToDoubles(const core::BasicVector<T>& v) {
+  return {static_cast<double>(v.x), static_cast<double>(v.y), 0.0};
+}
+
+template <typename T>
+std::array<double, 3> ToDoubles(const core::BasicResult<T>& result) {
+  return {static_cast<double>(result.vx), static_cast<double>(result.vy),
+          static_cast<double>(result.omega)};
+}
+
+// Absolute errors against double: of the first two outputs as a vector and
+// of the third on its own
+struct AbsoluteError {
+  double max = 0.0;
+  double sum = 0.0;
+  double maxOmega = 0.0;
+  double sumOmega = 0.0;
+  size_t count = 0;
+
+  void Add(const std::array<double, 3>& exact,
+           const std::array<double, 3>& approx) {
+    const double error =
+        std::hypot(approx[0] - exact[0], approx[1] - exact[1]);
+    const double omega = std::abs(approx[2] - exact[2]);
+    max = std::max(max, error);
+    sum += error;
+    maxOmega = std::max(maxOmega, omega);
+    sumOmega += omega;
+    ++count;
+  }
+};
+
+template <Kernel K, typename T>
+AbsoluteError CompareToDouble(const ScalarCase<double>& exact,
+                              const ScalarCase<T>& c) {
+  AbsoluteError error;
+  for (size_t i = 0; i < kInputs; ++i) {
+    error.Add(ToDoubles(Apply<K>(exact, i)), ToDoubles(Apply<K>(c, i)));
+  }
+  return error;
+}
+
+template <Kernel K, typename T>
+bench::Stats TimeKernel(const ScalarCase<T>& c,
+                        const bench::Options& options) {
+  size_t i = 0;
+  return bench::Measure(
+      [&c, &i] {
+        i = (i + 1) % kInputs;
+        bench::DoNotOptimize(Apply<K>(c, i));
+      },
+      options);
+}
+
+template <Kernel K>
+void PrintScalarRow(const char* name, const ScalarCase<double>& exact,
+                    const ScalarCase<float>& single,
+                    const ScalarCase<core::Fixed>& fixed,
+                    const bench::Options& options) {
+  const AbsoluteError floatError = CompareToDouble<K>(exact, single);
+  const AbsoluteError fixedError = CompareToDouble<K>(exact, fixed);
+  std::printf("%-20s %10.3g %10.3g %10.3g %10.3g %8.1f %8.1f %8.1f\n", name,
+              floatError.max, floatError.sum / floatError.count,
+              fixedError.max, fixedError.sum / fixedError.count,
+              TimeKernel<K>(exact, options).p50,
+              TimeKernel<K>(single, options).p50,
+              TimeKernel<K>(fixed, options).p50);
+  if constexpr (K == Kernel::kCalculate) {
+    std::printf("%-20s %10.3g %10.3g %10.3g %10.3g\n", "  omega (rad/s)",
+                floatError.maxOmega, floatError.sumOmega / floatError.count,
+                fixedError.maxOmega, fixedError.sumOmega / fixedError.count);
+  }
+}
+
+// The inputs of a ScalarCase as lanes for core::CalculateBatch, all
+// driving towards its one target
+template <typename T>
+struct BlockCase {
+  std::vector<T> x, y, cos, sin, vx, vy, omega;
+  std::vector<T> targetX, targetY, targetCos, targetSin, velocity, entryCos,
+      entrySin, beelineRadiusSq, rotationRadiusSq;
+  std::vector<T> outVx, outVy, outOmega;
+  std::vector<uint8_t> facesTarget;
+
+  core::BasicStateLanes<T> States() const {
+    return {x, y, cos, sin, vx, vy, omega};
+  }
+  core::BasicTargetLanes<T> Targets() const {
+    return {targetX,  targetY,  targetCos,       targetSin,       velocity,
+            entryCos, entrySin, beelineRadiusSq, rotationRadiusSq};
+  }
+  core::BasicResultLanes<T> Results() {
+    return {outVx, outVy, outOmega, facesTarget};
+  }
+};
+
+template <typename T>
+BlockCase<T> MakeBlockCase(const ScalarCase<T>& c) {
+  BlockCase<T> b;
+  for (size_t i = 0; i < kInputs; ++i) {
+    b.x.push_back(c.poses[i].x);
+    b.y.push_back(c.poses[i].y);
+    b.cos.push_back(c.poses[i].rotation.cos);
+    b.sin.push_back(c.poses[i].rotation.sin);
+    b.vx.push_back(c.velocities[i].vx);
+    b.vy.push_back(c.velocities[i].vy);
+    b.omega.push_back(c.velocities[i].omega);
+    b.targetX.push_back(c.target.reference.x);
+    b.targetY.push_back(c.target.reference.y);
+    b.targetCos.push_back(c.target.reference.rotation.cos);
+    b.targetSin.push_back(c.target.reference.rotation.sin);
+    b.velocity.push_back(c.target.velocity);
+    b.entryCos.push_back(c.target.entryCos);
+    b.entrySin.push_back(c.target.entrySin);
+    b.beelineRadiusSq.push_back(c.target.beelineRadiusSq);
+    b.rotationRadiusSq.push_back(c.target.rotationRadiusSq);
+  }
+  b.outVx.resize(kInputs);
+  b.outVy.resize(kInputs);
+  b.outOmega.resize(kInputs);
+  b.facesTarget.resize(kInputs);
+  return b;
+}
+
+// Runs core::CalculateBatch over every input and returns the median time
+// per lane, along with the largest difference from core::Calculate in the
+// same type
+template <typename T>
+std::pair<double, double> TimeBlock(const ScalarCase<T>& c,
+                                    const bench::Options& options) {
+  BlockCase<T> b = MakeBlockCase(c);
+  auto run = [&c, &b] {
+    core::CalculateBatch(c.limits, b.States(), b.Targets(), b.Results(),
+                         kInputs, c.dt);
+    bench::DoNotOptimize(b.outVx.data());
+  };
+  run();
+  double difference = 0.0;
+  for (size_t i = 0; i < kInputs; ++i) {
+    const auto scalar = ToDoubles(Apply<Kernel::kCalculate>(c, i));
+    difference = std::max(
+        {difference, std::abs(static_cast<double>(b.outVx[i]) - scalar[0]),
+         std::abs(static_cast<double>(b.outVy[i]) - scalar[1]),
+         std::abs(static_cast<double>(b.outOmega[i]) - scalar[2])});
+  }
+  const bench::Stats stats = bench::Measure(run, options);
+  return {stats.p50 / static_cast<double>(kInputs), difference};
+}
+
+template <typename T>
+void PrintBlockRow(const char* name, const ScalarCase<T>& c,
+                   const bench::Options& options) {
+  const auto [block, difference] = TimeBlock(c, options);
+  std::printf("%-20s %10.1f %10.1f %12.3g\n", name,
+              TimeKernel<Kernel::kCalculate>(c, options).p50, block,
+              difference);
+}
+
+// Runs the kernels in float and Q16.16 over the same random inputs as in
+// double, and reports their absolute errors and timings. Vector outputs
+// report the length of the error vector. Then times core::CalculateBatch per
+// lane in each type against one Calculate call per lane.
+void ScalarReport(const bench::Options& options) {
+  core::Profile profile = kBenchProfile;
+  profile.rotationVelocity = 6.0;
+  profile.rotationAcceleration = 12.0;
+  profile.rotationJerk = 30.0;
+  const core::Target target = core::Prepare(
+      profile, core::Pose{.rotation = FromAngle(0.4)}, 0.0, FromAngle(0.7),
+      std::nullopt);
+
+  const auto exact = MakeScalarCase<double>(profile, target);
+  const auto single = MakeScalarCase<float>(profile, target);
+  const auto fixed = MakeScalarCase<core::Fixed>(profile, target);
+
+  std::printf("%-20s %10s %10s %10s %10s %8s %8s %8s\n", "kernel",
+              "float max", "float mean", "Q16 max", "Q16 mean", "f64 p50",
+              "f32 p50", "Q16 p50");
+  PrintScalarRow<Kernel::kPush>("Push", exact, single, fixed, options);
+  PrintScalarRow<Kernel::kCorrect>("Correct", exact, single, fixed, options);
+  PrintScalarRow<Kernel::kSwirlyLength>("CalculateSwirlyLength", exact,
+                                        single, fixed, options);
+  PrintScalarRow<Kernel::kCalculate>("Calculate (m/s)", exact, single, fixed,
+                                     options);
+
+  // The block kernel against one Calculate per lane, in ns per lane
+  std::printf("\n%-20s %10s %10s %12s\n", "type", "lane p50", "block p50",
+              "max |diff|");
+  PrintBlockRow("double", exact, options);
+  PrintBlockRow("float", single, options);
+  PrintBlockRow("Q16.16", fixed, options);
+}
+}  // namespace
+
+void RegisterCoreBenchmarks(bench::Suite& suite) {
+  const core::Limits limits = core::Fold(kBenchProfile);
+  core::Profile fastProfile = kBenchProfile;
+  fastProfile.mathMode = APMathMode::kFast;
+  const core::Limits fast = core::Fold(fastProfile);
+  core::Profile rotationProfile = kBenchProfile;
+  rotationProfile.rotationVelocity = 6.0;
+  rotationProfile.rotationAcceleration = 12.0;
+  rotationProfile.rotationJerk = 30.0;
+  const core::Limits rotating = core::Fold(rotationProfile);
+
+  auto far = MakeInputs(1.0, 6.0);
+  const core::Pose reference{.rotation = FromAngle(0.4)};
+  const core::Target plain =
+      core::Prepare(kBenchProfile, reference, 0.0, std::nullopt, std::nullopt);
+  const core::Target entry = core::Prepare(kBenchProfile, reference, 0.0,
+                                           FromAngle(0.7), std::nullopt);
+
+  suite.Add("core/Calculate/beeline", [limits, far, plain] {
+    size_t i = far->Next();
+    bench::DoNotOptimize(core::Calculate(limits, far->poses[i],
+                                         far->velocities[i], plain,
+                                         kBenchProfile.period));
+  });
+
+  suite.Add("core/Calculate/swirly", [limits, far, entry] {
+    size_t i = far->Next();
+    bench::DoNotOptimize(core::Calculate(limits, far->poses[i],
+                                         far->velocities[i], entry,
+                                         kBenchProfile.period));
+  });
+
+  suite.Add("core/Calculate/swirly/fast", [fast, far, entry] {
+    size_t i = far->Next();
+    bench::DoNotOptimize(core::Calculate(fast, far->poses[i],
+                                         far->velocities[i], entry,
+                                         kBenchProfile.period));
+  });
+
+  suite.Add("core/Calculate/swirly/rotation", [rotating, far, entry] {
+    size_t i = far->Next();
+    bench::DoNotOptimize(core::Calculate(rotating, far->poses[i],
+                                         far->velocities[i], entry,
+                                         kBenchProfile.period));
+  });
+
+  // Half the poses fall inside the 2 cm tolerance
+  auto near = MakeInputs(0.0, 0.04);
+  suite.Add("core/AtTarget", [near, reference] {
+    size_t i = near->Next();
+    bench::DoNotOptimize(
+        core::AtTarget(kBenchProfile, near->poses[i], reference));
+  });
+
+  suite.AddReport("scalar types", ScalarReport);
+}
@@ -0,0 +1,44 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include <cstdlib>
+#include <string_view>
+
+#include "bench.h"
+#include "core_bench.h"
+
+#ifndef AUTOPILOT_CORE_ONLY
+#include "autopilot_bench.h"
+#endif
+
+/**
+ * Usage: frcUserProgramBench [filter] [samples]
+ *
+ * Runs every case whose name contains the filter and prints ns/call,
+ * p50/p99/max and instructions per call. The mean and p50 are averages over
+ * short bursts of calls; p99 and max are of single calls, less the clock's
+ * overhead.
+ *
+ * Built with AUTOPILOT_CORE_ONLY defined, only the core cases are included,
+ * so the binary needs nothing but bench.cpp and core_bench.cpp.
+ */
+int main(int argc, char** argv) {
+  std::string_view filter = argc > 1 ? argv[1] : "";
+  bench::Options options;
+  if (argc > 2) {
+    options.samples = std::strtoul(argv[2], nullptr, 10);
+  }
+
+  bench::Suite suite;
+#ifndef AUTOPILOT_CORE_ONLY
+  RegisterAutopilotBenchmarks(suite);
+#endif
+  RegisterCoreBenchmarks(suite);
+  suite.Run(filter, options);
+  return 0;
+}
@@ -0,0 +1,17 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include "bench.h"
+
+/**
+ * Registers the Autopilot hot path cases: Calculate in each of its branches,
+ * AtTarget, CalculateSwirlyLength and CalculateMaxVelocity.
+ */
+void RegisterAutopilotBenchmarks(bench::Suite& suite);
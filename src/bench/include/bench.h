@@ -0,0 +1,202 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace bench {
+/**
+ * Prevents the compiler from optimizing away the computation of a value.
+ */
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const T* sink;
+  sink = &value;
+#endif
+}
+
+/**
+ * Counts user space instructions retired by the calling thread.
+ *
+ * Uses perf_event_open on Linux. On other platforms, or when the kernel
+ * refuses access to the counter, Available() returns false.
+ */
+class InstructionCounter {
+ public:
+  InstructionCounter();
+  ~InstructionCounter();
+
+  InstructionCounter(const InstructionCounter&) = delete;
+  InstructionCounter& operator=(const InstructionCounter&) = delete;
+
+  /**
+   * Returns whether the hardware counter could be opened.
+   */
+  bool Available() const { return m_fd >= 0; }
+
+  /**
+   * Resets and starts the counter.
+   */
+  void Start();
+
+  /**
+   * Stops the counter and returns the instructions retired since Start().
+   */
+  uint64_t Stop();
+
+ private:
+  int m_fd = -1;
+};
+
+/**
+ * Timing results for a single benchmark case, in nanoseconds per call.
+ *
+ * The mean and median are per-call averages over bursts of calls, which the
+ * clock resolves well. The 99th percentile and maximum are of single calls,
+ * less the clock's own overhead, so that one slow call is not averaged away
+ * by the fast calls around it.
+ */
+struct Stats {
+  double mean;
+  double p50;
+  double p99;
+  double max;
+  std::optional<double> instructions;
+};
+
+/**
+ * Options shared by every case in a run.
+ */
+struct Options {
+  // Number of timed samples per case, of bursts and of single calls each
+  size_t samples = 20000;
+  // Calls per burst sample. Individual calls are close to the clock's
+  // resolution, so the mean and median come from bursts, each reporting the
+  // per-call average.
+  size_t callsPerSample = 16;
+  // Untimed calls made before sampling, to warm caches and predictors
+  size_t warmup = 10000;
+};
+
+/**
+ * Returns the median time, in nanoseconds, between two back to back reads
+ * of the steady clock. Measured once and then reused.
+ */
+double ClockOverhead();
+
+/**
+ * Summarizes per-call burst averages, single call times that still include
+ * the clock overhead, and an optional instruction count.
+ */
+Stats Summarize(std::vector<double>& bursts, std::vector<double>& singles,
+                double overhead, std::optional<double> instructions);
+
+/**
+ * Times a callable and returns its per-call statistics.
+ *
+ * The callable is inlined into the timing loop, so no indirect call overhead
+ * is included in the results.
+ */
+template <typename F>
+Stats Measure(F&& fn, const Options& options) {
+  using Clock = std::chrono::steady_clock;
+
+  for (size_t i = 0; i < options.warmup; ++i) {
+    fn();
+  }
+
+  std::vector<double> bursts(options.samples);
+  for (double& sample : bursts) {
+    auto start = Clock::now();
+    for (size_t i = 0; i < options.callsPerSample; ++i) {
+      fn();
+    }
+    auto end = Clock::now();
+    sample = std::chrono::duration<double, std::nano>(end - start).count() /
+             static_cast<double>(options.callsPerSample);
+  }
+
+  std::vector<double> singles(options.samples);
+  for (double& sample : singles) {
+    auto start = Clock::now();
+    fn();
+    auto end = Clock::now();
+    sample = std::chrono::duration<double, std::nano>(end - start).count();
+  }
+
+  // Counted separately so the clock reads are not part of the count
+  std::optional<double> instructions;
+  InstructionCounter counter;
+  if (counter.Available()) {
+    const size_t calls = options.samples * options.callsPerSample;
+    counter.Start();
+    for (size_t i = 0; i < calls; ++i) {
+      fn();
+    }
+    instructions =
+        static_cast<double>(counter.Stop()) / static_cast<double>(calls);
+  }
+
+  return Summarize(bursts, singles, ClockOverhead(), instructions);
+}
+
+/**
+ * A named collection of timed cases and untimed reports.
+ *
+ * Cases are timed with Measure and printed as one table. Reports are free
+ * form and print whatever they need, such as accuracy sweeps.
+ */
+class Suite {
+ public:
+  /**
+   * Adds a timed case. The callable is invoked once per measured call.
+   */
+  template <typename F>
+  void Add(std::string name, F fn) {
+    m_cases.push_back(
+        Case{std::move(name),
+             [fn](const Options& options) { return Measure(fn, options); }});
+  }
+
+  /**
+   * Adds an untimed report that runs after all cases.
+   */
+  void AddReport(std::string name, std::function<void(const Options&)> fn);
+
+  /**
+   * Runs every case and report whose name contains the filter, and prints
+   * the results to stdout.
+   */
+  void Run(std::string_view filter, const Options& options) const;
+
+ private:
+  struct Case {
+    std::string name;
+    std::function<Stats(const Options&)> measure;
+  };
+  struct Report {
+    std::string name;
+    std::function<void(const Options&)> fn;
+  };
+
+  std::vector<Case> m_cases;
+  std::vector<Report> m_reports;
+};
+}  // namespace bench
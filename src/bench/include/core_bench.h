@@ -0,0 +1,17 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include "bench.h"
+
+/**
+ * Registers the core control law cases, which call autopilot::core directly
+ * on plain doubles. They need nothing from WPILib.
+ */
+void RegisterCoreBenchmarks(bench::Suite& suite);
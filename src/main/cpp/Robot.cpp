@@ -70,12 +70,16 @@ void Robot::TestPeriodic() {}
 /**
  * This function is called once when the robot is first started up.
  */
-void Robot::SimulationInit() {}
+void Robot::SimulationInit() {
+  m_container.SimulationInit();
+}
 
 /**
  * This function is called periodically whilst in simulation.
  */
-void Robot::SimulationPeriodic() {}
+void Robot::SimulationPeriodic() {
+  m_container.SimulationPeriodic(GetPeriod());
+}
 
 #ifndef RUNNING_FRC_TESTS
 int main() {
@@ -8,13 +8,41 @@
 
 #include "RobotContainer.h"
 
+#include <frc/Filesystem.h>
+#include <frc/RobotBase.h>
+#include <frc/Timer.h>
+#include <frc/kinematics/ChassisSpeeds.h>
+#include <frc/smartdashboard/SmartDashboard.h>
+#include <frc2/command/FunctionalCommand.h>
 #include <frc2/command/button/Trigger.h>
 
 #include "commands/Autos.h"
 #include "commands/ExampleCommand.h"
 
+namespace {
+// Turns the simulated robot towards the autopilot's target angle, in radians
+// per second per radian of error
+constexpr double kSimHeadingGain = 8.0;
+}  // namespace
+
 RobotContainer::RobotContainer() {
   // Initialize all of your commands and subsystems here
+  if (frc::RobotBase::IsSimulation()) {
+    m_plant.emplace(autopilot::APSwervePlantConfig{},
+                    frc::Pose2d{2_m, 4_m, frc::Rotation2d{}});
+    m_velocityField = autopilot::APVelocityField::Load(
+        frc::filesystem::GetDeployDirectory() +
+        "/autopilot/velocity_field.bin");
+    m_runner.emplace(
+        autopilot::Autopilot{
+            autopilot::APProfile(
+                autopilot::APConstraints(4.5_mps, 3.0_mps_sq, 2.0))
+                .WithErrorXY(2_cm)
+                .WithErrorTheta(2_deg)
+                .WithBeelineRadius(8_cm)}
+            .WithVelocityField(m_velocityField ? &*m_velocityField
+                                               : nullptr));
+  }
 
   // Configure the button bindings
   ConfigureBindings();
@@ -34,6 +62,48 @@ void RobotContainer::ConfigureBindings() {
 }
 
 frc2::CommandPtr RobotContainer::GetAutonomousCommand() {
+  if (frc::RobotBase::IsSimulation()) {
+    // Drive the simulated drivetrain to the target, then stop
+    return frc2::FunctionalCommand(
+               [this] {
+                 m_runner->SetTarget(m_simTarget);
+                 m_runner->Start();
+               },
+               [this] {
+                 m_runner->SetState(
+                     autopilot::APTimestampedPose{
+                         m_plant->Pose(), frc::Timer::GetFPGATimestamp()},
+                     m_plant->Velocity());
+                 const autopilot::APRunnerOutput output = m_runner->Latest();
+                 if (!output.valid) {
+                   return;
+                 }
+                 const units::radian_t error =
+                     (output.result.targetAngle - m_plant->Pose().Rotation())
+                         .Radians();
+                 m_plant->SetCommand(frc::ChassisSpeeds{
+                     .vx = output.result.vx,
+                     .vy = output.result.vy,
+                     .omega = error * kSimHeadingGain / 1_s});
+               },
+               [this](bool) {
+                 m_runner->Stop();
+                 m_runner->ClearTarget();
+                 m_plant->SetCommand(frc::ChassisSpeeds{});
+               },
+               [this] { return m_runner->Latest().atTarget; })
+        .ToPtr();
+  }
+
   // An example command will be run in autonomous
   return autos::ExampleAuto(&m_subsystem);
 }
+
+void RobotContainer::SimulationInit() {
+  frc::SmartDashboard::PutData("Field", &m_field);
+}
+
+void RobotContainer::SimulationPeriodic(units::second_t dt) {
+  m_plant->Update(dt);
+  m_field.SetRobotPose(m_plant->Pose());
+}
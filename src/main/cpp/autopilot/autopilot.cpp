@@ -8,173 +8,328 @@
 
 #include "autopilot/autopilot.h"
 
+#include <wpi/timestamp.h>
+
 #include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include "autopilot/telemetry.h"
+#include "autopilot/trace.h"
 
 using namespace autopilot;
 
-Autopilot::Autopilot(const APProfile& profile) : m_profile(profile) {}
+namespace {
+core::Profile ToCore(const APProfile& profile) {
+  const APConstraints& constraints = profile.Constraints();
+  return core::Profile{
+      .velocity = constraints.velocity.value(),
+      .acceleration = constraints.acceleration.value(),
+      .jerk = constraints.jerk,
+      .errorXY = profile.ErrorXY().value(),
+      .errorTheta = profile.ErrorTheta().value(),
+      .beelineRadius = profile.BeelineRadius().value(),
+      .rotationVelocity = constraints.rotationVelocity.value(),
+      .rotationAcceleration = constraints.rotationAcceleration.value(),
+      .rotationJerk = constraints.rotationJerk,
+      .frictionCircle = constraints.frictionCircle,
+      .deceleration = constraints.deceleration.value(),
+      .velocityX = constraints.velocityX.value(),
+      .velocityY = constraints.velocityY.value()};
+}
 
-APResult Autopilot::Calculate(const frc::Pose2d& current,
-                              const frc::Translation2d& velocity,
-                              const APTarget& target) {
-  frc::Translation2d offset = ToTargetCoordinateFrame(
-      target.Reference().Translation() - current.Translation(), target);
+core::Pose ToCore(const frc::Pose2d& pose) {
+  return core::Pose{
+      .x = pose.X().value(),
+      .y = pose.Y().value(),
+      .rotation = {pose.Rotation().Cos(), pose.Rotation().Sin()}};
+}
+}  // namespace
 
-  if (offset == frc::Translation2d()) {
-    return APResult{
-        .vx = 0_mps, .vy = 0_mps, .targetAngle = target.Reference().Rotation()};
-  }
+Autopilot::Autopilot(const APProfile& profile)
+    : m_profile(profile), m_limits(core::Fold(ToCore(profile))) {}
 
-  frc::Translation2d initial = ToTargetCoordinateFrame(velocity, target);
-  units::meter_t disp = offset.Norm();
-
-  if (!target.EntryAngle().has_value() || disp < m_profile.BeelineRadius()) {
-    frc::Translation2d towardsTarget = offset / disp.value();
-    frc::Translation2d goal =
-        towardsTarget * CalculateMaxVelocity(disp, target.Velocity()).value();
-    frc::Translation2d out = Correct(initial, goal);
-    frc::Translation2d velo = ToGlobalCoordinateFrame(out, target);
-    frc::Rotation2d rot = GetRotationTarget(current.Rotation(), target, disp);
-    return APResult{.vx = units::meters_per_second_t{velo.X().value()},
-                    .vy = units::meters_per_second_t{velo.Y().value()},
-                    .targetAngle = rot};
-  }
+const APProfile& Autopilot::Profile() const {
+  return m_profile;
+}
 
-  frc::Translation2d goal = CalculateSwirlyVelocity(offset, target);
-  frc::Translation2d out = Correct(initial, goal);
-  frc::Translation2d velo = ToGlobalCoordinateFrame(out, target);
-  frc::Rotation2d rot = GetRotationTarget(current.Rotation(), target, disp);
+const core::Limits& Autopilot::Limits() const {
+  return m_limits;
+}
 
-  return APResult{.vx = units::meters_per_second_t{velo.X().value()},
-                  .vy = units::meters_per_second_t{velo.Y().value()},
-                  .targetAngle = rot};
+Autopilot& Autopilot::WithMathMode(APMathMode mode) {
+  m_limits.profile.mathMode = mode;
+  return *this;
 }
 
-frc::Translation2d Autopilot::ToTargetCoordinateFrame(
-    const frc::Translation2d& coords, const APTarget& target) {
-  frc::Rotation2d entryAngle = target.EntryAngle().value_or(frc::Rotation2d());
-  return coords.RotateBy(-entryAngle);
+APMathMode Autopilot::MathMode() const {
+  return m_limits.profile.mathMode;
 }
 
-frc::Translation2d Autopilot::ToGlobalCoordinateFrame(
-    const frc::Translation2d& coords, const APTarget& target) {
-  frc::Rotation2d entryAngle = target.EntryAngle().value_or(frc::Rotation2d());
-  return coords.RotateBy(entryAngle);
+Autopilot& Autopilot::WithPeriod(units::second_t period) {
+  m_limits.profile.period = period.value();
+  return *this;
 }
 
-units::meters_per_second_t Autopilot::CalculateMaxVelocity(
-    units::meter_t dist, units::meters_per_second_t endVelo) {
-  return units::meters_per_second_t{
-             std::cbrt((4.5 * std::pow(dist.value(), 2.0)) *
-                       m_profile.Constraints().jerk)} +
-         endVelo;
+units::second_t Autopilot::Period() const {
+  return units::second_t{m_limits.profile.period};
 }
 
-frc::Translation2d Autopilot::Correct(const frc::Translation2d& initial,
-                                      const frc::Translation2d& goal) {
-  frc::Rotation2d angleOffset;
-  if (goal != frc::Translation2d()) {
-    angleOffset = frc::Rotation2d(goal.X().value(), goal.Y().value());
+Autopilot& Autopilot::WithTelemetry(APTelemetryRing* ring) {
+  // Calculate counts itself in before it loads the ring, so once the new
+  // ring is stored, every call that may still hold the old one is counted
+  m_telemetry.ring.store(ring);
+  while (m_telemetry.recording.load() != 0) {
+    std::this_thread::yield();
   }
+  return *this;
+}
+
+Autopilot& Autopilot::WithVelocityField(const APVelocityField* field) {
+  m_velocityField = field;
+  return *this;
+}
+
+APResult Autopilot::Calculate(const frc::Pose2d& current,
+                              const frc::Translation2d& velocity,
+                              const APTarget& target) noexcept {
+  return Calculate(current, velocity, target, Period());
+}
+
+APResult Autopilot::Calculate(const frc::Pose2d& current,
+                              const frc::Translation2d& velocity,
+                              const APTarget& target,
+                              units::second_t dt) noexcept {
+  return Calculate(current, velocity, Prepare(target), dt);
+}
+
+APResult Autopilot::Calculate(const frc::Pose2d& current,
+                              const frc::Translation2d& velocity,
+                              const APPreparedTarget& target) noexcept {
+  return Calculate(current, velocity, target, Period());
+}
 
-  frc::Translation2d adjustedGoal = goal.RotateBy(-angleOffset);
-  frc::Translation2d adjustedInitial = initial.RotateBy(-angleOffset);
+APResult Autopilot::Calculate(const frc::Pose2d& current,
+                              const frc::Translation2d& velocity,
+                              const APPreparedTarget& target,
+                              units::second_t dt) noexcept {
+  return Calculate(current,
+                   frc::ChassisSpeeds{
+                       .vx = units::meters_per_second_t{velocity.X().value()},
+                       .vy = units::meters_per_second_t{velocity.Y().value()},
+                       .omega = 0_rad_per_s},
+                   target, dt);
+}
+
+APResult Autopilot::Calculate(const frc::Pose2d& current,
+                              const frc::ChassisSpeeds& velocity,
+                              const APTarget& target,
+                              units::second_t dt) noexcept {
+  return Calculate(current, velocity, Prepare(target), dt);
+}
 
-  units::meter_t initialI = adjustedInitial.X();
-  units::meter_t goalI = adjustedGoal.X();
+APResult Autopilot::Calculate(const frc::Pose2d& current,
+                              const frc::ChassisSpeeds& velocity,
+                              const APPreparedTarget& target,
+                              units::second_t dt) noexcept {
+  AP_TRACE_STAGE(kCalculate);
 
-  if (goalI.value() > m_profile.Constraints().velocity.value()) {
-    goalI = units::meter_t{m_profile.Constraints().velocity.value()};
+  if (!(dt > 0_s)) {
+    dt = Period();
   }
 
-  double adjustedI =
-      std::min(goalI.value(), Push(initialI.value(), goalI.value(),
-                                   m_profile.Constraints().acceleration));
-  return frc::Translation2d(units::meter_t{adjustedI}, units::meter_t{0})
-      .RotateBy(angleOffset);
+  const core::Result out = Evaluate(current, velocity, target, dt);
+  const APResult result = ToResult(current, target, out);
+
+  if (m_telemetry.ring.load(std::memory_order_relaxed)) {
+    AP_TRACE_STAGE(kTelemetry);
+    m_telemetry.recording.fetch_add(1);
+    if (APTelemetryRing* ring = m_telemetry.ring.load()) {
+      APRecord record;
+      record.timestamp = static_cast<int64_t>(wpi::Now());
+      record.x = current.X().value();
+      record.y = current.Y().value();
+      record.heading = current.Rotation().Radians().value();
+      record.vx = velocity.vx.value();
+      record.vy = velocity.vy.value();
+      record.omega = velocity.omega.value();
+      record.targetX = target.Reference().X().value();
+      record.targetY = target.Reference().Y().value();
+      record.targetHeading = target.Reference().Rotation().Radians().value();
+      if (std::isfinite(target.m_target.beelineRadiusSq)) {
+        record.entryAngle =
+            std::atan2(target.m_target.entrySin, target.m_target.entryCos);
+      }
+      record.rotationRadius =
+          std::copysign(std::sqrt(std::abs(target.m_target.rotationRadiusSq)),
+                        target.m_target.rotationRadiusSq);
+      record.endVelocity = target.Velocity().value();
+      record.dt = dt.value();
+      record.outVx = result.vx.value();
+      record.outVy = result.vy.value();
+      record.outHeading = result.targetAngle.Radians().value();
+      record.outOmega = result.omega.value();
+      record.disp = out.disp;
+      record.branch = out.branch;
+      record.field = target.m_target.field != nullptr;
+      ring->TryPush(record);
+    }
+    m_telemetry.recording.fetch_sub(1);
+  }
+  return result;
 }
 
-double Autopilot::Push(double start, double end,
-                       units::meters_per_second_squared_t accel) {
-  units::meters_per_second_t maxChange = accel * dt;
-  if (std::abs(start - end) < maxChange.value()) {
-    return end;
+APResult Autopilot::Preview(const frc::Pose2d& current,
+                            const frc::ChassisSpeeds& velocity,
+                            const APPreparedTarget& target,
+                            units::second_t dt) const noexcept {
+  if (!(dt > 0_s)) {
+    dt = Period();
   }
-  return start > end ? start - maxChange.value() : start + maxChange.value();
+  return ToResult(current, target, Evaluate(current, velocity, target, dt));
 }
 
-frc::Translation2d Autopilot::CalculateSwirlyVelocity(
-    const frc::Translation2d& offset, const APTarget& target) {
-  units::meter_t disp = offset.Norm();  // displacement magnitude (meter_t)
-  frc::Rotation2d theta(
-      offset.X().value(),
-      offset.Y().value());  // construct Rotation2d from raw doubles
-  units::radian_t rads = theta.Radians();  // angle in radians
-  units::meter_t dist = CalculateSwirlyLength(rads, disp);
+core::Result Autopilot::Evaluate(const frc::Pose2d& current,
+                                 const frc::ChassisSpeeds& velocity,
+                                 const APPreparedTarget& target,
+                                 units::second_t dt) const noexcept {
+  return core::Calculate(m_limits, ToCore(current),
+                         core::Velocity{velocity.vx.value(),
+                                        velocity.vy.value(),
+                                        velocity.omega.value()},
+                         target.m_target, dt.value());
+}
 
-  // Calculate vx, vy as unitless doubles (direction vector components)
-  double vx = theta.Cos() - rads.value() * theta.Sin();
-  double vy = rads.value() * theta.Cos() + theta.Sin();
+APResult Autopilot::ToResult(const frc::Pose2d& current,
+                             const APPreparedTarget& target,
+                             const core::Result& out) noexcept {
+  return APResult{.vx = units::meters_per_second_t{out.vx},
+                  .vy = units::meters_per_second_t{out.vy},
+                  .targetAngle = out.facesTarget
+                                     ? target.Reference().Rotation()
+                                     : current.Rotation(),
+                  .omega = units::radians_per_second_t{out.omega}};
+}
 
-  frc::Translation2d translation{
-      units::meter_t{vx},
-      units::meter_t{vy}};  // Translation2d takes doubles (unitless)
+APResult Autopilot::Calculate(const APTimestampedPose& measured,
+                              const frc::ChassisSpeeds& velocity,
+                              const APTarget& target, units::second_t now,
+                              units::second_t dt) noexcept {
+  return Calculate(measured, velocity, Prepare(target), now, dt);
+}
 
-  units::meter_t norm =
-      translation.Norm();  // norm is a meter_t because Translation2d uses
-                           // units::meter_t for components
+APResult Autopilot::Calculate(const APTimestampedPose& measured,
+                              const frc::ChassisSpeeds& velocity,
+                              const APPreparedTarget& target,
+                              units::second_t now,
+                              units::second_t dt) noexcept {
+  APResult result =
+      Calculate(PredictPose(measured, velocity, now), velocity, target, dt);
+
+  // Drop commands at or after now, so a repeated time replaces its command
+  while (m_commandCount > 0 &&
+         m_commands[(m_commandStart + m_commandCount - 1) % kCommandHistory]
+                 .time >= now) {
+    --m_commandCount;
+  }
+  if (m_commandCount == kCommandHistory) {
+    m_commandStart = (m_commandStart + 1) % kCommandHistory;
+    --m_commandCount;
+  }
+  m_commands[(m_commandStart + m_commandCount) % kCommandHistory] =
+      Command{now, frc::ChassisSpeeds{.vx = result.vx,
+                                      .vy = result.vy,
+                                      .omega = result.omega}};
+  ++m_commandCount;
+  return result;
+}
 
-  if (norm.value() == 0.0) {
-    return frc::Translation2d();  // zero vector if no direction
+frc::Pose2d Autopilot::PredictPose(const APTimestampedPose& measured,
+                                   const frc::ChassisSpeeds& velocity,
+                                   units::second_t now) const noexcept {
+  AP_TRACE_STAGE(kPredict);
+  const double start = measured.timestamp.value();
+  const double end = now.value();
+  if (!(end > start)) {
+    return measured.pose;
   }
 
-  // Normalize translation vector (unitless), so divide components by norm
-  // (units::meter_t)
-  frc::Translation2d unitVec = frc::Translation2d(
-      translation.X() / norm.value(), translation.Y() / norm.value());
+  const bool rotating = m_limits.rotating;
+  double x = measured.pose.X().value();
+  double y = measured.pose.Y().value();
+  double heading = 0.0;
+  double vx = velocity.vx.value();
+  double vy = velocity.vy.value();
+  double omega = velocity.omega.value();
+
+  // Integrate piecewise between the times the commands took effect. The
+  // velocities are field relative, so every piece is a straight line.
+  double time = start;
+  for (size_t i = 0; i < m_commandCount; ++i) {
+    const Command& command =
+        m_commands[(m_commandStart + i) % kCommandHistory];
+    const double from = command.time.value();
+    if (from >= end) {
+      break;
+    }
+    if (from > time) {
+      x += vx * (from - time);
+      y += vy * (from - time);
+      heading += omega * (from - time);
+      time = from;
+    }
+    vx = command.velocity.vx.value();
+    vy = command.velocity.vy.value();
+    if (rotating) {
+      omega = command.velocity.omega.value();
+    }
+  }
+  x += vx * (end - time);
+  y += vy * (end - time);
+  heading += omega * (end - time);
 
-  // Calculate speed (units::meter_t), extract raw double with .value()
-  double speed = CalculateMaxVelocity(dist, target.Velocity()).value();
+  return frc::Pose2d{
+      units::meter_t{x}, units::meter_t{y},
+      measured.pose.Rotation() + frc::Rotation2d{units::radian_t{heading}}};
+}
 
-  // Multiply normalized direction (unitless) by scalar speed (double) to get
-  // velocity vector
-  return unitVec * speed;
+void Autopilot::ClearCommandHistory() {
+  m_commandStart = 0;
+  m_commandCount = 0;
 }
 
-units::meter_t Autopilot::CalculateSwirlyLength(units::radian_t theta,
-                                                units::meter_t radius) {
-  if (theta.value() == 0.0)
-    return radius;
+APPreparedTarget Autopilot::Prepare(const APTarget& target) const noexcept {
+  APPreparedTarget prepared{target, m_profile};
+  if (m_velocityField && m_velocityField->Matches(*this)) {
+    if (const APFieldGrid* grid = m_velocityField->Find(target)) {
+      prepared.m_target.field = &grid->Grid();
+    }
+  }
+  return prepared;
+}
 
-  const double thetaVal = std::abs(theta.value());
-  const double hypot = std::hypot(thetaVal, 1.0);
-  const double logTerm = std::log(thetaVal + hypot);
-  units::meter_t u1 = radius * hypot;
-  units::meter_t u2 = radius * (logTerm / thetaVal);
-  return units::meter_t{0.5 * (u1 + u2)};
+frc::Translation2d Autopilot::ToTargetCoordinateFrame(
+    const frc::Translation2d& coords,
+    const APPreparedTarget& target) const noexcept {
+  const core::Vector frame = core::ToTargetFrame(
+      core::Vector{coords.X().value(), coords.Y().value()}, target.m_target);
+  return frc::Translation2d{units::meter_t{frame.x}, units::meter_t{frame.y}};
 }
 
-frc::Rotation2d Autopilot::GetRotationTarget(const frc::Rotation2d& current,
-                                             const APTarget& target,
-                                             units::meter_t dist) {
-  if (!target.RotationRadius().has_value()) {
-    return target.Reference().Rotation();
-  }
+units::meters_per_second_t Autopilot::CalculateMaxVelocity(
+    units::meter_t dist, units::meters_per_second_t endVelo) const noexcept {
+  return units::meters_per_second_t{
+      core::MaxVelocity(m_limits, dist.value(), endVelo.value())};
+}
 
-  units::meter_t radius = target.RotationRadius().value_or(units::meter_t{0});
-  if (radius > dist) {
-    return target.Reference().Rotation();
-  }
-  return current;
-}
-
-bool Autopilot::AtTarget(const frc::Pose2d& current, const APTarget& target) {
-  const frc::Pose2d& goal = target.Reference();
-  bool okXY = std::hypot(current.X().value() - goal.X().value(),
-                         current.Y().value() - goal.Y().value()) <=
-              m_profile.ErrorXY().to<double>();
-  bool okTheta =
-      std::abs((current.Rotation() - goal.Rotation()).Radians().value()) <=
-      m_profile.ErrorTheta().to<double>();
-  return okXY && okTheta;
+units::meter_t Autopilot::CalculateSwirlyLength(
+    units::radian_t theta, units::meter_t radius) const noexcept {
+  return units::meter_t{
+      core::SwirlyLength(m_limits, theta.value(), radius.value())};
+}
+
+bool Autopilot::AtTarget(const frc::Pose2d& current,
+                         const APTarget& target) const noexcept {
+  return core::AtTarget(m_limits.profile, ToCore(current),
+                        ToCore(target.Reference()));
 }
@@ -0,0 +1,130 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include "autopilot/batch.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "autopilot/autopilot.h"
+
+using namespace autopilot;
+
+size_t APStateBatch::Size() const {
+  const size_t size =
+      std::min({x.size(), y.size(), heading.size(), vx.size(), vy.size()});
+  return omega.empty() ? size : std::min(size, omega.size());
+}
+
+void APTargetBatch::Reserve(size_t count) {
+  m_x.reserve(count);
+  m_y.reserve(count);
+  m_cos.reserve(count);
+  m_sin.reserve(count);
+  m_entryCos.reserve(count);
+  m_entrySin.reserve(count);
+  m_hasEntry.reserve(count);
+  m_velocity.reserve(count);
+  m_rotationRadiusSq.reserve(count);
+}
+
+void APTargetBatch::Add(const APTarget& target) {
+  frc::Rotation2d entry = target.EntryAngle().value_or(frc::Rotation2d());
+  m_x.push_back(target.Reference().X().value());
+  m_y.push_back(target.Reference().Y().value());
+  m_cos.push_back(target.Reference().Rotation().Cos());
+  m_sin.push_back(target.Reference().Rotation().Sin());
+  m_entryCos.push_back(entry.Cos());
+  m_entrySin.push_back(entry.Sin());
+  m_hasEntry.push_back(target.EntryAngle().has_value() ? 1 : 0);
+  m_velocity.push_back(target.Velocity().value());
+  m_rotationRadiusSq.push_back(
+      target.RotationRadius().has_value()
+          ? core::detail::SignedSquare(target.RotationRadius()->value())
+          : std::numeric_limits<double>::infinity());
+}
+
+void APTargetBatch::Clear() {
+  m_x.clear();
+  m_y.clear();
+  m_cos.clear();
+  m_sin.clear();
+  m_entryCos.clear();
+  m_entrySin.clear();
+  m_hasEntry.clear();
+  m_velocity.clear();
+  m_rotationRadiusSq.clear();
+}
+
+void Autopilot::Calculate(const APStateBatch& states,
+                          const APTargetBatch& targets,
+                          std::span<APResult> out) noexcept {
+  constexpr size_t kBlock = core::detail::kBlock;
+  const size_t count = std::min({states.Size(), targets.Size(), out.size()});
+  const double beelineRadiusSq =
+      core::detail::SignedSquare(m_limits.profile.beelineRadius);
+
+  // The core takes headings as cosines and sines and the beeline radius per
+  // target, so fill those in one block at a time
+  std::array<double, kBlock> cos, sin, beeline, vx, vy, omega;
+  std::array<uint8_t, kBlock> facesTarget;
+  for (size_t start = 0; start < count; start += kBlock) {
+    const size_t n = std::min(kBlock, count - start);
+    for (size_t k = 0; k < n; ++k) {
+      cos[k] = std::cos(states.heading[start + k]);
+      sin[k] = std::sin(states.heading[start + k]);
+    }
+    for (size_t k = 0; k < n; ++k) {
+      beeline[k] = targets.m_hasEntry[start + k]
+                       ? beelineRadiusSq
+                       : std::numeric_limits<double>::infinity();
+    }
+
+    auto lanes = [&](const std::vector<double>& values) {
+      return std::span<const double>{values}.subspan(start, n);
+    };
+    core::CalculateBatch(
+        m_limits,
+        core::StateLanes{
+            .x = states.x.subspan(start, n),
+            .y = states.y.subspan(start, n),
+            .cos = std::span{cos}.first(n),
+            .sin = std::span{sin}.first(n),
+            .vx = states.vx.subspan(start, n),
+            .vy = states.vy.subspan(start, n),
+            .omega = states.omega.empty() ? states.omega
+                                          : states.omega.subspan(start, n)},
+        core::TargetLanes{
+            .x = lanes(targets.m_x),
+            .y = lanes(targets.m_y),
+            .cos = lanes(targets.m_cos),
+            .sin = lanes(targets.m_sin),
+            .velocity = lanes(targets.m_velocity),
+            .entryCos = lanes(targets.m_entryCos),
+            .entrySin = lanes(targets.m_entrySin),
+            .beelineRadiusSq = std::span{beeline}.first(n),
+            .rotationRadiusSq = lanes(targets.m_rotationRadiusSq)},
+        core::ResultLanes{
+            .vx = vx, .vy = vy, .omega = omega, .facesTarget = facesTarget},
+        n, m_limits.profile.period);
+
+    for (size_t k = 0; k < n; ++k) {
+      const size_t i = start + k;
+      out[i] = APResult{
+          .vx = units::meters_per_second_t{vx[k]},
+          .vy = units::meters_per_second_t{vy[k]},
+          .targetAngle =
+              facesTarget[k]
+                  ? frc::Rotation2d{targets.m_cos[i], targets.m_sin[i]}
+                  : frc::Rotation2d{units::radian_t{states.heading[i]}},
+          .omega = units::radians_per_second_t{omega[k]}};
+    }
+  }
+}
@@ -6,17 +6,10 @@
 // Inspired by the Autopilot project in Java:
 // https://github.com/therekrab/autopilot/
 
-#include <limits>
-
 #include "autopilot/constraints.h"
 
 using namespace autopilot;
 
-APConstraints::APConstraints()
-    : velocity(units::meters_per_second_t{std::numeric_limits<double>::max()}),
-      acceleration(units::meters_per_second_squared_t{0}),
-      jerk(0.0) {}
-
 APConstraints::APConstraints(units::meters_per_second_t velocity,
                              units::meters_per_second_squared_t acceleration,
                              double jerk)
@@ -24,9 +17,7 @@ APConstraints::APConstraints(units::meters_per_second_t velocity,
 
 APConstraints::APConstraints(units::meters_per_second_squared_t acceleration,
                              double jerk)
-    : velocity(units::meters_per_second_t{std::numeric_limits<double>::max()}),
-      acceleration(acceleration),
-      jerk(jerk) {}
+    : acceleration(acceleration), jerk(jerk) {}
 
 APConstraints& APConstraints::withVelocity(
     units::meters_per_second_t newVelocity) {
@@ -44,3 +35,39 @@ APConstraints& APConstraints::withJerk(double newJerk) {
   jerk = newJerk;
   return *this;
 }
+
+APConstraints& APConstraints::withDeceleration(
+    units::meters_per_second_squared_t newDeceleration) {
+  deceleration = newDeceleration;
+  return *this;
+}
+
+APConstraints& APConstraints::withAxisVelocity(
+    units::meters_per_second_t newVelocityX,
+    units::meters_per_second_t newVelocityY) {
+  velocityX = newVelocityX;
+  velocityY = newVelocityY;
+  return *this;
+}
+
+APConstraints& APConstraints::withRotationVelocity(
+    units::radians_per_second_t newRotationVelocity) {
+  rotationVelocity = newRotationVelocity;
+  return *this;
+}
+
+APConstraints& APConstraints::withRotationAcceleration(
+    units::radians_per_second_squared_t newRotationAcceleration) {
+  rotationAcceleration = newRotationAcceleration;
+  return *this;
+}
+
+APConstraints& APConstraints::withRotationJerk(double newRotationJerk) {
+  rotationJerk = newRotationJerk;
+  return *this;
+}
+
+APConstraints& APConstraints::withFrictionCircle(bool newFrictionCircle) {
+  frictionCircle = newFrictionCircle;
+  return *this;
+}
@@ -0,0 +1,173 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "autopilot/autopilot.h"
+
+using namespace autopilot;
+
+namespace {
+constexpr double kInfinity = std::numeric_limits<double>::infinity();
+
+// Bisection steps used to find where the acceleration limit meets the
+// velocity profile. 16 steps place it within 1/65536 of the path length.
+constexpr int kCrossingIterations = 16;
+
+/**
+ * The velocity profile CalculateMaxVelocity follows, as a function of the
+ * remaining path length s: v(s) = min(cap, k * s^(2/3) + end).
+ */
+struct SpeedProfile {
+  double k;
+  double end;
+  double cap;
+
+  double Speed(double s) const {
+    return std::min(cap, k * fast::Pow2Over3(s) + end);
+  }
+
+  /**
+   * Returns the time needed to cover the last s meters of the path while
+   * following the profile.
+   */
+  double Time(double s) const {
+    if (s <= 0.0) {
+      return 0.0;
+    }
+    if (k <= 0.0) {
+      double speed = std::min(cap, end);
+      return speed > 0.0 ? s / speed : kInfinity;
+    }
+    // Distance from the target at which the profile reaches the cap
+    double capped = cap > end ? std::pow((cap - end) / k, 1.5) : 0.0;
+    double uncapped = std::min(s, capped);
+    return Uncapped(uncapped) + (s - uncapped) / cap;
+  }
+
+  /**
+   * Integral of ds / (k s^(2/3) + end) from 0 to s. Substituting u = s^(1/3)
+   * gives 3/k * (u - sqrt(end/k) * atan(u * sqrt(k/end))).
+   */
+  double Uncapped(double s) const {
+    double u = std::cbrt(s);
+    if (end <= 0.0) {
+      return 3.0 * u / k;
+    }
+    double ratio = std::sqrt(end / k);
+    return 3.0 / k * (u - ratio * std::atan(u / ratio));
+  }
+};
+}  // namespace
+
+units::second_t Autopilot::MinimumTimeToTarget(
+    units::meter_t distance,
+    units::meters_per_second_t endVelocity) const noexcept {
+  const SpeedProfile profile{m_limits.jerkFactor, endVelocity.value(),
+                             m_profile.Constraints().velocity.value()};
+  const double length = distance.value();
+  const double tolerance = std::min(length, m_profile.ErrorXY().value());
+  return units::second_t{profile.Time(length) - profile.Time(tolerance)};
+}
+
+units::second_t Autopilot::EstimateTimeToTarget(
+    const frc::Pose2d& current, const frc::Translation2d& velocity,
+    const APTarget& target) const noexcept {
+  return EstimateTimeToTarget(current, velocity, Prepare(target));
+}
+
+units::second_t Autopilot::EstimateTimeToTarget(
+    const frc::Pose2d& current, const frc::Translation2d& velocity,
+    const APPreparedTarget& target) const noexcept {
+  frc::Translation2d offset = ToTargetCoordinateFrame(
+      target.Reference().Translation() - current.Translation(), target);
+  if (offset == frc::Translation2d()) {
+    return 0_s;
+  }
+
+  frc::Translation2d initial = ToTargetCoordinateFrame(velocity, target);
+  double dispSq = offset.X().value() * offset.X().value() +
+                  offset.Y().value() * offset.Y().value();
+  units::meter_t disp = offset.Norm();
+
+  // Path length and the direction the robot starts travelling in
+  double length = disp.value();
+  frc::Translation2d direction = offset / disp.value();
+  if (dispSq >= target.m_target.beelineRadiusSq) {
+    double c = 1.0;
+    double s = 0.0;
+    if (disp.value() > core::detail::kMinDirection) {
+      c = direction.X().value();
+      s = direction.Y().value();
+    }
+    const double theta = std::atan2(s, c);
+    length = CalculateSwirlyLength(units::radian_t{theta}, disp).value();
+    frc::Translation2d swirl{units::meter_t{c - theta * s},
+                             units::meter_t{theta * c + s}};
+    direction = swirl / swirl.Norm().value();
+  }
+
+  const SpeedProfile profile{m_limits.jerkFactor, target.Velocity().value(),
+                             m_limits.velocity};
+  const double accel = m_limits.acceleration;
+  const double decel = m_limits.braking;
+
+  // AtTarget succeeds once inside the translation tolerance, so the last
+  // stretch of the profile is never driven
+  const double tolerance = std::min(length, m_profile.ErrorXY().value());
+  auto remaining = [&](double s) {
+    return profile.Time(s) - profile.Time(std::min(s, tolerance));
+  };
+
+  // Correct drops the perpendicular part of the velocity immediately, and
+  // pushes the along-path part towards the profile
+  double v0 = initial.X().value() * direction.X().value() +
+              initial.Y().value() * direction.Y().value();
+
+  // Already at or above the profile: Correct clamps down to it at once
+  if (v0 >= profile.Speed(length)) {
+    return units::second_t{remaining(length)};
+  }
+  if (accel <= 0.0) {
+    return units::second_t{kInfinity};
+  }
+
+  // Moving away: brake to zero first, which adds the distance covered while
+  // braking to the path
+  double braking = 0.0;
+  if (v0 < 0.0) {
+    braking = -v0 / decel;
+    length += v0 * v0 / (2.0 * decel);
+    v0 = 0.0;
+  }
+
+  // Accelerating from v0 gives v(x) = sqrt(v0^2 + 2 a x) after x meters.
+  // Find where that meets the profile for the remaining length.
+  auto accelerated = [&](double x) {
+    return std::sqrt(v0 * v0 + 2.0 * accel * x);
+  };
+  const double reach = length - tolerance;
+  if (accelerated(reach) <= profile.Speed(tolerance)) {
+    return units::second_t{braking + (accelerated(reach) - v0) / accel};
+  }
+  double lo = 0.0;
+  double hi = reach;
+  for (int i = 0; i < kCrossingIterations; ++i) {
+    double mid = 0.5 * (lo + hi);
+    if (accelerated(mid) < profile.Speed(length - mid)) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  const double crossing = 0.5 * (lo + hi);
+  return units::second_t{braking + (accelerated(crossing) - v0) / accel +
+                         remaining(length - crossing)};
+}
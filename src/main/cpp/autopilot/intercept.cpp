@@ -0,0 +1,98 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include "autopilot/intercept.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace autopilot;
+
+APInterceptor::APInterceptor(Autopilot& autopilot,
+                             units::second_t horizon) noexcept
+    : m_autopilot(autopilot), m_horizon(horizon) {}
+
+APIntercept APInterceptor::Solve(const frc::Pose2d& current,
+                                 const frc::Translation2d& velocity,
+                                 const APMovingTarget& target,
+                                 units::second_t dt) noexcept {
+  if (!(dt > 0_s)) {
+    dt = m_autopilot.Period();
+  }
+  const double horizon = std::max(m_horizon.value(), 0.0);
+  const double tolerance = kTolerance.value();
+
+  int estimates = 0;
+  // How much longer reaching the target as it will be after t takes than t
+  auto residual = [&](double t) {
+    ++estimates;
+    return m_autopilot
+               .EstimateTimeToTarget(current, velocity,
+                                     target.At(units::second_t{t}))
+               .value() -
+           t;
+  };
+
+  // The previous intercept is dt closer now
+  double t = m_last ? std::clamp(m_last->time.value() - dt.value(), 0.0,
+                                 horizon)
+                    : 0.0;
+  double error = residual(t);
+  double previousT = t;
+  double previousError = error;
+  bool secant = false;
+  while (std::isfinite(error) && std::abs(error) > tolerance &&
+         estimates < kMaxEstimates) {
+    // Step to the time the estimate gives, which converges on its own
+    // whenever the target is slower than the robot. Once there are two
+    // points, take the secant step instead, but only while the residual
+    // falls with t; otherwise the target is getting away, and the secant
+    // would point back towards it.
+    double next = t + error;
+    if (secant && (error - previousError) * (t - previousT) < 0.0) {
+      next = t - error * (t - previousT) / (error - previousError);
+    }
+    next = std::clamp(next, 0.0, horizon);
+    if (next == t) {
+      // Held at the horizon or at zero
+      break;
+    }
+    previousT = t;
+    previousError = error;
+    secant = true;
+    t = next;
+    error = residual(t);
+  }
+
+  m_last = APIntercept{
+      .target = target.At(units::second_t{t}),
+      .time = units::second_t{t},
+      .converged = std::isfinite(error) && std::abs(error) <= tolerance,
+      .estimates = estimates};
+  return *m_last;
+}
+
+APResult APInterceptor::Calculate(const frc::Pose2d& current,
+                                  const frc::ChassisSpeeds& velocity,
+                                  const APMovingTarget& target,
+                                  units::second_t dt) noexcept {
+  const APIntercept intercept =
+      Solve(current,
+            frc::Translation2d{units::meter_t{velocity.vx.value()},
+                               units::meter_t{velocity.vy.value()}},
+            target, dt);
+  return m_autopilot.Calculate(current, velocity, intercept.target, dt);
+}
+
+const std::optional<APIntercept>& APInterceptor::Last() const noexcept {
+  return m_last;
+}
+
+void APInterceptor::Reset() noexcept {
+  m_last.reset();
+}
@@ -0,0 +1,51 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include "autopilot/moving_target.h"
+
+using namespace autopilot;
+
+APMovingTarget::APMovingTarget(const APTarget& target,
+                               const frc::Translation2d& velocity) noexcept
+    : m_target(target), m_velocity(velocity), m_acceleration{} {}
+
+APMovingTarget APMovingTarget::WithAcceleration(
+    const frc::Translation2d& acceleration) const noexcept {
+  APMovingTarget target = *this;
+  target.m_acceleration = std::optional<frc::Translation2d>{acceleration};
+  return target;
+}
+
+const APTarget& APMovingTarget::Target() const noexcept {
+  return m_target;
+}
+
+const frc::Translation2d& APMovingTarget::Velocity() const noexcept {
+  return m_velocity;
+}
+
+const std::optional<frc::Translation2d>& APMovingTarget::Acceleration()
+    const noexcept {
+  return m_acceleration;
+}
+
+frc::Translation2d APMovingTarget::PositionAt(
+    units::second_t time) const noexcept {
+  const double t = time.value();
+  frc::Translation2d position =
+      m_target.Reference().Translation() + m_velocity * t;
+  if (m_acceleration) {
+    position = position + *m_acceleration * (0.5 * t * t);
+  }
+  return position;
+}
+
+APTarget APMovingTarget::At(units::second_t time) const noexcept {
+  return m_target.WithReference(
+      frc::Pose2d{PositionAt(time), m_target.Reference().Rotation()});
+}
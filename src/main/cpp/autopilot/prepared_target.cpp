@@ -0,0 +1,40 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include "autopilot/prepared_target.h"
+
+#include <optional>
+
+using namespace autopilot;
+
+APPreparedTarget::APPreparedTarget(const APTarget& target,
+                                   const APProfile& profile) noexcept
+    : APPreparedTarget(
+          target,
+          APStaticProfile{.beelineRadius = profile.BeelineRadius().value()}) {}
+
+APPreparedTarget::APPreparedTarget(const APTarget& target,
+                                   const APStaticProfile& profile) noexcept
+    : m_reference(target.Reference()) {
+  std::optional<core::Rotation> entryAngle;
+  if (target.EntryAngle().has_value()) {
+    entryAngle =
+        core::Rotation{target.EntryAngle()->Cos(), target.EntryAngle()->Sin()};
+  }
+  std::optional<double> rotationRadius;
+  if (target.RotationRadius().has_value()) {
+    rotationRadius = target.RotationRadius()->value();
+  }
+  m_target =
+      core::Prepare(profile,
+                    core::Pose{.x = m_reference.X().value(),
+                               .y = m_reference.Y().value(),
+                               .rotation = {m_reference.Rotation().Cos(),
+                                            m_reference.Rotation().Sin()}},
+                    target.Velocity().value(), entryAngle, rotationRadius);
+}
@@ -0,0 +1,89 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include "autopilot/rollout.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace autopilot;
+
+APRolloutEngine::APRolloutEngine(const Autopilot& autopilot,
+                                 APRolloutOptions options)
+    : m_autopilot(autopilot), m_options(std::move(options)) {}
+
+APRolloutResult APRolloutEngine::Run(const frc::Pose2d& start,
+                                     const frc::Translation2d& velocity,
+                                     const APTarget& target,
+                                     std::span<APRolloutSample> buffer) {
+  const APPreparedTarget prepared = m_autopilot.Prepare(target);
+  const units::second_t step = m_options.step;
+  const double stepSeconds = step.value();
+  const int sampleEvery = std::max(1, m_options.sampleEvery);
+  const bool rotating = m_autopilot.Limits().rotating;
+
+  APRolloutSample state{0_s, start, velocity};
+  size_t count = 0;
+  auto record = [&] {
+    if (count < buffer.size()) {
+      buffer[count++] = state;
+    }
+  };
+
+  record();
+  int sinceSample = 0;
+  APRolloutStatus status = APRolloutStatus::kTimeout;
+  while (state.time < m_options.timeout) {
+    if (m_autopilot.AtTarget(state.pose, target)) {
+      status = APRolloutStatus::kAtTarget;
+      break;
+    }
+    if (m_options.stop && m_options.stop(state)) {
+      status = APRolloutStatus::kStopped;
+      break;
+    }
+    if (count == buffer.size()) {
+      status = APRolloutStatus::kBufferFull;
+      break;
+    }
+
+    APResult out = m_autopilot.Preview(
+        state.pose,
+        frc::ChassisSpeeds{
+            .vx = units::meters_per_second_t{state.velocity.X().value()},
+            .vy = units::meters_per_second_t{state.velocity.Y().value()},
+            .omega = state.omega},
+        prepared, step);
+    state.velocity = frc::Translation2d{units::meter_t{out.vx.value()},
+                                        units::meter_t{out.vy.value()}};
+    state.omega = out.omega;
+    frc::Rotation2d heading =
+        rotating ? state.pose.Rotation() +
+                       frc::Rotation2d{units::radian_t{
+                           out.omega.value() * stepSeconds}}
+                 : out.targetAngle;
+    state.pose = frc::Pose2d{
+        state.pose.Translation() + state.velocity * stepSeconds, heading};
+    state.time += step;
+
+    if (++sinceSample == sampleEvery) {
+      sinceSample = 0;
+      record();
+    }
+  }
+
+  // Make sure the path ends where the robot did
+  if (sinceSample != 0) {
+    record();
+  }
+  return APRolloutResult{status, count, state.time};
+}
+
+const APRolloutOptions& APRolloutEngine::Options() const {
+  return m_options;
+}
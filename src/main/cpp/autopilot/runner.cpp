@@ -0,0 +1,152 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include "autopilot/runner.h"
+
+#include <wpi/timestamp.h>
+
+#include <algorithm>
+
+using namespace autopilot;
+
+namespace {
+// wpi::Now counts microseconds
+constexpr double kMicrosecond = 1e-6;
+
+units::second_t Seconds(double microseconds) {
+  return units::second_t{microseconds * kMicrosecond};
+}
+
+// Stores value into a statistic if it is larger. Only the notifier thread
+// writes statistics, so no read-modify-write is needed.
+void StoreMax(std::atomic<uint64_t>& stat, uint64_t value) {
+  if (value > stat.load(std::memory_order_relaxed)) {
+    stat.store(value, std::memory_order_relaxed);
+  }
+}
+
+void Increment(std::atomic<uint64_t>& stat, uint64_t amount = 1) {
+  stat.store(stat.load(std::memory_order_relaxed) + amount,
+             std::memory_order_relaxed);
+}
+}  // namespace
+
+APRunner::APRunner(const Autopilot& autopilot, units::second_t period)
+    : m_autopilot(autopilot), m_period(period) {
+  m_autopilot.WithPeriod(period);
+  m_notifier.SetName("Autopilot");
+}
+
+APRunner::~APRunner() {
+  Stop();
+}
+
+void APRunner::Start() {
+  if (m_running) {
+    return;
+  }
+  m_lastStart = 0;
+  m_ticks.store(0, std::memory_order_relaxed);
+  m_overruns.store(0, std::memory_order_relaxed);
+  m_late.store(0, std::memory_order_relaxed);
+  m_maxDuration.store(0, std::memory_order_relaxed);
+  m_totalDuration.store(0, std::memory_order_relaxed);
+  m_maxJitter.store(0, std::memory_order_relaxed);
+  m_autopilot.ClearCommandHistory();
+  m_running = true;
+  m_notifier.StartPeriodic(m_period);
+}
+
+void APRunner::Stop() {
+  if (!m_running) {
+    return;
+  }
+  m_notifier.Stop();
+  m_running = false;
+}
+
+bool APRunner::IsRunning() const {
+  return m_running;
+}
+
+units::second_t APRunner::Period() const {
+  return m_period;
+}
+
+void APRunner::SetTarget(const APTarget& target) {
+  m_targets.Write(TargetInput{target, ++m_targetGeneration});
+}
+
+void APRunner::ClearTarget() {
+  m_targets.Write(TargetInput{std::nullopt, ++m_targetGeneration});
+}
+
+void APRunner::SetState(const APTimestampedPose& pose,
+                        const frc::ChassisSpeeds& velocity) {
+  m_states.Write(StateInput{pose, velocity, true});
+}
+
+APRunnerOutput APRunner::Latest() {
+  return m_outputs.Read();
+}
+
+APRunnerStats APRunner::Stats() const {
+  const uint64_t ticks = m_ticks.load(std::memory_order_relaxed);
+  const double total = m_totalDuration.load(std::memory_order_relaxed);
+  return APRunnerStats{
+      .ticks = ticks,
+      .overruns = m_overruns.load(std::memory_order_relaxed),
+      .late = m_late.load(std::memory_order_relaxed),
+      .maxDuration = Seconds(m_maxDuration.load(std::memory_order_relaxed)),
+      .meanDuration = Seconds(ticks > 0 ? total / ticks : 0.0),
+      .maxJitter = Seconds(m_maxJitter.load(std::memory_order_relaxed))};
+}
+
+void APRunner::Tick() {
+  const uint64_t start = wpi::Now();
+  const uint64_t period =
+      static_cast<uint64_t>(m_period.value() / kMicrosecond);
+  const uint64_t interval = m_lastStart > 0 ? start - m_lastStart : period;
+  m_lastStart = start;
+
+  const TargetInput& targetInput = m_targets.Read();
+  if (targetInput.generation != m_preparedGeneration) {
+    m_prepared.reset();
+    if (targetInput.target) {
+      m_prepared.emplace(m_autopilot.Prepare(*targetInput.target));
+    }
+    m_preparedGeneration = targetInput.generation;
+  }
+
+  const StateInput& state = m_states.Read();
+  const units::second_t now = Seconds(start);
+  APRunnerOutput output;
+  output.timestamp = now;
+  if (m_prepared && state.valid) {
+    output.result = m_autopilot.Calculate(state.pose, state.velocity,
+                                          *m_prepared, now, Seconds(interval));
+    output.atTarget = m_autopilot.AtTarget(
+        m_autopilot.PredictPose(state.pose, state.velocity, now),
+        *targetInput.target);
+    output.valid = true;
+  }
+  m_outputs.Write(output);
+
+  const uint64_t duration = wpi::Now() - start;
+  Increment(m_ticks);
+  Increment(m_totalDuration, duration);
+  StoreMax(m_maxDuration, duration);
+  StoreMax(m_maxJitter,
+           interval > period ? interval - period : period - interval);
+  if (duration > period) {
+    Increment(m_overruns);
+  }
+  if (interval > 2 * period) {
+    Increment(m_late);
+  }
+}
@@ -0,0 +1,187 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include "autopilot/swerve_plant.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace autopilot;
+
+APSwervePlant::APSwervePlant(const APSwervePlantConfig& config,
+                             const frc::Pose2d& pose)
+    : m_config(config) {
+  Reset(pose);
+}
+
+void APSwervePlant::Reset(const frc::Pose2d& pose,
+                          const frc::ChassisSpeeds& velocity) {
+  m_pose = pose;
+  m_command = velocity;
+  m_pendingStart = 0;
+  m_pendingCount = 0;
+
+  // Robot relative speeds, and the module velocities that produce them
+  const double c = pose.Rotation().Cos();
+  const double s = pose.Rotation().Sin();
+  const double vx = velocity.vx.value() * c + velocity.vy.value() * s;
+  const double vy = velocity.vy.value() * c - velocity.vx.value() * s;
+  const double omega = velocity.omega.value();
+  for (size_t i = 0; i < m_moduleVelocities.size(); ++i) {
+    const frc::Translation2d& r = m_config.modules[i];
+    m_moduleVelocities[i] =
+        frc::Translation2d{units::meter_t{vx - omega * r.Y().value()},
+                           units::meter_t{vy + omega * r.X().value()}};
+  }
+  m_velocity = FitChassisSpeeds();
+}
+
+void APSwervePlant::SetCommand(const frc::ChassisSpeeds& velocity) {
+  if (m_pendingCount == kMaxPending) {
+    m_command = m_pending[m_pendingStart].velocity;
+    m_pendingStart = (m_pendingStart + 1) % kMaxPending;
+    --m_pendingCount;
+  }
+  m_pending[(m_pendingStart + m_pendingCount) % kMaxPending] =
+      Pending{m_time, velocity};
+  ++m_pendingCount;
+}
+
+void APSwervePlant::Update(units::second_t dt) {
+  m_time += dt;
+  while (m_pendingCount > 0 &&
+         m_pending[m_pendingStart].time + m_config.latency <= m_time) {
+    m_command = m_pending[m_pendingStart].velocity;
+    m_pendingStart = (m_pendingStart + 1) % kMaxPending;
+    --m_pendingCount;
+  }
+
+  // The command in the robot's frame
+  const double c = m_pose.Rotation().Cos();
+  const double s = m_pose.Rotation().Sin();
+  const double vx = m_command.vx.value() * c + m_command.vy.value() * s;
+  const double vy = m_command.vy.value() * c - m_command.vx.value() * s;
+  const double omega = m_command.omega.value();
+
+  std::array<frc::Translation2d, 4> targets;
+  double fastest = 0.0;
+  for (size_t i = 0; i < targets.size(); ++i) {
+    const frc::Translation2d& r = m_config.modules[i];
+    targets[i] =
+        frc::Translation2d{units::meter_t{vx - omega * r.Y().value()},
+                           units::meter_t{vy + omega * r.X().value()}};
+    fastest = std::max(fastest, targets[i].Norm().value());
+  }
+  const double maxVelocity = m_config.maxModuleVelocity.value();
+  if (fastest > maxVelocity) {
+    for (frc::Translation2d& target : targets) {
+      target = target * (maxVelocity / fastest);
+    }
+  }
+
+  const double step = dt.value();
+  const double blend =
+      m_config.lag > 0_s ? std::min(1.0, step / m_config.lag.value()) : 1.0;
+  const double maxChange = m_config.maxModuleAcceleration.value() * step;
+  const double maxBrake =
+      m_config.maxModuleDeceleration > 0_mps_sq
+          ? m_config.maxModuleDeceleration.value() * step
+          : maxChange;
+  for (size_t i = 0; i < targets.size(); ++i) {
+    frc::Translation2d change = (targets[i] - m_moduleVelocities[i]) * blend;
+    const double size = change.Norm().value();
+    const bool braking =
+        change.X().value() * m_moduleVelocities[i].X().value() +
+            change.Y().value() * m_moduleVelocities[i].Y().value() <
+        0.0;
+    const double limit = braking ? maxBrake : maxChange;
+    if (size > limit) {
+      change = change * (limit / size);
+    }
+    m_moduleVelocities[i] = m_moduleVelocities[i] + change;
+  }
+  m_velocity = FitChassisSpeeds();
+
+  // Integrate the robot relative twist along an arc
+  const double dx = m_velocity.vx.value() * step;
+  const double dy = m_velocity.vy.value() * step;
+  const double dtheta = m_velocity.omega.value() * step;
+  double sinOverTheta;
+  double cosTermOverTheta;
+  if (std::abs(dtheta) < 1e-9) {
+    sinOverTheta = 1.0 - dtheta * dtheta / 6.0;
+    cosTermOverTheta = 0.5 * dtheta;
+  } else {
+    sinOverTheta = std::sin(dtheta) / dtheta;
+    cosTermOverTheta = (1.0 - std::cos(dtheta)) / dtheta;
+  }
+  const double localX = dx * sinOverTheta - dy * cosTermOverTheta;
+  const double localY = dx * cosTermOverTheta + dy * sinOverTheta;
+  m_pose = frc::Pose2d{
+      m_pose.X() + units::meter_t{localX * c - localY * s},
+      m_pose.Y() + units::meter_t{localX * s + localY * c},
+      m_pose.Rotation() + frc::Rotation2d{units::radian_t{dtheta}}};
+}
+
+const frc::Pose2d& APSwervePlant::Pose() const {
+  return m_pose;
+}
+
+frc::ChassisSpeeds APSwervePlant::Velocity() const {
+  const double c = m_pose.Rotation().Cos();
+  const double s = m_pose.Rotation().Sin();
+  const double vx = m_velocity.vx.value();
+  const double vy = m_velocity.vy.value();
+  return frc::ChassisSpeeds{.vx = units::meters_per_second_t{vx * c - vy * s},
+                            .vy = units::meters_per_second_t{vx * s + vy * c},
+                            .omega = m_velocity.omega};
+}
+
+units::second_t APSwervePlant::Time() const {
+  return m_time;
+}
+
+const APSwervePlantConfig& APSwervePlant::Config() const {
+  return m_config;
+}
+
+frc::ChassisSpeeds APSwervePlant::FitChassisSpeeds() const {
+  const size_t count = m_moduleVelocities.size();
+  double cx = 0.0;
+  double cy = 0.0;
+  double mx = 0.0;
+  double my = 0.0;
+  for (size_t i = 0; i < count; ++i) {
+    cx += m_config.modules[i].X().value();
+    cy += m_config.modules[i].Y().value();
+    mx += m_moduleVelocities[i].X().value();
+    my += m_moduleVelocities[i].Y().value();
+  }
+  cx /= count;
+  cy /= count;
+  mx /= count;
+  my /= count;
+
+  // Angular velocity from the spread of the modules about their centroid
+  double cross = 0.0;
+  double spread = 0.0;
+  for (size_t i = 0; i < count; ++i) {
+    const double rx = m_config.modules[i].X().value() - cx;
+    const double ry = m_config.modules[i].Y().value() - cy;
+    cross += rx * (m_moduleVelocities[i].Y().value() - my) -
+             ry * (m_moduleVelocities[i].X().value() - mx);
+    spread += rx * rx + ry * ry;
+  }
+  const double omega = spread > 0.0 ? cross / spread : 0.0;
+
+  // Move the centroid's velocity to the robot's center
+  return frc::ChassisSpeeds{
+      .vx = units::meters_per_second_t{mx + omega * cy},
+      .vy = units::meters_per_second_t{my - omega * cx},
+      .omega = units::radians_per_second_t{omega}};
+}
@@ -10,55 +10,57 @@
 
 using namespace autopilot;
 
-APTarget::APTarget(const frc::Pose2d& pose)
+APTarget::APTarget(const frc::Pose2d& pose) noexcept
     : m_reference(pose),
       m_velocity{0_mps},
       m_entryAngle{},
       m_rotationRadius{} {}
 
-APTarget APTarget::WithReference(const frc::Pose2d& reference) const {
+APTarget APTarget::WithReference(const frc::Pose2d& reference) const noexcept {
   APTarget target = this->Clone();
   target.m_reference = reference;
   return target;
 }
 
-APTarget APTarget::WithEntryAngle(const frc::Rotation2d& entryAngle) const {
+APTarget APTarget::WithEntryAngle(
+    const frc::Rotation2d& entryAngle) const noexcept {
   APTarget target = this->Clone();
   target.m_entryAngle = std::optional<frc::Rotation2d>{entryAngle};
   return target;
 }
 
-APTarget APTarget::WithVelocity(units::meters_per_second_t velocity) const {
+APTarget APTarget::WithVelocity(
+    units::meters_per_second_t velocity) const noexcept {
   APTarget target = this->Clone();
   target.m_velocity = velocity;
   return target;
 }
 
-APTarget APTarget::WithRotationRadius(units::meter_t radius) const {
+APTarget APTarget::WithRotationRadius(units::meter_t radius) const noexcept {
   APTarget target = this->Clone();
   target.m_rotationRadius = std::optional<units::meter_t>{radius};
   return target;
 }
 
-const frc::Pose2d& APTarget::Reference() const {
+const frc::Pose2d& APTarget::Reference() const noexcept {
   return this->m_reference;
 }
 
-const std::optional<frc::Rotation2d>& APTarget::EntryAngle() const {
+const std::optional<frc::Rotation2d>& APTarget::EntryAngle() const noexcept {
   return this->m_entryAngle;
 }
 
-units::meters_per_second_t APTarget::Velocity() const {
+units::meters_per_second_t APTarget::Velocity() const noexcept {
   return this->m_velocity;
 }
 
-APTarget autopilot::APTarget::WithoutEntryAngle() const {
+APTarget autopilot::APTarget::WithoutEntryAngle() const noexcept {
   APTarget target{this->m_reference};
   target.m_velocity = this->m_velocity;
   target.m_rotationRadius = this->m_rotationRadius;
   return target;
 }
 
-const std::optional<units::meter_t>& APTarget::RotationRadius() const {
+const std::optional<units::meter_t>& APTarget::RotationRadius() const noexcept {
   return this->m_rotationRadius;
 }
@@ -0,0 +1,108 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include "autopilot/target_set.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace autopilot;
+
+APTargetSet::APTargetSet(Autopilot& autopilot,
+                         std::span<const APTarget> targets)
+    : m_autopilot(autopilot),
+      m_targets(targets.begin(), targets.end()),
+      m_maxEndVelocity(0_mps) {
+  m_prepared.reserve(m_targets.size());
+  m_nodes.reserve(m_targets.size());
+  for (size_t i = 0; i < m_targets.size(); ++i) {
+    const APTarget& target = m_targets[i];
+    m_prepared.push_back(autopilot.Prepare(target));
+    m_nodes.push_back(Node{target.Reference().X().value(),
+                           target.Reference().Y().value(),
+                           static_cast<uint32_t>(i)});
+    m_maxEndVelocity = std::max(m_maxEndVelocity, target.Velocity());
+  }
+  Build(0, m_nodes.size(), 0);
+}
+
+void APTargetSet::Build(size_t lo, size_t hi, int depth) {
+  if (hi - lo <= 1) {
+    return;
+  }
+  size_t mid = lo + (hi - lo) / 2;
+  std::nth_element(m_nodes.begin() + lo, m_nodes.begin() + mid,
+                   m_nodes.begin() + hi, [depth](const Node& a, const Node& b) {
+                     return depth % 2 == 0 ? a.x < b.x : a.y < b.y;
+                   });
+  Build(lo, mid, depth + 1);
+  Build(mid + 1, hi, depth + 1);
+}
+
+std::optional<APTargetChoice> APTargetSet::Best(
+    const frc::Pose2d& current, const frc::Translation2d& velocity) const {
+  std::optional<APTargetChoice> best;
+  Search(0, m_nodes.size(), 0, current, velocity, best);
+  return best;
+}
+
+void APTargetSet::Search(size_t lo, size_t hi, int depth,
+                         const frc::Pose2d& current,
+                         const frc::Translation2d& velocity,
+                         std::optional<APTargetChoice>& best) const {
+  if (lo >= hi) {
+    return;
+  }
+  const size_t mid = lo + (hi - lo) / 2;
+  const Node& node = m_nodes[mid];
+  const double px = current.X().value();
+  const double py = current.Y().value();
+
+  auto bound = [&] {
+    return best ? best->time.value() : std::numeric_limits<double>::infinity();
+  };
+
+  auto lowerBound = [&](double dist) {
+    return m_autopilot.MinimumTimeToTarget(units::meter_t{dist},
+                                           m_maxEndVelocity)
+        .value();
+  };
+
+  if (lowerBound(std::hypot(node.x - px, node.y - py)) < bound()) {
+    units::second_t time = m_autopilot.EstimateTimeToTarget(
+        current, velocity, m_prepared[node.index]);
+    if (time.value() < bound()) {
+      best = APTargetChoice{node.index, time};
+    }
+  }
+
+  const double diff = depth % 2 == 0 ? px - node.x : py - node.y;
+  const size_t nearLo = diff < 0 ? lo : mid + 1;
+  const size_t nearHi = diff < 0 ? mid : hi;
+  const size_t farLo = diff < 0 ? mid + 1 : lo;
+  const size_t farHi = diff < 0 ? hi : mid;
+
+  Search(nearLo, nearHi, depth + 1, current, velocity, best);
+  // Everything across the split is at least |diff| away
+  if (lowerBound(std::abs(diff)) < bound()) {
+    Search(farLo, farHi, depth + 1, current, velocity, best);
+  }
+}
+
+const APTarget& APTargetSet::operator[](size_t index) const {
+  return m_targets[index];
+}
+
+const APPreparedTarget& APTargetSet::Prepared(size_t index) const {
+  return m_prepared[index];
+}
+
+size_t APTargetSet::Size() const {
+  return m_targets.size();
+}
@@ -0,0 +1,172 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include "autopilot/telemetry.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <string>
+
+#include "autopilot/autopilot.h"
+
+using namespace autopilot;
+
+std::array<double, APRecord::kSize> APRecord::Pack() const {
+  return {x,
+          y,
+          heading,
+          vx,
+          vy,
+          omega,
+          targetX,
+          targetY,
+          targetHeading,
+          entryAngle,
+          rotationRadius,
+          endVelocity,
+          dt,
+          outVx,
+          outVy,
+          outHeading,
+          outOmega,
+          disp,
+          static_cast<double>(branch),
+          field ? 1.0 : 0.0};
+}
+
+APRecord APRecord::Unpack(std::span<const double> packed, int64_t timestamp) {
+  std::array<double, kSize> fields = APRecord{}.Pack();
+  std::copy_n(packed.begin(), std::min(packed.size(), kSize), fields.begin());
+
+  APRecord record;
+  record.timestamp = timestamp;
+  record.x = fields[0];
+  record.y = fields[1];
+  record.heading = fields[2];
+  record.vx = fields[3];
+  record.vy = fields[4];
+  record.omega = fields[5];
+  record.targetX = fields[6];
+  record.targetY = fields[7];
+  record.targetHeading = fields[8];
+  record.entryAngle = fields[9];
+  record.rotationRadius = fields[10];
+  record.endVelocity = fields[11];
+  record.dt = fields[12];
+  record.outVx = fields[13];
+  record.outVy = fields[14];
+  record.outHeading = fields[15];
+  record.outOmega = fields[16];
+  record.disp = fields[17];
+  record.branch = static_cast<APBranch>(fields[18]);
+  record.field = fields[19] != 0.0;
+  return record;
+}
+
+APTelemetryRing::APTelemetryRing(size_t capacity)
+    : m_records(new APRecord[std::bit_ceil(std::max<size_t>(capacity, 1))]),
+      m_mask(std::bit_ceil(std::max<size_t>(capacity, 1)) - 1) {}
+
+bool APTelemetryRing::TryPush(const APRecord& record) noexcept {
+  const size_t head = m_head.load(std::memory_order_relaxed);
+  const size_t tail = m_tail.load(std::memory_order_acquire);
+  if (head - tail > m_mask) {
+    // Only the producer writes the count, so no read-modify-write is needed
+    m_dropped.store(m_dropped.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+    return false;
+  }
+  m_records[head & m_mask] = record;
+  m_head.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+bool APTelemetryRing::TryPop(APRecord& record) noexcept {
+  const size_t tail = m_tail.load(std::memory_order_relaxed);
+  const size_t head = m_head.load(std::memory_order_acquire);
+  if (tail == head) {
+    return false;
+  }
+  record = m_records[tail & m_mask];
+  m_tail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+size_t APTelemetryRing::Capacity() const {
+  return m_mask + 1;
+}
+
+uint64_t APTelemetryRing::Dropped() const {
+  return m_dropped.load(std::memory_order_relaxed);
+}
+
+APTelemetryLogger::APTelemetryLogger(Autopilot& autopilot,
+                                     wpi::log::DataLog& log,
+                                     std::string_view name, size_t capacity,
+                                     units::second_t pollPeriod)
+    : m_autopilot(autopilot),
+      m_ring(capacity),
+      m_recordEntry(log, std::string{name} + "/record", APRecord::kFields),
+      m_droppedEntry(log, std::string{name} + "/dropped"),
+      m_pollPeriod(pollPeriod) {
+  const APProfile& profile = autopilot.Profile();
+  const APConstraints& constraints = profile.Constraints();
+  const double fields[] = {
+      constraints.velocity.value(),
+      constraints.acceleration.value(),
+      constraints.jerk,
+      profile.ErrorXY().value(),
+      profile.ErrorTheta().value(),
+      profile.BeelineRadius().value(),
+      constraints.rotationVelocity.value(),
+      constraints.rotationAcceleration.value(),
+      constraints.rotationJerk,
+      autopilot.Period().value(),
+      static_cast<double>(autopilot.MathMode()),
+      constraints.frictionCircle ? 1.0 : 0.0,
+      constraints.deceleration.value(),
+      constraints.velocityX.value(),
+      constraints.velocityY.value()};
+  wpi::log::DoubleArrayLogEntry{log, std::string{name} + "/profile",
+                                kProfileFields}
+      .Append(fields);
+
+  m_autopilot.WithTelemetry(&m_ring);
+  m_thread = std::thread([this] {
+    const auto poll = std::chrono::duration<double>(m_pollPeriod.value());
+    while (m_running.load(std::memory_order_acquire)) {
+      Drain();
+      std::this_thread::sleep_for(poll);
+    }
+  });
+}
+
+APTelemetryLogger::~APTelemetryLogger() {
+  m_autopilot.WithTelemetry(nullptr);
+  m_running.store(false, std::memory_order_release);
+  m_thread.join();
+  Drain();
+}
+
+uint64_t APTelemetryLogger::Dropped() const {
+  return m_ring.Dropped();
+}
+
+void APTelemetryLogger::Drain() {
+  APRecord record;
+  while (m_ring.TryPop(record)) {
+    m_recordEntry.Append(record.Pack(), record.timestamp);
+  }
+
+  const uint64_t dropped = m_ring.Dropped();
+  if (dropped != m_loggedDropped) {
+    m_droppedEntry.Append(static_cast<int64_t>(dropped));
+    m_loggedDropped = dropped;
+  }
+}
@@ -0,0 +1,211 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include "autopilot/trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+using namespace autopilot;
+
+namespace {
+#ifdef AUTOPILOT_TRACE
+constexpr size_t kStageCount = static_cast<size_t>(APStage::kCount);
+
+struct Event {
+  int64_t start;      // ns
+  uint32_t duration;  // ns
+  APStage stage;
+};
+
+// Everything one thread records. Only the owning thread writes to it.
+struct ThreadTrace {
+  std::array<APStageHistogram, kStageCount> histograms;
+  std::array<Event, APTrace::kEvents> events;
+  // Events recorded, including the overwritten ones
+  uint64_t recorded = 0;
+};
+
+ThreadTrace gThreads[APTrace::kMaxThreads];
+// Slots claimed so far, possibly more than there are
+std::atomic<size_t> gClaimed{0};
+
+constinit thread_local ThreadTrace* tTrace = nullptr;
+constinit thread_local bool tClaimed = false;
+
+ThreadTrace* Claim() {
+  if (!tClaimed) {
+    tClaimed = true;
+    const size_t slot = gClaimed.fetch_add(1, std::memory_order_relaxed);
+    if (slot < APTrace::kMaxThreads) {
+      tTrace = &gThreads[slot];
+    }
+  }
+  return tTrace;
+}
+
+size_t ClaimedThreads() {
+  return std::min(gClaimed.load(std::memory_order_acquire),
+                  APTrace::kMaxThreads);
+}
+#endif
+}  // namespace
+
+uint64_t APStageHistogram::Percentile(double quantile) const {
+  if (count == 0) {
+    return 0;
+  }
+  const uint64_t rank = std::min<uint64_t>(
+      count - 1, static_cast<uint64_t>(quantile * static_cast<double>(count)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBuckets; ++i) {
+    seen += buckets[i];
+    if (seen > rank) {
+      return std::min(uint64_t{1} << i, maxNanos);
+    }
+  }
+  return maxNanos;
+}
+
+int64_t APTrace::Now() noexcept {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void APTrace::Record(APStage stage, int64_t start, int64_t end) noexcept {
+#ifdef AUTOPILOT_TRACE
+  ThreadTrace* trace = Claim();
+  if (!trace) {
+    return;
+  }
+  const uint64_t nanos =
+      static_cast<uint64_t>(std::max<int64_t>(end - start, 0));
+  APStageHistogram& histogram =
+      trace->histograms[static_cast<size_t>(stage)];
+  ++histogram.count;
+  histogram.totalNanos += nanos;
+  histogram.maxNanos = std::max(histogram.maxNanos, nanos);
+  ++histogram.buckets[std::min<size_t>(std::bit_width(nanos),
+                                       APStageHistogram::kBuckets - 1)];
+
+  trace->events[trace->recorded % kEvents] = Event{
+      start,
+      static_cast<uint32_t>(
+          std::min<uint64_t>(nanos, std::numeric_limits<uint32_t>::max())),
+      stage};
+  ++trace->recorded;
+#else
+  static_cast<void>(stage);
+  static_cast<void>(start);
+  static_cast<void>(end);
+#endif
+}
+
+APStageHistogram APTrace::Histogram(APStage stage) {
+  APStageHistogram merged;
+#ifdef AUTOPILOT_TRACE
+  for (size_t t = 0; t < ClaimedThreads(); ++t) {
+    const APStageHistogram& histogram =
+        gThreads[t].histograms[static_cast<size_t>(stage)];
+    merged.count += histogram.count;
+    merged.totalNanos += histogram.totalNanos;
+    merged.maxNanos = std::max(merged.maxNanos, histogram.maxNanos);
+    for (size_t i = 0; i < APStageHistogram::kBuckets; ++i) {
+      merged.buckets[i] += histogram.buckets[i];
+    }
+  }
+#else
+  static_cast<void>(stage);
+#endif
+  return merged;
+}
+
+bool APTrace::WriteChromeTrace(std::string_view path) {
+#ifdef AUTOPILOT_TRACE
+  std::FILE* file = std::fopen(std::string{path}.c_str(), "w");
+  if (!file) {
+    return false;
+  }
+
+  // Timestamps start from the earliest event kept
+  const size_t threads = ClaimedThreads();
+  int64_t origin = std::numeric_limits<int64_t>::max();
+  for (size_t t = 0; t < threads; ++t) {
+    const ThreadTrace& trace = gThreads[t];
+    const size_t kept = std::min<uint64_t>(trace.recorded, kEvents);
+    for (size_t i = 0; i < kept; ++i) {
+      origin = std::min(origin, trace.events[i].start);
+    }
+  }
+
+  std::fprintf(file, "{\"traceEvents\":[");
+  const char* separator = "\n";
+  for (size_t t = 0; t < threads; ++t) {
+    std::fprintf(file,
+                 "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                 "\"tid\":%zu,\"args\":{\"name\":\"autopilot %zu\"}}",
+                 separator, t, t);
+    separator = ",\n";
+
+    const ThreadTrace& trace = gThreads[t];
+    const size_t kept = std::min<uint64_t>(trace.recorded, kEvents);
+    for (size_t i = 0; i < kept; ++i) {
+      const Event& event = trace.events[i];
+      const std::string_view name =
+          kStageNames[static_cast<size_t>(event.stage)];
+      std::fprintf(file,
+                   ",\n{\"name\":\"%.*s\",\"cat\":\"autopilot\",\"ph\":\"X\","
+                   "\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%zu}",
+                   static_cast<int>(name.size()), name.data(),
+                   (event.start - origin) / 1000.0, event.duration / 1000.0,
+                   t);
+    }
+  }
+  std::fprintf(file, "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{");
+
+  // Durations here are in nanoseconds, percentiles rounded up to powers of
+  // two
+  for (size_t s = 0; s < kStageCount; ++s) {
+    const APStageHistogram histogram = Histogram(static_cast<APStage>(s));
+    const double mean =
+        histogram.count > 0
+            ? static_cast<double>(histogram.totalNanos) / histogram.count
+            : 0.0;
+    std::fprintf(file,
+                 "%s\"%.*s\":{\"count\":%llu,\"meanNs\":%.1f,\"p50Ns\":%llu,"
+                 "\"p99Ns\":%llu,\"maxNs\":%llu}",
+                 s == 0 ? "\n" : ",\n",
+                 static_cast<int>(kStageNames[s].size()),
+                 kStageNames[s].data(),
+                 static_cast<unsigned long long>(histogram.count), mean,
+                 static_cast<unsigned long long>(histogram.Percentile(0.5)),
+                 static_cast<unsigned long long>(histogram.Percentile(0.99)),
+                 static_cast<unsigned long long>(histogram.maxNanos));
+  }
+  std::fprintf(file, "\n}}\n");
+  return std::fclose(file) == 0;
+#else
+  static_cast<void>(path);
+  return false;
+#endif
+}
+
+void APTrace::Reset() {
+#ifdef AUTOPILOT_TRACE
+  for (size_t t = 0; t < ClaimedThreads(); ++t) {
+    gThreads[t].histograms = {};
+    gThreads[t].recorded = 0;
+  }
+#endif
+}
@@ -0,0 +1,230 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include "autopilot/velocity_field.h"
+
+#include <wpi/fs.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "autopilot/autopilot.h"
+
+using namespace autopilot;
+
+static_assert(std::endian::native == std::endian::little,
+              "velocity field files are little endian");
+
+namespace {
+// Baked targets must match to within this many meters, radians or meters
+// per second
+constexpr double kMatchTolerance = 1e-9;
+
+// Offsets within this many cell sizes outside the beeline radius are
+// computed exactly. The goal velocity jumps at the radius and bends sharply
+// close to the target, where interpolation errors would be largest.
+constexpr double kGuardCells = 8.0;
+
+bool Near(double a, double b) {
+  return std::abs(a - b) <= kMatchTolerance;
+}
+}  // namespace
+
+APFieldGrid::APFieldGrid(const APFieldRecord& record, const float* samples,
+                         double beelineRadius)
+    : m_record(&record) {
+  const double cellSize = 2.0 * record.extent / (record.size - 1);
+  m_grid = core::FieldGrid{
+      .extent = record.extent,
+      .size = record.size,
+      .cellSize = cellSize,
+      .inverseCellSize = (record.size - 1) / (2.0 * record.extent),
+      .guardSq = std::pow(
+          std::max(beelineRadius, 0.0) + kGuardCells * cellSize, 2.0),
+      .samples = samples};
+}
+
+std::optional<frc::Translation2d> APFieldGrid::Lookup(
+    const frc::Translation2d& offset) const noexcept {
+  const std::optional<core::Vector> goal = core::Lookup(
+      m_grid, core::Vector{offset.X().value(), offset.Y().value()});
+  if (!goal) {
+    return std::nullopt;
+  }
+  return frc::Translation2d{units::meter_t{goal->x}, units::meter_t{goal->y}};
+}
+
+bool APFieldGrid::Matches(const APTarget& target) const noexcept {
+  // The heading does not affect the goal velocity, so it is not compared
+  return target.EntryAngle().has_value() &&
+         Near(target.Reference().X().value(), m_record->x) &&
+         Near(target.Reference().Y().value(), m_record->y) &&
+         Near(target.EntryAngle()->Radians().value(), m_record->entryAngle) &&
+         Near(target.Velocity().value(), m_record->endVelocity);
+}
+
+APVelocityField::APVelocityField(wpi::MappedFileRegion region,
+                                 std::vector<APFieldGrid> grids)
+    : m_region(std::move(region)), m_grids(std::move(grids)) {}
+
+std::optional<APVelocityField> APVelocityField::Load(std::string_view path) {
+  std::error_code ec;
+  const fs::path file{path};
+  const uintmax_t size = fs::file_size(file, ec);
+  if (ec || size < sizeof(APFieldFileHeader)) {
+    return std::nullopt;
+  }
+  fs::file_t handle = fs::OpenFileForRead(file, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  wpi::MappedFileRegion region{handle, size, 0,
+                               wpi::MappedFileRegion::kReadOnly, ec};
+  fs::CloseFile(handle);
+  if (ec || !region) {
+    return std::nullopt;
+  }
+
+  const uint8_t* data = region.const_data();
+  const auto* header = reinterpret_cast<const APFieldFileHeader*>(data);
+  if (std::memcmp(header->magic, APFieldFileHeader::kMagic,
+                  sizeof(header->magic)) != 0 ||
+      header->version != APFieldFileHeader::kVersion ||
+      header->count >
+          (size - sizeof(APFieldFileHeader)) / sizeof(APFieldRecord)) {
+    return std::nullopt;
+  }
+
+  const auto* records = reinterpret_cast<const APFieldRecord*>(
+      data + sizeof(APFieldFileHeader));
+  std::vector<APFieldGrid> grids;
+  grids.reserve(header->count);
+  for (uint32_t i = 0; i < header->count; ++i) {
+    const APFieldRecord& record = records[i];
+    const uint64_t bytes =
+        2 * sizeof(float) * static_cast<uint64_t>(record.size) * record.size;
+    if (record.size < 2 || !(record.extent > 0.0) ||
+        record.offset % alignof(float) != 0 || record.offset > size ||
+        bytes > size - record.offset) {
+      return std::nullopt;
+    }
+    grids.emplace_back(record,
+                       reinterpret_cast<const float*>(data + record.offset),
+                       header->beelineRadius);
+  }
+  return APVelocityField{std::move(region), std::move(grids)};
+}
+
+bool APVelocityField::Bake(Autopilot& autopilot,
+                           std::span<const APTarget> targets,
+                           units::meter_t extent, units::meter_t cellSize,
+                           std::string_view path) {
+  if (!(extent.value() > 0.0) || !(cellSize.value() > 0.0)) {
+    return false;
+  }
+  const uint32_t size = static_cast<uint32_t>(std::ceil(
+                            2.0 * extent.value() / cellSize.value())) +
+                        1;
+  const uint64_t bytes =
+      2 * sizeof(float) * static_cast<uint64_t>(size) * size;
+
+  const APProfile& profile = autopilot.Profile();
+  APFieldFileHeader header{};
+  std::memcpy(header.magic, APFieldFileHeader::kMagic, sizeof(header.magic));
+  header.version = APFieldFileHeader::kVersion;
+  header.count = static_cast<uint32_t>(targets.size());
+  header.jerk = profile.Constraints().jerk;
+  header.deceleration = profile.Constraints().deceleration.value();
+  header.beelineRadius = profile.BeelineRadius().value();
+  header.mathMode = static_cast<uint32_t>(autopilot.MathMode());
+
+  std::vector<APFieldRecord> records;
+  records.reserve(targets.size());
+  uint64_t offset =
+      sizeof(APFieldFileHeader) + targets.size() * sizeof(APFieldRecord);
+  for (const APTarget& target : targets) {
+    if (!target.EntryAngle().has_value()) {
+      return false;
+    }
+    records.push_back(APFieldRecord{
+        .x = target.Reference().X().value(),
+        .y = target.Reference().Y().value(),
+        .heading = target.Reference().Rotation().Radians().value(),
+        .entryAngle = target.EntryAngle()->Radians().value(),
+        .endVelocity = target.Velocity().value(),
+        .extent = extent.value(),
+        .size = size,
+        .reserved = 0,
+        .offset = offset});
+    offset += bytes;
+  }
+
+  std::ofstream file{std::string{path}, std::ios::binary};
+  if (!file) {
+    return false;
+  }
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(records.data()),
+             records.size() * sizeof(APFieldRecord));
+
+  const double step = 2.0 * extent.value() / (size - 1);
+  std::vector<float> samples(2 * static_cast<size_t>(size) * size);
+  for (const APTarget& target : targets) {
+    for (uint32_t row = 0; row < size; ++row) {
+      for (uint32_t column = 0; column < size; ++column) {
+        const core::Vector offset{column * step - extent.value(),
+                                  row * step - extent.value()};
+        core::Vector goal;
+        if (std::hypot(offset.x, offset.y) > core::detail::kMinDirection) {
+          goal = core::SwirlyVelocity(autopilot.m_limits, offset,
+                                      target.Velocity().value());
+        }
+        const size_t index = 2 * (static_cast<size_t>(row) * size + column);
+        samples[index] = static_cast<float>(goal.x);
+        samples[index + 1] = static_cast<float>(goal.y);
+      }
+    }
+    file.write(reinterpret_cast<const char*>(samples.data()),
+               samples.size() * sizeof(float));
+  }
+  return static_cast<bool>(file);
+}
+
+bool APVelocityField::Matches(const Autopilot& autopilot) const noexcept {
+  const auto* header =
+      reinterpret_cast<const APFieldFileHeader*>(m_region.const_data());
+  const APProfile& profile = autopilot.Profile();
+  return header->jerk == profile.Constraints().jerk &&
+         header->deceleration == profile.Constraints().deceleration.value() &&
+         header->beelineRadius == profile.BeelineRadius().value() &&
+         header->mathMode == static_cast<uint32_t>(autopilot.MathMode());
+}
+
+const APFieldGrid* APVelocityField::Find(
+    const APTarget& target) const noexcept {
+  for (const APFieldGrid& grid : m_grids) {
+    if (grid.Matches(target)) {
+      return &grid;
+    }
+  }
+  return nullptr;
+}
+
+size_t APVelocityField::Size() const {
+  return m_grids.size();
+}
+
+size_t APVelocityField::Bytes() const {
+  return m_region.size();
+}
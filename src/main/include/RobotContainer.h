@@ -8,10 +8,25 @@
 
 #pragma once
 
+#include <frc/geometry/Pose2d.h>
+#include <frc/geometry/Rotation2d.h>
+#include <frc/smartdashboard/Field2d.h>
 #include <frc2/command/CommandPtr.h>
 #include <frc2/command/button/CommandXboxController.h>
+#include <units/acceleration.h>
+#include <units/angle.h>
+#include <units/length.h>
+#include <units/time.h>
+#include <units/velocity.h>
+
+#include <optional>
 
 #include "Constants.h"
+#include "autopilot/autopilot.h"
+#include "autopilot/runner.h"
+#include "autopilot/swerve_plant.h"
+#include "autopilot/target.h"
+#include "autopilot/velocity_field.h"
 #include "subsystems/ExampleSubsystem.h"
 
 /**
@@ -27,6 +42,17 @@ class RobotContainer {
 
   frc2::CommandPtr GetAutonomousCommand();
 
+  /**
+   * Publishes the simulated field to SmartDashboard.
+   */
+  void SimulationInit();
+
+  /**
+   * Advances the simulated drivetrain by the given time and shows its pose on
+   * the field.
+   */
+  void SimulationPeriodic(units::second_t dt);
+
  private:
   // Replace with CommandPS4Controller or CommandJoystick if needed
   frc2::CommandXboxController m_driverController{
@@ -35,5 +61,19 @@ class RobotContainer {
   // The robot's subsystems are defined here...
   ExampleSubsystem m_subsystem;
 
+  // In simulation, autonomous drives this plant to m_simTarget with an
+  // autopilot running on its own thread. Only built in simulation.
+  std::optional<autopilot::APSwervePlant> m_plant;
+  // Goal velocities baked by the tools' bake command for the targets in
+  // deploy/autopilot/targets.csv, if the file was deployed. Only mapped in
+  // simulation, for m_runner.
+  std::optional<autopilot::APVelocityField> m_velocityField;
+  // Only built in simulation, so a real robot does not start its Notifier
+  std::optional<autopilot::APRunner> m_runner;
+  autopilot::APTarget m_simTarget =
+      autopilot::APTarget{frc::Pose2d{14_m, 2_m, frc::Rotation2d{90_deg}}}
+          .WithEntryAngle(frc::Rotation2d{0_deg});
+  frc::Field2d m_field;
+
   void ConfigureBindings();
 };
@@ -11,20 +11,38 @@
 #include <frc/geometry/Pose2d.h>
 #include <frc/geometry/Rotation2d.h>
 #include <frc/geometry/Translation2d.h>
+#include <frc/kinematics/ChassisSpeeds.h>
 #include <units/angle.h>
+#include <units/angular_velocity.h>
 #include <units/length.h>
 #include <units/time.h>
 
+#include <array>
+#include <atomic>
+#include <cstddef>
 #include <optional>
+#include <span>
 
+#include "batch.h"
+#include "core.h"
+#include "fastmath.h"
+#include "prepared_target.h"
 #include "profile.h"
 #include "target.h"
+#include "timestamped_pose.h"
+#include "velocity_field.h"
 
 namespace autopilot {
+// Defined in telemetry.h, which only code that records needs
+class APTelemetryRing;
+
 struct APResult {
   units::meters_per_second_t vx;
   units::meters_per_second_t vy;
   frc::Rotation2d targetAngle;
+  // Angular velocity feed-forward towards targetAngle. Always zero unless the
+  // profile's constraints enable the rotational profile.
+  units::radians_per_second_t omega = 0_rad_per_s;
 };
 
 /**
@@ -38,6 +56,16 @@ struct APResult {
  *
  * This means that autopilot is un able to avoid obstacles, because it cannot
  * think ahead.
+ *
+ * The control law itself is autopilot::core, which works on plain doubles
+ * without WPILib. Autopilot converts the geometry and units types to and from
+ * it, and adds the command history, telemetry and velocity field on top.
+ *
+ * The per-tick path, every scalar Calculate along with Prepare, PredictPose
+ * and AtTarget, never allocates, locks or throws, and does a bounded amount
+ * of work: the only loops walk the fixed size command history and the grids
+ * of an attached velocity field. The tools' realtime command checks this by
+ * failing on any allocation during a long randomized run.
  */
 class Autopilot {
  public:
@@ -49,6 +77,71 @@ class Autopilot {
    */
   explicit Autopilot(const APProfile& profile);
 
+  /**
+   * Returns the profile this autopilot uses for all actions.
+   */
+  const APProfile& Profile() const;
+
+  /**
+   * Returns the limits folded from the profile, with the flags the control
+   * law branches on: whether the rotational profile is enabled, whether a
+   * separate deceleration is set, the limit used when braking, and whether
+   * an axis velocity is limited.
+   */
+  const core::Limits& Limits() const;
+
+  /**
+   * Modifies how this autopilot evaluates its math kernels and returns itself.
+   *
+   * APMathMode::kFast replaces the swirly arc length and the jerk limited
+   * max velocity with table and Newton iteration based approximations. Their
+   * relative errors are bounded by fast::kSwirlyScaleError and
+   * fast::kPow2Over3Error respectively.
+   */
+  Autopilot& WithMathMode(APMathMode mode);
+
+  /**
+   * Returns the math mode this autopilot uses.
+   */
+  APMathMode MathMode() const;
+
+  /**
+   * Modifies the control loop period this autopilot assumes between calls to
+   * Calculate and returns itself. Defaults to 20 ms.
+   */
+  Autopilot& WithPeriod(units::second_t period);
+
+  /**
+   * Returns the control loop period this autopilot assumes.
+   */
+  units::second_t Period() const;
+
+  /**
+   * Attaches a ring that every scalar Calculate call copies an APRecord into,
+   * and returns itself. Pass nullptr to detach. Recording never allocates or
+   * blocks; when the ring is full the record is dropped. Copies of this
+   * autopilot are not attached.
+   *
+   * This may be called while another thread is in Calculate, such as an
+   * APRunner's. Replacing or detaching a ring waits for any Calculate still
+   * recording into it to finish, so the ring may be destroyed as soon as
+   * this returns.
+   *
+   * @see APTelemetryLogger
+   */
+  Autopilot& WithTelemetry(APTelemetryRing* ring);
+
+  /**
+   * Attaches baked goal velocities, and returns itself. Pass nullptr to
+   * detach. Targets prepared afterwards that the field has a grid for, and
+   * whose goal velocity the field was baked with this profile for, take
+   * their goal velocity from the grid on the swirly path. The field must
+   * outlive every target prepared with it.
+   *
+   * @see APVelocityField
+   */
+  Autopilot& WithVelocityField(const APVelocityField* field);
+
   /**
    * Returns the next field relative velocity for the trajectory
    *
@@ -58,59 +151,327 @@ class Autopilot {
    */
   APResult Calculate(const frc::Pose2d& current,
                      const frc::Translation2d& velocity,
-                     const APTarget& target);
+                     const APTarget& target) noexcept;
+
   /**
-   * Returns whether the given pose is within tolerance for the target
+   * Returns the next field relative velocity for the trajectory, limiting the
+   * change in velocity by the time that actually elapsed since the previous
+   * call instead of the configured period.
+   *
+   * @param current The robot's current position.
+   * @param velocity The robot's current <b>field relative</b> velocity.
+   * @param target The target the robot should drive towards.
+   * @param dt The time elapsed since the previous call. Non-positive values
+   * fall back to the configured period.
    */
-  bool AtTarget(const frc::Pose2d& current, const APTarget& target);
+  APResult Calculate(const frc::Pose2d& current,
+                     const frc::Translation2d& velocity,
+                     const APTarget& target, units::second_t dt) noexcept;
 
- private:
-  APProfile m_profile;
-  static constexpr units::second_t dt = 20_ms;
+  /**
+   * Returns the next field relative velocity and angular velocity for the
+   * trajectory.
+   *
+   * When the profile's constraints enable the rotational profile, omega in
+   * the result drives the heading towards targetAngle along the shortest
+   * path. Its goal follows the same jerk limited shape as translation,
+   * cbrt(4.5 * jerk * error^2) capped at the angular velocity limit, and it
+   * changes from the measured angular velocity by at most the angular
+   * acceleration limit times dt.
+   *
+   * The overloads taking a Translation2d have no measured angular velocity,
+   * and treat the robot as not rotating. Robots using the rotational profile
+   * should pass their measured ChassisSpeeds instead.
+   *
+   * @param current The robot's current position.
+   * @param velocity The robot's current <b>field relative</b> velocity,
+   * including its angular velocity.
+   * @param target The target the robot should drive towards.
+   * @param dt The time elapsed since the previous call. Non-positive values,
+   * including the default, fall back to the configured period.
+   */
+  APResult Calculate(const frc::Pose2d& current,
+                     const frc::ChassisSpeeds& velocity,
+                     const APTarget& target, units::second_t dt = 0_s) noexcept;
 
   /**
-   * Turns any other coordinate frame into a coordinate frame with positive x
-   * meaning in the direction of the target's entry angle, if applicable
-   * (otherwise no change to angles).
+   * Returns the next field relative velocity and angular velocity for the
+   * trajectory towards a prepared target.
+   *
+   * @see Calculate(const frc::Pose2d&, const frc::ChassisSpeeds&,
+   * const APTarget&, units::second_t)
    */
-  frc::Translation2d ToTargetCoordinateFrame(const frc::Translation2d& coords,
-                                             const APTarget& target);
+  APResult Calculate(const frc::Pose2d& current,
+                     const frc::ChassisSpeeds& velocity,
+                     const APPreparedTarget& target,
+                     units::second_t dt = 0_s) noexcept;
+
   /**
-   * Turns a translation from a target-relative coordinate frame to a global
-   * coordinate frame.
+   * Returns the same result as Calculate for the same inputs, without
+   * recording it to telemetry.
+   *
+   * Every Calculate call that is not timestamped is a pure function of its
+   * inputs, so looking ahead never disturbs the robot's own calls. Rollouts,
+   * estimates and other look ahead should use Preview so that telemetry only
+   * records the commands the robot was actually sent.
+   *
+   * @see Calculate(const frc::Pose2d&, const frc::ChassisSpeeds&,
+   * const APTarget&, units::second_t)
    */
-  frc::Translation2d ToGlobalCoordinateFrame(const frc::Translation2d& coords,
-                                             const APTarget& target);
+  APResult Preview(const frc::Pose2d& current,
+                   const frc::ChassisSpeeds& velocity,
+                   const APPreparedTarget& target,
+                   units::second_t dt = 0_s) const noexcept;
+
   /**
-   * Determines the maximum velocity required to travel the given distance and
-   * end at the desired end velocity.
+   * Returns the next field relative velocity and angular velocity for the
+   * trajectory, starting from a pose that was measured in the past.
+   *
+   * The pose is first predicted forward to now with PredictPose, and the
+   * control law is evaluated on the predicted pose. The result is then
+   * remembered as the command in effect from now on, for predicting later
+   * poses. Only these overloads add to the command history, so a robot
+   * whose poses are stale should call them every tick.
+   *
+   * @param measured The robot's pose and when it was measured.
+   * @param velocity The robot's current <b>field relative</b> velocity,
+   * including its angular velocity.
+   * @param target The target the robot should drive towards.
+   * @param now The current time, on the same clock as the pose's timestamp.
+   * @param dt The time elapsed since the previous call. Non-positive values,
+   * including the default, fall back to the configured period.
    */
-  units::meters_per_second_t CalculateMaxVelocity(
-      units::meter_t dist, units::meters_per_second_t endVelo);
+  APResult Calculate(const APTimestampedPose& measured,
+                     const frc::ChassisSpeeds& velocity,
+                     const APTarget& target, units::second_t now,
+                     units::second_t dt = 0_s) noexcept;
+
   /**
-   * Attempts to drive the initial translation to the goal translation using the
-   * parameters for acceleration given in the profile.
+   * Returns the next field relative velocity and angular velocity for the
+   * trajectory towards a prepared target, starting from a pose that was
+   * measured in the past.
+   *
+   * @see Calculate(const APTimestampedPose&, const frc::ChassisSpeeds&,
+   * const APTarget&, units::second_t, units::second_t)
    */
-  frc::Translation2d Correct(const frc::Translation2d& initial,
-                             const frc::Translation2d& goal);
+  APResult Calculate(const APTimestampedPose& measured,
+                     const frc::ChassisSpeeds& velocity,
+                     const APPreparedTarget& target, units::second_t now,
+                     units::second_t dt = 0_s) noexcept;
+
   /**
-   * Using the provided acceleration, "pushes" the start point towards the end
-   * point.
+   * Predicts where the robot is now from a pose measured in the past.
+   *
+   * The robot is assumed to have moved at the velocity of the most recent
+   * command in the history at every instant between the measurement and
+   * now. Where the history does not reach back far enough, or is empty, the
+   * given velocity is used instead. The heading follows the commanded
+   * angular velocity when the rotational profile is enabled, and the given
+   * angular velocity otherwise. Poses from the future are returned as is.
    *
-   * This is used for ensuring that changes in velocity are withing the
-   * acceleration threshold
+   * @param measured The robot's pose and when it was measured.
+   * @param velocity The robot's current <b>field relative</b> velocity,
+   * including its angular velocity.
+   * @param now The current time, on the same clock as the pose's timestamp.
    */
-  double Push(double start, double end,
-              units::meters_per_second_squared_t accel);
+  frc::Pose2d PredictPose(const APTimestampedPose& measured,
+                          const frc::ChassisSpeeds& velocity,
+                          units::second_t now) const noexcept;
+
   /**
-   * Uses the swirly method to calculate the correct velocities for the robot,
-   * respecting entry angles
+   * Forgets every remembered command, for example when the robot is
+   * enabled or another controller has been driving it.
+   */
+  void ClearCommandHistory();
+
+  /**
+   * Returns the next field relative velocity for the trajectory towards a
+   * target prepared with Prepare. Results are identical to passing the
+   * original APTarget, but the per-tick path skips the entry angle
+   * trigonometry and the optional checks.
+   *
+   * @param current The robot's current position.
+   * @param velocity The robot's current <b>field relative</b> velocity.
+   * @param target The prepared target the robot should drive towards.
+   */
+  APResult Calculate(const frc::Pose2d& current,
+                     const frc::Translation2d& velocity,
+                     const APPreparedTarget& target) noexcept;
+
+  /**
+   * Returns the next field relative velocity for the trajectory towards a
+   * prepared target, limiting the change in velocity by the measured time
+   * since the previous call.
+   *
+   * @param current The robot's current position.
+   * @param velocity The robot's current <b>field relative</b> velocity.
+   * @param target The prepared target the robot should drive towards.
+   * @param dt The time elapsed since the previous call. Non-positive values
+   * fall back to the configured period.
+   */
+  APResult Calculate(const frc::Pose2d& current,
+                     const frc::Translation2d& velocity,
+                     const APPreparedTarget& target,
+                     units::second_t dt) noexcept;
+
+  /**
+   * Estimates how long this autopilot will take to drive from the given state
+   * to the target.
+   *
+   * The estimate follows the same model as Calculate: the path length is the
+   * straight line or swirly arc length to the target, the speed along it
+   * rises from the current speed at the acceleration limit until it meets
+   * the jerk limited profile from CalculateMaxVelocity, and then follows that
+   * profile, capped at the velocity constraint, until the robot is within the
+   * profile's translation tolerance. Moving away from the target adds the
+   * time and distance needed to brake. The profile segment is integrated in
+   * closed form and the meeting point is found with a fixed number of
+   * bisection steps, so the cost is constant. The braking cap of a
+   * deceleration limit and the axis velocity limits are not modelled, so
+   * with those set the estimate is optimistic.
+   *
+   * Against closed loop rollouts with a perfectly tracking drivetrain the
+   * estimate is within 3% plus one control period. The exception is a robot
+   * starting within 30 degrees of directly behind an entry angle, where the
+   * swirly path can fold either way around the target; there the estimate
+   * may be off by up to 60%.
+   *
+   * Returns infinity if the profile can never reach the target, for example
+   * with zero acceleration from rest.
+   *
+   * @param current The robot's current position.
+   * @param velocity The robot's current <b>field relative</b> velocity.
+   * @param target The target the robot should drive towards.
+   */
+  units::second_t EstimateTimeToTarget(
+      const frc::Pose2d& current, const frc::Translation2d& velocity,
+      const APTarget& target) const noexcept;
+
+  /**
+   * Estimates how long this autopilot will take to drive from the given state
+   * to a prepared target.
+   *
+   * @see EstimateTimeToTarget(const frc::Pose2d&, const frc::Translation2d&,
+   * const APTarget&)
+   */
+  units::second_t EstimateTimeToTarget(
+      const frc::Pose2d& current, const frc::Translation2d& velocity,
+      const APPreparedTarget& target) const noexcept;
+
+  /**
+   * Returns a lower bound on EstimateTimeToTarget for any target the given
+   * straight line distance away with at most the given end velocity.
+   *
+   * This is the time needed to follow the velocity profile over that
+   * distance, which no starting velocity or path shape can beat. It is
+   * increasing in distance, so it can be used to prune candidate targets.
+   */
+  units::second_t MinimumTimeToTarget(
+      units::meter_t distance,
+      units::meters_per_second_t endVelocity) const noexcept;
+
+  /**
+   * Prepares a target against this autopilot's profile. The result stays
+   * valid for as long as this autopilot's profile does.
+   */
+  APPreparedTarget Prepare(const APTarget& target) const noexcept;
+
+  /**
+   * Computes the next field relative velocity for many robot/target pairs at
+   * once. State i is driven towards target i and its result is written to
+   * out[i]. Every pair is advanced by the configured period. States without
+   * an omega span are treated as not rotating. Only as many pairs as the
+   * shortest of the state batch, the target batch and out are computed; the
+   * rest of out is left untouched.
    *
-   * @param offset The offset from the robot to the target, in the target's
-   * coordinate frame
+   * The pairs go through core::CalculateBatch a block at a time, which runs
+   * the same control law as the scalar Calculate step by step over all the
+   * pairs in the block. The outputs agree with the scalar Calculate to
+   * within 1e-9 for the same inputs. The batch never looks up baked goal
+   * velocities: with a velocity field attached, every goal is computed
+   * exactly, as the scalar Calculate does for targets without a grid.
+   *
+   * @param states The robots' current poses and <b>field relative</b>
+   * velocities.
+   * @param targets The targets, one per state.
+   * @param out Storage for the results, one per state.
+   */
+  void Calculate(const APStateBatch& states, const APTargetBatch& targets,
+                 std::span<APResult> out) noexcept;
+
+  /**
+   * Returns whether the given pose is within tolerance for the target
+   */
+  bool AtTarget(const frc::Pose2d& current,
+                const APTarget& target) const noexcept;
+
+ private:
+  friend struct APBenchAccess;
+  friend class APVelocityField;
+
+  APProfile m_profile;
+  // The profile for the core control law, along with the period and math
+  // mode
+  core::Limits m_limits;
+  // The ring receiving a record of every scalar Calculate call, if any.
+  // Calculate counts itself in recording while it records, which detaching
+  // waits on. A ring takes records from one producer only, so copies of an
+  // Autopilot start detached and assignment keeps the attachment.
+  struct Telemetry {
+    std::atomic<APTelemetryRing*> ring{nullptr};
+    std::atomic<int> recording{0};
+
+    Telemetry() = default;
+    Telemetry(const Telemetry&) noexcept {}
+    Telemetry& operator=(const Telemetry&) noexcept { return *this; }
+  };
+  Telemetry m_telemetry;
+  // Baked goal velocities attached to prepared targets when set
+  const APVelocityField* m_velocityField = nullptr;
+
+  // Number of commands remembered for latency compensation. At the default
+  // period this reaches back 640 ms.
+  static constexpr size_t kCommandHistory = 32;
+
+  struct Command {
+    units::second_t time;
+    frc::ChassisSpeeds velocity;
+  };
+
+  // Oldest first, starting at m_commandStart
+  std::array<Command, kCommandHistory> m_commands;
+  size_t m_commandStart = 0;
+  size_t m_commandCount = 0;
+
+  /**
+   * Evaluates the control law, with non-positive dt already replaced by the
+   * period.
    */
-  frc::Translation2d CalculateSwirlyVelocity(const frc::Translation2d& offset,
-                                             const APTarget& target);
+  core::Result Evaluate(const frc::Pose2d& current,
+                        const frc::ChassisSpeeds& velocity,
+                        const APPreparedTarget& target,
+                        units::second_t dt) const noexcept;
+  /**
+   * Converts a result of the control law.
+   */
+  static APResult ToResult(const frc::Pose2d& current,
+                           const APPreparedTarget& target,
+                           const core::Result& out) noexcept;
+  /**
+   * Turns any other coordinate frame into a coordinate frame with positive x
+   * meaning in the direction of the target's entry angle, if applicable
+   * (otherwise no change to angles).
+   */
+  frc::Translation2d ToTargetCoordinateFrame(
+      const frc::Translation2d& coords,
+      const APPreparedTarget& target) const noexcept;
+  /**
+   * Determines the maximum velocity required to travel the given distance and
+   * end at the desired end velocity. With a deceleration limit set, this is
+   * also capped at the speed the robot can brake from within the distance.
+   */
+  units::meters_per_second_t CalculateMaxVelocity(
+      units::meter_t dist, units::meters_per_second_t endVelo) const noexcept;
   /**
    * Using a precomputed integral, returns the length of the path that the
    * swirly method generates.
@@ -120,12 +481,6 @@ class Autopilot {
    * state.
    */
   units::meter_t CalculateSwirlyLength(units::radian_t theta,
-                                       units::meter_t radius);
-  /**
-   * Returns the correct target heading for the current state
-   */
-  frc::Rotation2d GetRotationTarget(const frc::Rotation2d& current,
-                                    const APTarget& target,
-                                    units::meter_t dist);
+                                       units::meter_t radius) const noexcept;
 };
 }  // namespace autopilot
@@ -0,0 +1,89 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "target.h"
+
+namespace autopilot {
+/**
+ * A structure-of-arrays view over the states of many robots, used by the
+ * batched Autopilot::Calculate.
+ *
+ * Every span should hold the same number of elements, except omega, which
+ * may be left empty when the robots are not rotating. Spans of different
+ * lengths are cut down to the shortest of them. Positions are in meters,
+ * headings are in radians, velocities are <b>field relative</b> in meters
+ * per second and angular velocities are in radians per second.
+ */
+struct APStateBatch {
+  std::span<const double> x;
+  std::span<const double> y;
+  std::span<const double> heading;
+  std::span<const double> vx;
+  std::span<const double> vy;
+  std::span<const double> omega;
+
+  /**
+   * Returns the number of states in this batch: the length of the shortest
+   * span, ignoring an empty omega span.
+   */
+  size_t Size() const;
+};
+
+/**
+ * A structure-of-arrays collection of targets, prepared for the batched
+ * Autopilot::Calculate.
+ *
+ * Adding a target unpacks its optionals and stores the cosine and sine of its
+ * heading and entry angle, each in its own array.
+ */
+class APTargetBatch {
+ public:
+  APTargetBatch() = default;
+
+  /**
+   * Reserves storage for the given number of targets.
+   */
+  void Reserve(size_t count);
+
+  /**
+   * Appends a target to the end of this batch.
+   */
+  void Add(const APTarget& target);
+
+  /**
+   * Removes all targets from this batch, keeping the allocated storage.
+   */
+  void Clear();
+
+  /**
+   * Returns the number of targets in this batch.
+   */
+  size_t Size() const { return m_x.size(); }
+
+ private:
+  friend class Autopilot;
+
+  std::vector<double> m_x;
+  std::vector<double> m_y;
+  std::vector<double> m_cos;
+  std::vector<double> m_sin;
+  std::vector<double> m_entryCos;
+  std::vector<double> m_entrySin;
+  std::vector<uint8_t> m_hasEntry;
+  std::vector<double> m_velocity;
+  // Signed squares, infinity when the target has no rotation radius
+  std::vector<double> m_rotationRadiusSq;
+};
+}  // namespace autopilot
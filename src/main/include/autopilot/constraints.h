@@ -9,18 +9,42 @@
 #pragma once
 
 #include <units/acceleration.h>
+#include <units/angular_acceleration.h>
+#include <units/angular_velocity.h>
 #include <units/velocity.h>
 
+#include <limits>
+
 namespace autopilot {
 /**
  * A class that holds constraint information for an autopilot action.
  *
  * Constraints are max velocity, acceleration, and jerk.
+ *
+ * The rotational constraints are the same three limits for the robot's
+ * heading. They default to zero, which disables the rotational profile so
+ * that Autopilot only reports a target heading and leaves omega at zero.
+ *
+ * By default the acceleration limit only applies to the velocity along the
+ * direction Autopilot wants to drive in: any sideways velocity is dropped at
+ * once, and so is any speed above the goal. With the friction circle enabled
+ * the limit applies to the change of the whole velocity vector instead, so
+ * every commanded change is one the wheels can actually follow.
+ *
+ * The deceleration limit applies whenever the velocity is reduced, and also
+ * caps the approach speed so the robot can always stop in the remaining
+ * distance. It defaults to zero, which reuses the acceleration limit and
+ * leaves the approach speed to the jerk profile alone.
+ *
+ * The axis velocity limits are <b>robot relative</b>: velocityX caps the speed
+ * forwards and backwards, velocityY the speed sideways. A goal velocity
+ * breaking either is scaled down as a whole, so its direction is kept. They
+ * default to no limit.
  */
 class APConstraints {
  public:
   /** Creates a blank APConstraints with no limit on velocity */
-  APConstraints();
+  APConstraints() = default;
 
   /**
    * Creates a new APConstraints with given max velocity, acceleration, and
@@ -51,8 +75,55 @@ class APConstraints {
    */
   APConstraints& withJerk(double newJerk);
 
-  units::meters_per_second_t velocity;
-  units::meters_per_second_squared_t acceleration;
-  double jerk;  // Linear jerk in m/s^3
+  /**
+   * Modifies this constraint's max deceleration value and returns itself.
+   * Zero uses the acceleration limit for braking too.
+   */
+  APConstraints& withDeceleration(
+      units::meters_per_second_squared_t newDeceleration);
+
+  /**
+   * Modifies this constraint's robot relative max velocities along the
+   * robot's forward and sideways axes and returns itself.
+   */
+  APConstraints& withAxisVelocity(units::meters_per_second_t newVelocityX,
+                                  units::meters_per_second_t newVelocityY);
+
+  /**
+   * Modifies this constraint's max angular velocity and returns itself.
+   */
+  APConstraints& withRotationVelocity(
+      units::radians_per_second_t newRotationVelocity);
+
+  /**
+   * Modifies this constraint's max angular acceleration and returns itself.
+   */
+  APConstraints& withRotationAcceleration(
+      units::radians_per_second_squared_t newRotationAcceleration);
+
+  /**
+   * Modifies this constraint's max angular jerk and returns itself.
+   */
+  APConstraints& withRotationJerk(double newRotationJerk);
+
+  /**
+   * Modifies whether the acceleration limit applies to the whole velocity
+   * vector and returns itself.
+   */
+  APConstraints& withFrictionCircle(bool newFrictionCircle = true);
+
+  units::meters_per_second_t velocity{std::numeric_limits<double>::max()};
+  units::meters_per_second_squared_t acceleration{0.0};
+  double jerk = 0.0;  // Linear jerk in m/s^3
+  units::meters_per_second_squared_t deceleration{0.0};
+  // Robot relative, forwards
+  units::meters_per_second_t velocityX{std::numeric_limits<double>::max()};
+  // Robot relative, sideways
+  units::meters_per_second_t velocityY{std::numeric_limits<double>::max()};
+  units::radians_per_second_t rotationVelocity{
+      std::numeric_limits<double>::max()};
+  units::radians_per_second_squared_t rotationAcceleration{0.0};
+  double rotationJerk = 0.0;  // Angular jerk in rad/s^3
+  bool frictionCircle = false;
 };
 }  // namespace autopilot
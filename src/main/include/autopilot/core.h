@@ -0,0 +1,1007 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+#include "fastmath.h"
+#include "scalar.h"
+
+// The core's stage trace points time only in full builds with
+// AUTOPILOT_TRACE, which link trace.cpp. Built with AUTOPILOT_CORE_ONLY they
+// compile to nothing, so the core never needs the trace implementation.
+#if defined(AUTOPILOT_TRACE) && !defined(AUTOPILOT_CORE_ONLY)
+#include "trace.h"
+#define AP_CORE_TRACE_STAGE(stage) AP_TRACE_STAGE(stage)
+#else
+#define AP_CORE_TRACE_STAGE(stage) static_cast<void>(0)
+#endif
+
+namespace autopilot {
+/**
+ * The Autopilot control law over plain scalars.
+ *
+ * Everything here is header only and depends on nothing but the standard
+ * library, so the controller can be embedded in a program without WPILib or
+ * the HAL, such as a coprocessor service, and built with any C++20
+ * compiler. Define AUTOPILOT_CORE_ONLY in such builds to keep the trace
+ * points out even when AUTOPILOT_TRACE is defined. Values are meters,
+ * radians and seconds throughout, and every vector is field relative unless
+ * stated otherwise.
+ *
+ * The control law is generic over its scalar type T: double, float, or the
+ * Q16.16 Fixed for processors without a floating point unit. Vector, Pose,
+ * Target, Result and the rest name the double instantiations; prepare and
+ * fold in double, then Cast the target and Fold<T> the profile for another
+ * type. See scalar.h for the error of each type against double.
+ *
+ * Autopilot is a thin adapter over these functions: it converts the WPILib
+ * geometry and units types at the boundary, and adds the command history,
+ * telemetry and velocity field lookup on top. Its results are the ones
+ * computed here.
+ */
+namespace core {
+/**
+ * Returns the cube root of x, usable in constant expressions. At run time it
+ * is std::cbrt.
+ */
+constexpr double Cbrt(double x) {
+  if (!std::is_constant_evaluated()) {
+    return std::cbrt(x);
+  }
+  if (x < 0.0) {
+    return -Cbrt(-x);
+  }
+  if (x == 0.0 || x != x || x > std::numeric_limits<double>::max()) {
+    return x;
+  }
+  // Newton's method from above converges monotonically, so stop as soon as
+  // an iterate fails to decrease
+  double y = x > 1.0 ? x : 1.0;
+  for (int i = 0; i < 2000; ++i) {
+    double next = y - (y * y * y - x) / (3.0 * y * y);
+    if (!(next < y)) {
+      break;
+    }
+    y = next;
+  }
+  return y;
+}
+
+/**
+ * The limits and tolerances of a controller.
+ *
+ * The fields mirror APProfile and APConstraints, along with the control loop
+ * period and the math mode. The rotational limits default to zero, which
+ * disables the rotational profile, and the deceleration to zero, which
+ * reuses the acceleration for braking.
+ */
+struct Profile {
+  double velocity = std::numeric_limits<double>::max();  // m/s
+  double acceleration = 0.0;                             // m/s^2
+  double jerk = 0.0;                                     // m/s^3
+  double errorXY = 0.0;                                  // m
+  double errorTheta = 0.0;                               // rad
+  double beelineRadius = 0.0;                            // m
+  double period = 0.02;                                  // s
+  double rotationVelocity = std::numeric_limits<double>::max();  // rad/s
+  double rotationAcceleration = 0.0;                             // rad/s^2
+  double rotationJerk = 0.0;                                     // rad/s^3
+  APMathMode mathMode = APMathMode::kExact;
+  bool frictionCircle = false;
+  double deceleration = 0.0;                              // m/s^2
+  double velocityX = std::numeric_limits<double>::max();  // m/s
+  double velocityY = std::numeric_limits<double>::max();  // m/s
+};
+
+namespace detail {
+// Converts a double to T, saturating finite values beyond its range rather
+// than overflowing
+template <typename T>
+constexpr T Narrow(double value) {
+  if constexpr (std::is_floating_point_v<T>) {
+    constexpr double kMax = static_cast<double>(std::numeric_limits<T>::max());
+    constexpr double kInfinity = std::numeric_limits<double>::infinity();
+    if (value > kMax && value < kInfinity) {
+      return std::numeric_limits<T>::max();
+    }
+    if (value < -kMax && value > -kInfinity) {
+      return std::numeric_limits<T>::lowest();
+    }
+  }
+  return static_cast<T>(value);
+}
+
+template <typename To, typename From>
+constexpr To Convert(From value) {
+  if constexpr (std::is_floating_point_v<From>) {
+    return Narrow<To>(static_cast<double>(value));
+  } else {
+    return static_cast<To>(value);
+  }
+}
+
+// A threshold of the given size, but never below the smallest positive T
+template <typename T>
+constexpr T Threshold(double value) {
+  return std::max(Narrow<T>(value), std::numeric_limits<T>::min());
+}
+
+// Infinity, or the largest T for types without one
+template <typename T>
+constexpr T Unbounded() {
+  if constexpr (std::numeric_limits<T>::has_infinity) {
+    return std::numeric_limits<T>::infinity();
+  } else {
+    return std::numeric_limits<T>::max();
+  }
+}
+}  // namespace detail
+
+/**
+ * A profile along with the quantities the control law derives from it,
+ * folded once by Fold. None of them depend on the period or the math mode,
+ * so those may be changed in place.
+ *
+ * @tparam T The scalar type the control law computes in.
+ */
+template <typename T>
+struct BasicLimits {
+  Profile profile;
+  /** cbrt(4.5 * jerk), the scale of the jerk limited speed profile. */
+  T jerkFactor{};
+  /** cbrt(4.5 * rotationJerk), the scale of the angular speed profile. */
+  T rotationJerkFactor{};
+  /** The deceleration if one is set, otherwise the acceleration. */
+  T braking{};
+  /** Whether a separate deceleration limit is set. */
+  bool decelerating = false;
+  /** Whether either robot relative axis velocity is limited. */
+  bool axisLimited = false;
+  /** Whether the rotational profile is enabled. */
+  bool rotating = false;
+  /**
+   * The profile's limits converted to T, so that the control law never
+   * converts from double.
+   */
+  T velocity{};
+  T acceleration{};
+  T deceleration{};
+  T velocityX{};
+  T velocityY{};
+  T rotationVelocity{};
+  T rotationAcceleration{};
+};
+
+using Limits = BasicLimits<double>;
+
+/**
+ * Returns the limits for the given profile, computing in T.
+ */
+template <typename T = double>
+constexpr BasicLimits<T> Fold(const Profile& profile) {
+  const bool decelerating = profile.deceleration > 0.0;
+  return BasicLimits<T>{
+      .profile = profile,
+      .jerkFactor = detail::Narrow<T>(Cbrt(4.5 * profile.jerk)),
+      .rotationJerkFactor =
+          detail::Narrow<T>(Cbrt(4.5 * profile.rotationJerk)),
+      .braking = detail::Narrow<T>(decelerating ? profile.deceleration
+                                                : profile.acceleration),
+      .decelerating = decelerating,
+      .axisLimited = profile.velocityX < std::numeric_limits<double>::max() ||
+                     profile.velocityY < std::numeric_limits<double>::max(),
+      .rotating =
+          profile.rotationAcceleration > 0.0 && profile.rotationJerk > 0.0,
+      .velocity = detail::Narrow<T>(profile.velocity),
+      .acceleration = detail::Narrow<T>(profile.acceleration),
+      .deceleration = detail::Narrow<T>(profile.deceleration),
+      .velocityX = detail::Narrow<T>(profile.velocityX),
+      .velocityY = detail::Narrow<T>(profile.velocityY),
+      .rotationVelocity = detail::Narrow<T>(profile.rotationVelocity),
+      .rotationAcceleration = detail::Narrow<T>(profile.rotationAcceleration)};
+}
+
+template <typename T>
+struct BasicVector {
+  T x{};
+  T y{};
+};
+
+/**
+ * A heading, stored as the cosine and sine of its angle.
+ */
+template <typename T>
+struct BasicRotation {
+  T cos{1};
+  T sin{};
+};
+
+template <typename T>
+struct BasicPose {
+  T x{};
+  T y{};
+  BasicRotation<T> rotation;
+};
+
+/**
+ * A field relative velocity, with the angular velocity in rad/s.
+ */
+template <typename T>
+struct BasicVelocity {
+  T vx{};
+  T vy{};
+  T omega{};
+};
+
+using Vector = BasicVector<double>;
+using Rotation = BasicRotation<double>;
+using Pose = BasicPose<double>;
+using Velocity = BasicVelocity<double>;
+
+/**
+ * Baked goal velocities around one target, as described by APFieldRecord.
+ * The samples are not owned.
+ */
+struct FieldGrid {
+  double extent = 0.0;  // m
+  size_t size = 0;      // Samples per side
+  double cellSize = 0.0;
+  double inverseCellSize = 0.0;
+  // Offsets closer than this are computed exactly
+  double guardSq = 0.0;
+  const float* samples = nullptr;
+};
+
+/**
+ * A target prepared against a profile, as in APPreparedTarget.
+ *
+ * A missing entry angle is an infinite beeline radius and a missing rotation
+ * radius an infinite rotation radius, so the control law never branches on
+ * whether they were set. For types without an infinity, such as Fixed, the
+ * largest value stands in. Build one with Prepare.
+ */
+template <typename T>
+struct BasicTarget {
+  BasicPose<T> reference;
+  T velocity{};  // End velocity, m/s
+  T entryCos{1};
+  T entrySin{};
+  T beelineRadiusSq = detail::Unbounded<T>();
+  T rotationRadiusSq = detail::Unbounded<T>();
+  // Baked goal velocities, if any. Only floating point types use them.
+  const FieldGrid* field = nullptr;
+};
+
+using Target = BasicTarget<double>;
+
+/**
+ * Which part of the control law produced a result.
+ */
+enum class Branch : uint8_t {
+  /** The robot was exactly on the target, so the result is zero. */
+  kArrived,
+  /** The robot drove straight at the target. */
+  kBeeline,
+  /** The robot followed the swirly path towards the entry angle. */
+  kSwirly,
+  /**
+   * The robot followed the swirly path, with the goal velocity looked up in
+   * a FieldGrid.
+   */
+  kBaked
+};
+
+template <typename T>
+struct BasicResult {
+  T vx{};  // m/s
+  T vy{};  // m/s
+  /**
+   * The heading to hold: the target's within its rotation radius, otherwise
+   * the robot's current heading.
+   */
+  BasicRotation<T> heading;
+  /** Whether heading is the target's. */
+  bool facesTarget = true;
+  /**
+   * Angular velocity towards heading, or zero without a rotational profile.
+   */
+  T omega{};  // rad/s
+  Branch branch = Branch::kArrived;
+  /** Distance to the target when the branch was chosen. */
+  T disp{};  // m
+};
+
+using Result = BasicResult<double>;
+
+/**
+ * Converts a vector to another scalar type. Conversions from floating point
+ * saturate at the ends of the new type's range.
+ */
+template <typename To, typename From>
+constexpr BasicVector<To> Cast(const BasicVector<From>& v) {
+  return BasicVector<To>{detail::Convert<To>(v.x), detail::Convert<To>(v.y)};
+}
+
+template <typename To, typename From>
+constexpr BasicRotation<To> Cast(const BasicRotation<From>& rotation) {
+  return BasicRotation<To>{detail::Convert<To>(rotation.cos),
+                           detail::Convert<To>(rotation.sin)};
+}
+
+template <typename To, typename From>
+constexpr BasicPose<To> Cast(const BasicPose<From>& pose) {
+  return BasicPose<To>{detail::Convert<To>(pose.x),
+                       detail::Convert<To>(pose.y),
+                       Cast<To>(pose.rotation)};
+}
+
+template <typename To, typename From>
+constexpr BasicVelocity<To> Cast(const BasicVelocity<From>& velocity) {
+  return BasicVelocity<To>{detail::Convert<To>(velocity.vx),
+                           detail::Convert<To>(velocity.vy),
+                           detail::Convert<To>(velocity.omega)};
+}
+
+template <typename To, typename From>
+constexpr BasicTarget<To> Cast(const BasicTarget<From>& target) {
+  return BasicTarget<To>{
+      .reference = Cast<To>(target.reference),
+      .velocity = detail::Convert<To>(target.velocity),
+      .entryCos = detail::Convert<To>(target.entryCos),
+      .entrySin = detail::Convert<To>(target.entrySin),
+      .beelineRadiusSq = detail::Convert<To>(target.beelineRadiusSq),
+      .rotationRadiusSq = detail::Convert<To>(target.rotationRadiusSq),
+      .field = target.field};
+}
+
+template <typename To, typename From>
+constexpr BasicResult<To> Cast(const BasicResult<From>& result) {
+  return BasicResult<To>{.vx = detail::Convert<To>(result.vx),
+                         .vy = detail::Convert<To>(result.vy),
+                         .heading = Cast<To>(result.heading),
+                         .facesTarget = result.facesTarget,
+                         .omega = detail::Convert<To>(result.omega),
+                         .branch = result.branch,
+                         .disp = detail::Convert<To>(result.disp)};
+}
+
+namespace detail {
+// Translation2d compares components with this tolerance
+inline constexpr double kZeroOffset = 1e-9;
+// Below this magnitude Rotation2d treats a vector as having no direction.
+// Such vectors are given no direction here, which is what Rotation2d falls
+// back to.
+inline constexpr double kMinDirection = 1e-6;
+
+// Keeps the sign, so that a negative radius still compares below every
+// squared distance.
+constexpr double SignedSquare(double value) {
+  return value < 0.0 ? -(value * value) : value * value;
+}
+
+// x^(2/3) as the exact math mode computes it
+template <typename T>
+T ExactPow2Over3(T x) {
+  if constexpr (std::is_floating_point_v<T>) {
+    return scalar::Cbrt(x * x);
+  } else {
+    return scalar::Pow2Over3(x);
+  }
+}
+}  // namespace detail
+
+/**
+ * Prepares a target at the given reference pose against a profile.
+ *
+ * Targets for other scalar types are prepared as doubles and then converted
+ * with Cast.
+ *
+ * @param velocity The end velocity, in m/s.
+ * @param entryAngle The entry angle, or nothing to drive straight at the
+ * target.
+ * @param rotationRadius The rotation radius in meters, or nothing to face
+ * the target's heading everywhere.
+ */
+inline Target Prepare(const Profile& profile, const Pose& reference,
+                      double velocity, std::optional<Rotation> entryAngle,
+                      std::optional<double> rotationRadius) noexcept {
+  Target target{.reference = reference, .velocity = velocity};
+  if (entryAngle) {
+    target.entryCos = entryAngle->cos;
+    target.entrySin = entryAngle->sin;
+    target.beelineRadiusSq = detail::SignedSquare(profile.beelineRadius);
+  }
+  if (rotationRadius) {
+    target.rotationRadiusSq = detail::SignedSquare(*rotationRadius);
+  }
+  return target;
+}
+
+/**
+ * Turns a field relative vector into the target's coordinate frame, in which
+ * positive x points along the entry angle.
+ */
+template <typename T>
+BasicVector<T> ToTargetFrame(const BasicVector<T>& v,
+                             const BasicTarget<T>& target) noexcept {
+  return BasicVector<T>{v.x * target.entryCos + v.y * target.entrySin,
+                        v.y * target.entryCos - v.x * target.entrySin};
+}
+
+/**
+ * Turns a vector in the target's coordinate frame back into a field relative
+ * one.
+ */
+template <typename T>
+BasicVector<T> ToGlobalFrame(const BasicVector<T>& v,
+                             const BasicTarget<T>& target) noexcept {
+  return BasicVector<T>{v.x * target.entryCos - v.y * target.entrySin,
+                        v.x * target.entrySin + v.y * target.entryCos};
+}
+
+/**
+ * Returns the angle from current to goal in radians, in (-pi, pi].
+ */
+template <typename T>
+T HeadingError(const BasicRotation<T>& goal,
+               const BasicRotation<T>& current) noexcept {
+  return scalar::Atan2(goal.sin * current.cos - goal.cos * current.sin,
+                       goal.cos * current.cos + goal.sin * current.sin);
+}
+
+/**
+ * "Pushes" the start point towards the end point by at most maxIncrease
+ * while moving away from zero and by at most maxDecrease while moving
+ * towards it. A push through zero spends the part of the step left after
+ * braking at the increase rate.
+ */
+template <typename T>
+T Push(T start, T end, T maxIncrease, T maxDecrease) noexcept {
+  const T change = end - start;
+  if (start * change >= T{}) {
+    // Speeding up, or starting from rest
+    if (scalar::Abs(change) < maxIncrease) {
+      return end;
+    }
+    return start + scalar::CopySign(maxIncrease, change);
+  }
+
+  // Braking, possibly through zero
+  if (scalar::Abs(change) < maxDecrease && start * end >= T{}) {
+    return end;
+  }
+  if (scalar::Abs(start) >= maxDecrease) {
+    return start + scalar::CopySign(maxDecrease, change);
+  }
+  // The robot stops part way through the step and speeds up for the rest
+  const T left = (T{1} - scalar::Abs(start) / maxDecrease) * maxIncrease;
+  return scalar::CopySign(std::min(left, scalar::Abs(end)), change);
+}
+
+/**
+ * Returns the speed at which to travel the given distance to end at the
+ * given end velocity, following the jerk limited profile. With a
+ * deceleration limit set, this is also capped at the speed the robot can
+ * brake from within the distance.
+ */
+template <typename T>
+T MaxVelocity(const BasicLimits<T>& limits, std::type_identity_t<T> dist,
+              std::type_identity_t<T> endVelocity) noexcept {
+  T velocity =
+      limits.jerkFactor * detail::ExactPow2Over3(dist) + endVelocity;
+  if constexpr (std::is_floating_point_v<T>) {
+    if (limits.profile.mathMode == APMathMode::kFast) {
+      velocity = limits.jerkFactor * fast::Pow2Over3(dist) + endVelocity;
+    }
+  }
+  if (!limits.decelerating) {
+    return velocity;
+  }
+  // Never approach faster than the robot can brake from within the distance
+  return std::min(velocity,
+                  scalar::Sqrt(endVelocity * endVelocity +
+                               T{2} * limits.deceleration * dist));
+}
+
+/**
+ * Returns the length of the path the swirly method generates from the given
+ * polar angle and radius: the arc length of r=theta from theta to zero,
+ * scaled to the radius.
+ *
+ * Fixed has no logarithm, so it always takes the fast math table, whose
+ * error is far below its resolution.
+ */
+template <typename T>
+T SwirlyLength(const BasicLimits<T>& limits, std::type_identity_t<T> theta,
+               std::type_identity_t<T> radius) noexcept {
+  if (theta == T{}) {
+    return radius;
+  }
+  theta = scalar::Abs(theta);
+  if constexpr (std::is_floating_point_v<T>) {
+    if (limits.profile.mathMode == APMathMode::kFast) {
+      return radius * fast::SwirlyScale(theta);
+    }
+    const T hypot = std::hypot(theta, T{1});
+    return T{0.5} *
+           (radius * hypot + radius * (std::log(theta + hypot) / theta));
+  } else {
+    return radius * fast::SwirlyScale(theta);
+  }
+}
+
+/**
+ * Returns the swirly goal velocity, in the target's coordinate frame, for
+ * the given offset from the robot to the target in that frame.
+ */
+template <typename T>
+BasicVector<T> SwirlyVelocity(const BasicLimits<T>& limits,
+                              const BasicVector<T>& offset,
+                              std::type_identity_t<T> endVelocity) noexcept {
+  const T disp = scalar::Hypot(offset.x, offset.y);
+  T c{1};
+  T s{};
+  if (disp > detail::Threshold<T>(detail::kMinDirection)) {
+    c = offset.x / disp;
+    s = offset.y / disp;
+  }
+  const T theta = scalar::Atan2(s, c);
+
+  // Tangent of r=theta at theta
+  const T sx = c - theta * s;
+  const T sy = theta * c + s;
+  const T norm = scalar::Hypot(sx, sy);
+  if (norm == T{}) {
+    return BasicVector<T>{};
+  }
+  const T speed = MaxVelocity(
+      limits, SwirlyLength(limits, theta, disp), endVelocity);
+  return BasicVector<T>{sx / norm * speed, sy / norm * speed};
+}
+
+/**
+ * Returns the goal velocity baked into the grid for the given offset in the
+ * target's coordinate frame, interpolated bilinearly, or nothing where the
+ * grid does not apply.
+ *
+ * @see APFieldGrid::Lookup
+ */
+inline std::optional<Vector> Lookup(const FieldGrid& grid,
+                                    const Vector& offset) noexcept {
+  const double ox = offset.x;
+  const double oy = offset.y;
+  if (ox * ox + oy * oy < grid.guardSq ||
+      (ox < 0.0 && std::abs(oy) < grid.cellSize)) {
+    return std::nullopt;
+  }
+
+  const double u = (ox + grid.extent) * grid.inverseCellSize;
+  const double v = (oy + grid.extent) * grid.inverseCellSize;
+  const double last = static_cast<double>(grid.size - 1);
+  // Written so that NaN offsets miss too
+  if (!(u >= 0.0 && v >= 0.0 && u < last && v < last)) {
+    return std::nullopt;
+  }
+
+  const size_t column = static_cast<size_t>(u);
+  const size_t row = static_cast<size_t>(v);
+  const double fu = u - column;
+  const double fv = v - row;
+  const float* below = grid.samples + 2 * (row * grid.size + column);
+  const float* above = below + 2 * grid.size;
+  return Vector{(1.0 - fv) * ((1.0 - fu) * below[0] + fu * below[2]) +
+                    fv * ((1.0 - fu) * above[0] + fu * above[2]),
+                (1.0 - fv) * ((1.0 - fu) * below[1] + fu * below[3]) +
+                    fv * ((1.0 - fu) * above[1] + fu * above[3])};
+}
+
+/**
+ * Scales the goal down so that its components along the robot's axes stay
+ * within the axis velocity limits. The heading is the robot's, in the same
+ * frame as the goal.
+ */
+template <typename T>
+BasicVector<T> LimitAxisVelocity(const BasicLimits<T>& limits,
+                                 const BasicVector<T>& goal,
+                                 const BasicRotation<T>& heading) noexcept {
+  // Components of the goal along the robot's forward and sideways axes
+  const T forward =
+      scalar::Abs(goal.x * heading.cos + goal.y * heading.sin);
+  const T sideways =
+      scalar::Abs(goal.y * heading.cos - goal.x * heading.sin);
+
+  T scale{1};
+  if (forward > limits.velocityX) {
+    scale = limits.velocityX / forward;
+  }
+  if (sideways * scale > limits.velocityY) {
+    scale = limits.velocityY / sideways;
+  }
+  return BasicVector<T>{goal.x * scale, goal.y * scale};
+}
+
+/**
+ * Drives the initial velocity towards the goal within the profile's limits
+ * over dt seconds.
+ *
+ * The goal is first scaled into the axis velocity limits. By default only
+ * the component along the goal is kept, capped at the velocity limit and
+ * pushed towards the goal by the acceleration or deceleration times dt.
+ * With the friction circle, the whole initial vector moves towards the
+ * capped goal by at most that much instead.
+ */
+template <typename T>
+BasicVector<T> Correct(const BasicLimits<T>& limits,
+                       const BasicVector<T>& initial,
+                       const BasicVector<T>& goal,
+                       const BasicRotation<T>& heading,
+                       std::type_identity_t<T> dt) noexcept {
+  BasicVector<T> limited =
+      limits.axisLimited ? LimitAxisVelocity(limits, goal, heading) : goal;
+
+  if (limits.profile.frictionCircle) {
+    const T speed = scalar::Hypot(limited.x, limited.y);
+    if (speed > limits.velocity) {
+      limited.x *= limits.velocity / speed;
+      limited.y *= limits.velocity / speed;
+    }
+    T changeX = limited.x - initial.x;
+    T changeY = limited.y - initial.y;
+    const T change = scalar::Hypot(changeX, changeY);
+    // A change against the current velocity slows the robot down
+    const bool braking = changeX * initial.x + changeY * initial.y < T{};
+    const T maxChange = (braking ? limits.braking : limits.acceleration) * dt;
+    if (change > maxChange) {
+      changeX *= maxChange / change;
+      changeY *= maxChange / change;
+    }
+    return BasicVector<T>{initial.x + changeX, initial.y + changeY};
+  }
+
+  T c{1};
+  T s{};
+  const T magnitude = scalar::Hypot(limited.x, limited.y);
+  if (magnitude > detail::Threshold<T>(detail::kMinDirection)) {
+    c = limited.x / magnitude;
+    s = limited.y / magnitude;
+  }
+  const T initialI = initial.x * c + initial.y * s;
+  const T goalI = std::min(limited.x * c + limited.y * s, limits.velocity);
+  const T adjusted =
+      std::min(goalI, Push(initialI, goalI, limits.acceleration * dt,
+                           limits.braking * dt));
+  return BasicVector<T>{adjusted * c, adjusted * s};
+}
+
+/**
+ * Returns the angular velocity that turns the robot through the given
+ * heading error over dt seconds, starting from the initial angular
+ * velocity, or zero without a rotational profile.
+ */
+template <typename T>
+T Omega(const BasicLimits<T>& limits, std::type_identity_t<T> error,
+        std::type_identity_t<T> initial,
+        std::type_identity_t<T> dt) noexcept {
+  if (!limits.rotating) {
+    return T{};
+  }
+  const T goal = scalar::CopySign(
+      std::min(limits.rotationVelocity,
+               limits.rotationJerkFactor * detail::ExactPow2Over3(error)),
+      error);
+  const T maxChange = limits.rotationAcceleration * dt;
+  T omega = Push(initial, goal, maxChange, maxChange);
+
+  // Like Correct, never spin faster than the profile allows in the direction
+  // of the goal
+  if (omega * goal > T{} && scalar::Abs(omega) > scalar::Abs(goal)) {
+    omega = goal;
+  }
+  return omega;
+}
+
+/**
+ * Computes the translational part of the control law over dt seconds: the
+ * field relative velocity and the heading to hold. Omega is left at zero.
+ */
+template <typename T>
+BasicResult<T> Translate(const BasicLimits<T>& limits,
+                         const BasicPose<T>& current,
+                         const BasicVector<T>& velocity,
+                         const BasicTarget<T>& target,
+                         std::type_identity_t<T> dt) noexcept {
+  BasicVector<T> offset;
+  BasicVector<T> initial;
+  BasicRotation<T> heading;
+  {
+    AP_CORE_TRACE_STAGE(kFrame);
+    offset = ToTargetFrame(BasicVector<T>{target.reference.x - current.x,
+                                          target.reference.y - current.y},
+                           target);
+    constexpr T kZeroOffset = detail::Threshold<T>(detail::kZeroOffset);
+    if (scalar::Abs(offset.x) < kZeroOffset &&
+        scalar::Abs(offset.y) < kZeroOffset) {
+      return BasicResult<T>{.heading = target.reference.rotation};
+    }
+
+    initial = ToTargetFrame(velocity, target);
+    heading = BasicRotation<T>{current.rotation.cos * target.entryCos +
+                                   current.rotation.sin * target.entrySin,
+                               current.rotation.sin * target.entryCos -
+                                   current.rotation.cos * target.entrySin};
+  }
+
+  BasicResult<T> result;
+  const T dispSq = offset.x * offset.x + offset.y * offset.y;
+  result.disp = scalar::Hypot(offset.x, offset.y);
+
+  BasicVector<T> goal;
+  {
+    AP_CORE_TRACE_STAGE(kGoal);
+    if (dispSq < target.beelineRadiusSq) {
+      result.branch = Branch::kBeeline;
+      const T speed = MaxVelocity(limits, result.disp, target.velocity);
+      goal = BasicVector<T>{offset.x / result.disp * speed,
+                            offset.y / result.disp * speed};
+    } else {
+      std::optional<BasicVector<T>> baked;
+      if constexpr (std::is_floating_point_v<T>) {
+        if (target.field) {
+          if (const std::optional<Vector> found =
+                  Lookup(*target.field, Cast<double>(offset))) {
+            baked = Cast<T>(*found);
+          }
+        }
+      }
+      result.branch = baked ? Branch::kBaked : Branch::kSwirly;
+      goal = baked ? *baked : SwirlyVelocity(limits, offset, target.velocity);
+    }
+  }
+
+  BasicVector<T> corrected;
+  {
+    AP_CORE_TRACE_STAGE(kCorrect);
+    corrected = Correct(limits, initial, goal, heading, dt);
+  }
+  const BasicVector<T> out = ToGlobalFrame(corrected, target);
+  result.vx = out.x;
+  result.vy = out.y;
+  {
+    AP_CORE_TRACE_STAGE(kRotation);
+    result.facesTarget = target.rotationRadiusSq > dispSq;
+    result.heading =
+        result.facesTarget ? target.reference.rotation : current.rotation;
+  }
+  return result;
+}
+
+/**
+ * Returns the next field relative velocity and angular velocity for the
+ * trajectory towards the target, limiting every change by dt seconds.
+ *
+ * @param current The robot's current pose.
+ * @param velocity The robot's current <b>field relative</b> velocity,
+ * including its angular velocity.
+ * @param target The target the robot should drive towards.
+ * @param dt The time elapsed since the previous call. Must be positive.
+ */
+template <typename T>
+BasicResult<T> Calculate(const BasicLimits<T>& limits,
+                         const BasicPose<T>& current,
+                         const BasicVelocity<T>& velocity,
+                         const BasicTarget<T>& target,
+                         std::type_identity_t<T> dt) noexcept {
+  BasicResult<T> result =
+      Translate(limits, current, BasicVector<T>{velocity.vx, velocity.vy},
+                target, dt);
+  if (limits.rotating) {
+    AP_CORE_TRACE_STAGE(kOmega);
+    result.omega =
+        Omega(limits, HeadingError(result.heading, current.rotation),
+              velocity.omega, dt);
+  }
+  return result;
+}
+
+/**
+ * A structure-of-arrays view over the states of many robots, with each
+ * heading stored as its cosine and sine. An empty omega span reads as zero.
+ */
+template <typename T>
+struct BasicStateLanes {
+  std::span<const T> x;
+  std::span<const T> y;
+  std::span<const T> cos;
+  std::span<const T> sin;
+  std::span<const T> vx;
+  std::span<const T> vy;
+  std::span<const T> omega;
+};
+
+/**
+ * A structure-of-arrays view over prepared targets, one BasicTarget field
+ * per span. There is no field grid: every goal is computed exactly.
+ */
+template <typename T>
+struct BasicTargetLanes {
+  std::span<const T> x;
+  std::span<const T> y;
+  std::span<const T> cos;
+  std::span<const T> sin;
+  std::span<const T> velocity;
+  std::span<const T> entryCos;
+  std::span<const T> entrySin;
+  std::span<const T> beelineRadiusSq;
+  std::span<const T> rotationRadiusSq;
+};
+
+/**
+ * Where CalculateBatch writes its results. facesTarget is nonzero where the
+ * heading to hold is the target's rather than the robot's.
+ */
+template <typename T>
+struct BasicResultLanes {
+  std::span<T> vx;
+  std::span<T> vy;
+  std::span<T> omega;
+  std::span<uint8_t> facesTarget;
+};
+
+using StateLanes = BasicStateLanes<double>;
+using TargetLanes = BasicTargetLanes<double>;
+using ResultLanes = BasicResultLanes<double>;
+
+namespace detail {
+// Lanes CalculateBatch carries through each step at a time. Its scratch
+// arrays for a block stay well within the L1 cache.
+inline constexpr size_t kBlock = 64;
+}  // namespace detail
+
+/**
+ * Runs Calculate for the first count lanes, driving state i towards target
+ * i. Every span except an empty state omega must hold at least count
+ * elements.
+ *
+ * Rather than running the whole control law lane by lane, each block of
+ * lanes goes through one step at a time: rotating into the target frames,
+ * the norms and polar angles, the swirly path lengths, the speeds, the
+ * goals, Correct, and the rotation back. Each loop calls the same
+ * primitives as Calculate over contiguous arrays, so the compiler can
+ * vectorize the arithmetic between them. The results agree with Calculate
+ * up to how the compiler contracts that arithmetic, well within 1e-9 in
+ * double.
+ */
+template <typename T>
+void CalculateBatch(const BasicLimits<T>& limits,
+                    const BasicStateLanes<T>& states,
+                    const BasicTargetLanes<T>& targets,
+                    const BasicResultLanes<T>& out, size_t count,
+                    std::type_identity_t<T> dt) noexcept {
+  using Block = std::array<T, detail::kBlock>;
+  constexpr T kZeroOffset = detail::Threshold<T>(detail::kZeroOffset);
+  constexpr T kMinDirection = detail::Threshold<T>(detail::kMinDirection);
+
+  for (size_t start = 0; start < count; start += detail::kBlock) {
+    const size_t n = std::min(detail::kBlock, count - start);
+    Block ox, oy, ix, iy, hc, hs, dispSq, disp, c, s, theta, speed, gx, gy;
+
+    // The offsets, velocities and headings in each target's frame
+    for (size_t k = 0; k < n; ++k) {
+      const size_t i = start + k;
+      const T ec = targets.entryCos[i];
+      const T es = targets.entrySin[i];
+      const T dx = targets.x[i] - states.x[i];
+      const T dy = targets.y[i] - states.y[i];
+      ox[k] = dx * ec + dy * es;
+      oy[k] = dy * ec - dx * es;
+      ix[k] = states.vx[i] * ec + states.vy[i] * es;
+      iy[k] = states.vy[i] * ec - states.vx[i] * es;
+      hc[k] = states.cos[i] * ec + states.sin[i] * es;
+      hs[k] = states.sin[i] * ec - states.cos[i] * es;
+      dispSq[k] = ox[k] * ox[k] + oy[k] * oy[k];
+    }
+
+    for (size_t k = 0; k < n; ++k) {
+      disp[k] = scalar::Hypot(ox[k], oy[k]);
+      const bool directed = disp[k] > kMinDirection;
+      c[k] = directed ? ox[k] / disp[k] : T{1};
+      s[k] = directed ? oy[k] / disp[k] : T{};
+    }
+
+    for (size_t k = 0; k < n; ++k) {
+      theta[k] = scalar::Atan2(s[k], c[k]);
+    }
+
+    // The distance left: straight within the beeline radius, otherwise
+    // along the swirly path
+    for (size_t k = 0; k < n; ++k) {
+      const size_t i = start + k;
+      speed[k] = dispSq[k] < targets.beelineRadiusSq[i]
+                     ? disp[k]
+                     : SwirlyLength(limits, theta[k], disp[k]);
+    }
+
+    for (size_t k = 0; k < n; ++k) {
+      speed[k] = MaxVelocity(limits, speed[k], targets.velocity[start + k]);
+    }
+
+    for (size_t k = 0; k < n; ++k) {
+      if (dispSq[k] < targets.beelineRadiusSq[start + k]) {
+        gx[k] = ox[k] / disp[k] * speed[k];
+        gy[k] = oy[k] / disp[k] * speed[k];
+        continue;
+      }
+      // Tangent of r=theta at theta, as in SwirlyVelocity
+      const T sx = c[k] - theta[k] * s[k];
+      const T sy = theta[k] * c[k] + s[k];
+      const T norm = scalar::Hypot(sx, sy);
+      gx[k] = norm == T{} ? T{} : sx / norm * speed[k];
+      gy[k] = norm == T{} ? T{} : sy / norm * speed[k];
+    }
+
+    for (size_t k = 0; k < n; ++k) {
+      const BasicVector<T> corrected =
+          Correct(limits, BasicVector<T>{ix[k], iy[k]},
+                  BasicVector<T>{gx[k], gy[k]},
+                  BasicRotation<T>{hc[k], hs[k]}, dt);
+      gx[k] = corrected.x;
+      gy[k] = corrected.y;
+    }
+
+    // Back to the field frame. Robots on their target stop and face it.
+    for (size_t k = 0; k < n; ++k) {
+      const size_t i = start + k;
+      const T ec = targets.entryCos[i];
+      const T es = targets.entrySin[i];
+      const bool arrived =
+          scalar::Abs(ox[k]) < kZeroOffset && scalar::Abs(oy[k]) < kZeroOffset;
+      out.vx[i] = arrived ? T{} : gx[k] * ec - gy[k] * es;
+      out.vy[i] = arrived ? T{} : gx[k] * es + gy[k] * ec;
+      out.facesTarget[i] = arrived || targets.rotationRadiusSq[i] > dispSq[k];
+    }
+
+    for (size_t k = 0; k < n; ++k) {
+      const size_t i = start + k;
+      if (!limits.rotating) {
+        out.omega[i] = T{};
+        continue;
+      }
+      const BasicRotation<T> current{states.cos[i], states.sin[i]};
+      const BasicRotation<T> heading =
+          out.facesTarget[i] ? BasicRotation<T>{targets.cos[i], targets.sin[i]}
+                             : current;
+      out.omega[i] =
+          Omega(limits, HeadingError(heading, current),
+                states.omega.empty() ? T{} : states.omega[i], dt);
+    }
+  }
+}
+
+/**
+ * Returns whether the given pose is within the profile's tolerances of the
+ * goal pose.
+ */
+inline bool AtTarget(const Profile& profile, const Pose& current,
+                     const Pose& goal) noexcept {
+  return std::hypot(current.x - goal.x, current.y - goal.y) <=
+             profile.errorXY &&
+         std::abs(HeadingError(goal.rotation, current.rotation)) <=
+             profile.errorTheta;
+}
+}  // namespace core
+}  // namespace autopilot
@@ -0,0 +1,197 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <type_traits>
+
+namespace autopilot {
+/**
+ * Selects how Autopilot evaluates its transcendental kernels.
+ *
+ * kExact uses the standard library. kFast swaps CalculateSwirlyLength and
+ * CalculateMaxVelocity for the approximations in autopilot::fast, trading a
+ * bounded relative error for a large reduction in cost on the roboRIO.
+ */
+enum class APMathMode { kExact, kFast };
+
+namespace fast {
+/**
+ * Maximum relative error of SwirlyScale over [0, pi].
+ */
+inline constexpr double kSwirlyScaleError = 1e-8;
+
+/**
+ * Maximum relative error of Pow2Over3 over all positive finite inputs.
+ */
+inline constexpr double kPow2Over3Error = 5e-10;
+
+namespace detail {
+inline constexpr int kSwirlyIntervals = 64;
+inline constexpr double kSwirlyStep = std::numbers::pi / kSwirlyIntervals;
+
+// sqrt, for positive finite x, and log, for positive normal x, usable in
+// constant expressions so that the tables below are built at compile time. At
+// run time they are the standard library's.
+constexpr double Sqrt(double x) {
+  if (!std::is_constant_evaluated()) {
+    return std::sqrt(x);
+  }
+  // Newton's method from above converges monotonically, so stop as soon as
+  // an iterate fails to decrease
+  double y = x > 1.0 ? x : 1.0;
+  while (true) {
+    const double next = 0.5 * (y + x / y);
+    if (!(next < y)) {
+      return y;
+    }
+    y = next;
+  }
+}
+
+constexpr double Log(double x) {
+  if (!std::is_constant_evaluated()) {
+    return std::log(x);
+  }
+  int exponent = 0;
+  while (x > std::numbers::sqrt2) {
+    x *= 0.5;
+    ++exponent;
+  }
+  while (x < 0.5 * std::numbers::sqrt2) {
+    x *= 2.0;
+    --exponent;
+  }
+  // log(x) = 2 * atanh(z), whose series converges quickly for |z| < 0.18
+  const double z = (x - 1.0) / (x + 1.0);
+  double power = z;
+  double sum = 0.0;
+  for (int n = 1; sum + power / n != sum; n += 2) {
+    sum += power / n;
+    power *= z * z;
+  }
+  return 2.0 * sum + exponent * std::numbers::ln2;
+}
+
+constexpr double ExactSwirlyScale(double t) {
+  if (t == 0.0) {
+    return 1.0;
+  }
+  if (!std::is_constant_evaluated()) {
+    return 0.5 * (std::hypot(t, 1.0) + std::asinh(t) / t);
+  }
+  const double h = Sqrt(t * t + 1.0);
+  return 0.5 * (h + Log(t + h) / t);
+}
+
+constexpr double ExactSwirlyScaleDerivative(double t) {
+  if (t == 0.0) {
+    return 0.0;
+  }
+  const double h = Sqrt(t * t + 1.0);
+  return 0.5 * (t / h + (t / h - Log(t + h)) / (t * t));
+}
+
+template <typename T>
+struct SwirlyKnot {
+  T value;
+  // Derivative pre-scaled by the step, as the Hermite basis wants it
+  T slope;
+};
+
+template <typename T>
+constexpr std::array<SwirlyKnot<T>, kSwirlyIntervals + 1> BuildSwirlyTable() {
+  std::array<SwirlyKnot<T>, kSwirlyIntervals + 1> knots{};
+  for (int i = 0; i <= kSwirlyIntervals; ++i) {
+    knots[i] = SwirlyKnot<T>{
+        static_cast<T>(ExactSwirlyScale(i * kSwirlyStep)),
+        static_cast<T>(ExactSwirlyScaleDerivative(i * kSwirlyStep) *
+                       kSwirlyStep)};
+  }
+  return knots;
+}
+
+// Built at compile time, so that no call pays for building it
+template <typename T>
+inline constexpr std::array<SwirlyKnot<T>, kSwirlyIntervals + 1>
+    kSwirlyTable = BuildSwirlyTable<T>();
+}  // namespace detail
+
+/**
+ * Returns the ratio between the arc length of r=theta from theta to zero and
+ * the straight line distance, 0.5 * (hypot(t, 1) + asinh(t) / t).
+ *
+ * Evaluated by cubic Hermite interpolation of a 64 interval table over
+ * [0, pi], which covers every angle produced by atan2. Larger inputs fall
+ * back to the exact expression.
+ *
+ * Any scalar type with the arithmetic operators and conversions to and from
+ * double and int works, such as float or core::Fixed. Each type gets its own
+ * table, converted from the double one at compile time.
+ *
+ * @param theta The absolute polar angle, in radians.
+ */
+template <typename T>
+T SwirlyScale(T theta) {
+  if (!(theta <= static_cast<T>(std::numbers::pi))) {
+    return static_cast<T>(
+        detail::ExactSwirlyScale(static_cast<double>(theta)));
+  }
+  const auto& table = detail::kSwirlyTable<T>;
+  const T x = theta * static_cast<T>(1.0 / detail::kSwirlyStep);
+  const int i = std::min(static_cast<int>(x), detail::kSwirlyIntervals - 1);
+  const T u = x - static_cast<T>(i);
+  const T v = static_cast<T>(1) - u;
+  const detail::SwirlyKnot<T>& a = table[i];
+  const detail::SwirlyKnot<T>& b = table[i + 1];
+  return v * v *
+             ((static_cast<T>(1) + static_cast<T>(2) * u) * a.value +
+              u * a.slope) +
+         u * u *
+             ((static_cast<T>(3) - static_cast<T>(2) * u) * b.value -
+              v * b.slope);
+}
+
+/**
+ * Returns x^(2/3) for x >= 0.
+ *
+ * Computes x * x^(-1/3), where the inverse cube root starts from an exponent
+ * bit estimate and is refined by three division free Newton steps.
+ */
+inline double Pow2Over3(double x) {
+  // Estimate of x^(-1/3) from the exponent bits, within 3.5%
+  constexpr uint64_t kMagic = 0x553ef1a9fbe76c00;
+  double r = std::bit_cast<double>(kMagic - std::bit_cast<uint64_t>(x) / 3);
+  // Each step roughly squares the relative error
+  r = r * (4.0 - x * r * r * r) * (1.0 / 3.0);
+  r = r * (4.0 - x * r * r * r) * (1.0 / 3.0);
+  r = r * (4.0 - x * r * r * r) * (1.0 / 3.0);
+  return x * r;
+}
+
+/**
+ * Returns x^(2/3) for x >= 0 in single precision, the same way as the double
+ * version. Its relative error is below 3e-7 for positive normal inputs.
+ */
+inline float Pow2Over3(float x) {
+  // Estimate of x^(-1/3) from the exponent bits, within 3.5%
+  constexpr uint32_t kMagic = 0x54a237fa;
+  float r = std::bit_cast<float>(kMagic - std::bit_cast<uint32_t>(x) / 3);
+  r = r * (4.0f - x * r * r * r) * (1.0f / 3.0f);
+  r = r * (4.0f - x * r * r * r) * (1.0f / 3.0f);
+  r = r * (4.0f - x * r * r * r) * (1.0f / 3.0f);
+  return x * r;
+}
+}  // namespace fast
+}  // namespace autopilot
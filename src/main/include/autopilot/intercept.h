@@ -0,0 +1,125 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include <frc/geometry/Pose2d.h>
+#include <frc/geometry/Translation2d.h>
+#include <frc/kinematics/ChassisSpeeds.h>
+#include <units/time.h>
+
+#include <optional>
+
+#include "autopilot.h"
+#include "moving_target.h"
+#include "target.h"
+
+namespace autopilot {
+/**
+ * Where and when an APInterceptor expects to meet a moving target.
+ */
+struct APIntercept {
+  /** The moving target as it will be at the meeting time. */
+  APTarget target;
+  /** The estimated time to reach it, from the call that solved it. */
+  units::second_t time;
+  /**
+   * Whether the time to reach the target matches the time it takes the
+   * target to get there, to within APInterceptor::kTolerance. Otherwise
+   * the target could not be caught within the horizon, and the solution is
+   * the best guess found.
+   */
+  bool converged;
+  /** Calls to Autopilot::EstimateTimeToTarget spent solving. */
+  int estimates;
+};
+
+/**
+ * Drives an Autopilot to intercept a moving target rather than chase it.
+ *
+ * Each tick it solves for the time t at which the autopilot's own estimate
+ * of the time to reach the target, as it will be after t, is t itself, and
+ * then drives towards the target as it will be then. Driving at where the
+ * target is now would trail behind it the whole way.
+ *
+ * The solve is a secant iteration on EstimateTimeToTarget(target.At(t)) - t,
+ * started from the previous tick's solution moved on by dt, so a steadily
+ * moving target usually needs one or two estimates per tick. The first solve,
+ * or one after Reset, starts from the time to reach where the target is now.
+ * Every solve makes at most kMaxEstimates estimates and never allocates.
+ *
+ * Against a target faster than the robot there may be no solution; the
+ * iteration then runs out to the horizon, and the autopilot drives towards
+ * where the target will be at the horizon.
+ */
+class APInterceptor {
+ public:
+  /** Largest number of estimates one solve makes. */
+  static constexpr int kMaxEstimates = 8;
+  /** How closely the two times must agree for a solve to converge. */
+  static constexpr units::second_t kTolerance = 1_ms;
+
+  APInterceptor() = delete;
+
+  /**
+   * Creates an interceptor driving the given autopilot, which must outlive
+   * it.
+   *
+   * @param horizon The furthest ahead to look for an intercept.
+   */
+  explicit APInterceptor(Autopilot& autopilot,
+                         units::second_t horizon = 5_s) noexcept;
+
+  /**
+   * Solves for the intercept of the given moving target from the given
+   * state, warm started from the previous solve.
+   *
+   * @param current The robot's current position.
+   * @param velocity The robot's current <b>field relative</b> velocity.
+   * @param target The moving target, as measured now.
+   * @param dt The time elapsed since the previous solve. Non-positive values,
+   * including the default, fall back to the autopilot's period.
+   */
+  APIntercept Solve(const frc::Pose2d& current,
+                    const frc::Translation2d& velocity,
+                    const APMovingTarget& target,
+                    units::second_t dt = 0_s) noexcept;
+
+  /**
+   * Solves for the intercept and returns the autopilot's next field relative
+   * velocity and angular velocity towards it.
+   *
+   * @param current The robot's current position.
+   * @param velocity The robot's current <b>field relative</b> velocity,
+   * including its angular velocity.
+   * @param target The moving target, as measured now.
+   * @param dt The time elapsed since the previous call. Non-positive values,
+   * including the default, fall back to the autopilot's period.
+   */
+  APResult Calculate(const frc::Pose2d& current,
+                     const frc::ChassisSpeeds& velocity,
+                     const APMovingTarget& target,
+                     units::second_t dt = 0_s) noexcept;
+
+  /**
+   * Returns the most recent solution, if any.
+   */
+  const std::optional<APIntercept>& Last() const noexcept;
+
+  /**
+   * Forgets the previous solution, for example when switching to another
+   * target, so that the next solve starts cold.
+   */
+  void Reset() noexcept;
+
+ private:
+  Autopilot& m_autopilot;
+  units::second_t m_horizon;
+  std::optional<APIntercept> m_last;
+};
+}  // namespace autopilot
@@ -0,0 +1,93 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include <frc/geometry/Pose2d.h>
+#include <frc/geometry/Translation2d.h>
+#include <units/time.h>
+
+#include <optional>
+
+#include "target.h"
+
+namespace autopilot {
+/**
+ * A target that moves across the field, such as a rolling game piece or a
+ * partner robot.
+ *
+ * It is an APTarget whose reference pose is where the target is now, along
+ * with the target's <b>field relative</b> velocity and, optionally, its
+ * acceleration. Both are assumed to hold for as long as it takes to reach
+ * the target. The entry angle, end velocity, rotation radius and heading of
+ * the wrapped target carry over to every point it moves through.
+ *
+ * Build a new one every tick from the latest measurement, and drive towards
+ * it with an APInterceptor.
+ */
+class APMovingTarget {
+ public:
+  APMovingTarget() = delete;
+
+  /**
+   * Creates a moving target from where the target is now and its velocity.
+   *
+   * @param target The target, with its reference pose where it is now.
+   * @param velocity The target's <b>field relative</b> velocity, in meters per
+   * second along each axis.
+   */
+  APMovingTarget(const APTarget& target,
+                 const frc::Translation2d& velocity) noexcept;
+
+  /**
+   * Returns a copy of this target with the given acceleration.
+   *
+   * @param acceleration The target's <b>field relative</b> acceleration, in
+   * meters per second squared along each axis.
+   */
+  [[nodiscard]]
+  APMovingTarget WithAcceleration(
+      const frc::Translation2d& acceleration) const noexcept;
+
+  /**
+   * Returns the target as it is now.
+   */
+  [[nodiscard]]
+  const APTarget& Target() const noexcept;
+
+  /**
+   * Returns the target's field relative velocity.
+   */
+  [[nodiscard]]
+  const frc::Translation2d& Velocity() const noexcept;
+
+  /**
+   * Returns the target's field relative acceleration, if set.
+   */
+  [[nodiscard]]
+  const std::optional<frc::Translation2d>& Acceleration() const noexcept;
+
+  /**
+   * Returns where the target will be after the given time.
+   */
+  [[nodiscard]]
+  frc::Translation2d PositionAt(units::second_t time) const noexcept;
+
+  /**
+   * Returns the target as it will be after the given time: the wrapped
+   * target with its reference moved to PositionAt(time).
+   */
+  [[nodiscard]]
+  APTarget At(units::second_t time) const noexcept;
+
+ private:
+  APTarget m_target;
+  frc::Translation2d m_velocity;
+  std::optional<frc::Translation2d> m_acceleration;
+};
+}  // namespace autopilot
@@ -0,0 +1,78 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include <frc/geometry/Pose2d.h>
+#include <units/velocity.h>
+
+#include "core.h"
+#include "profile.h"
+#include "target.h"
+
+namespace autopilot {
+/**
+ * An APTarget compiled against a profile, for use in the per-tick path.
+ *
+ * Building one unpacks the target's optionals and stores the sine and cosine
+ * of the entry angle along with the squared beeline and rotation radii. A
+ * missing entry angle becomes an infinite beeline radius and a missing
+ * rotation radius becomes an infinite rotation radius, so Calculate never
+ * has to branch on whether they were set.
+ *
+ * Build it once when the target is chosen and pass it to every Calculate
+ * until the target changes.
+ */
+class APPreparedTarget {
+ public:
+  APPreparedTarget() = delete;
+
+  /**
+   * Prepares the given target for the given profile.
+   *
+   * @param target The target to prepare.
+   * @param profile The profile of the autopilot that will drive to it.
+   */
+  APPreparedTarget(const APTarget& target, const APProfile& profile) noexcept;
+
+  /**
+   * Prepares the given target for the given compile time profile.
+   *
+   * @param target The target to prepare.
+   * @param profile The profile of the autopilot that will drive to it.
+   */
+  APPreparedTarget(const APTarget& target,
+                   const APStaticProfile& profile) noexcept;
+
+  /**
+   * Returns this target's reference pose.
+   */
+  [[nodiscard]]
+  const frc::Pose2d& Reference() const noexcept {
+    return m_reference;
+  }
+
+  /**
+   * Returns this target's end velocity.
+   */
+  [[nodiscard]]
+  units::meters_per_second_t Velocity() const noexcept {
+    return units::meters_per_second_t{m_target.velocity};
+  }
+
+ private:
+  friend class Autopilot;
+  template <APStaticProfile>
+  friend class StaticAutopilot;
+
+  frc::Pose2d m_reference;
+  // The same target for the core control law. Autopilot::Prepare attaches
+  // baked goal velocities to it when its velocity field has this target.
+  core::Target m_target;
+};
+}  // namespace autopilot
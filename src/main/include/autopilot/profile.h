@@ -11,6 +11,7 @@
 #include <units/angle.h>
 
 #include "constraints.h"
+#include "core.h"
 
 namespace autopilot {
 /**
@@ -88,4 +89,13 @@ class APProfile {
    */
   units::meter_t BeelineRadius() const;
 };
+
+/**
+ * The constant parameters of a StaticAutopilot.
+ *
+ * Values are plain doubles so the profile can be a template argument:
+ * meters, radians and seconds throughout. The rotational limits default to
+ * zero, which disables the rotational profile as in APConstraints.
+ */
+using APStaticProfile = core::Profile;
 }  // namespace autopilot
@@ -0,0 +1,128 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include <frc/geometry/Pose2d.h>
+#include <frc/geometry/Translation2d.h>
+#include <units/angular_velocity.h>
+#include <units/time.h>
+
+#include <cstddef>
+#include <functional>
+#include <span>
+
+#include "autopilot.h"
+#include "target.h"
+
+namespace autopilot {
+/**
+ * One state along a rolled out path.
+ */
+struct APRolloutSample {
+  units::second_t time;
+  frc::Pose2d pose;
+  // Field relative velocity, in meters per second
+  frc::Translation2d velocity;
+  units::radians_per_second_t omega = 0_rad_per_s;
+};
+
+/**
+ * Why a rollout stopped.
+ */
+enum class APRolloutStatus {
+  /** The robot reached the target within the profile's tolerances. */
+  kAtTarget,
+  /** The caller's stop predicate returned true. */
+  kStopped,
+  /** The sample buffer filled up before the robot arrived. */
+  kBufferFull,
+  /** The time limit ran out before the robot arrived. */
+  kTimeout
+};
+
+/**
+ * Parameters for a rollout.
+ */
+struct APRolloutOptions {
+  /**
+   * The integration step. Preview limits acceleration over this step, so
+   * coarser steps stay consistent with the acceleration constraint at the
+   * cost of a less exact path.
+   */
+  units::second_t step = 20_ms;
+  /** Simulated time after which the rollout gives up. */
+  units::second_t timeout = 15_s;
+  /** Record one sample every this many steps. */
+  int sampleEvery = 1;
+  /**
+   * Called on every step; returning true ends the rollout early. May be
+   * empty.
+   */
+  std::function<bool(const APRolloutSample&)> stop = nullptr;
+};
+
+/**
+ * The outcome of a rollout.
+ */
+struct APRolloutResult {
+  APRolloutStatus status;
+  /** Number of samples written to the buffer. */
+  size_t count;
+  /** Simulated time at the last step. */
+  units::second_t time;
+};
+
+/**
+ * Predicts the path an Autopilot will drive by repeatedly integrating
+ * Autopilot::Preview from a start state until AtTarget. Rollouts never
+ * record telemetry, and leave the autopilot as it was.
+ *
+ * The simulated drivetrain tracks every command exactly: each step the
+ * commanded velocity becomes the robot's velocity. With the rotational
+ * profile enabled the heading integrates the commanded omega, otherwise it
+ * snaps to the commanded target angle. Samples go into a caller provided
+ * buffer, so a rollout never allocates.
+ */
+class APRolloutEngine {
+ public:
+  APRolloutEngine() = delete;
+
+  /**
+   * Creates a rollout engine driving the given autopilot. The autopilot must
+   * outlive the engine.
+   */
+  explicit APRolloutEngine(const Autopilot& autopilot,
+                           APRolloutOptions options = {});
+
+  /**
+   * Rolls out the path from the given state to the target.
+   *
+   * The first sample is the start state. The final state is always recorded
+   * if there is room, even when it does not fall on a sampling step.
+   *
+   * @param start The robot's starting pose.
+   * @param velocity The robot's starting <b>field relative</b> velocity.
+   * @param target The target to drive to.
+   * @param buffer Storage for the sampled path.
+   */
+  APRolloutResult Run(const frc::Pose2d& start,
+                      const frc::Translation2d& velocity,
+                      const APTarget& target,
+                      std::span<APRolloutSample> buffer);
+
+  /**
+   * Returns the options this engine rolls out with.
+   */
+  const APRolloutOptions& Options() const;
+
+ private:
+  const Autopilot& m_autopilot;
+  APRolloutOptions m_options;
+};
+}  // namespace autopilot
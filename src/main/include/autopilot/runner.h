@@ -0,0 +1,190 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include <frc/Notifier.h>
+#include <frc/kinematics/ChassisSpeeds.h>
+#include <units/time.h>
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+#include "autopilot.h"
+#include "prepared_target.h"
+#include "target.h"
+#include "timestamped_pose.h"
+#include "triple_buffer.h"
+
+namespace autopilot {
+/**
+ * The result of one tick of an APRunner.
+ */
+struct APRunnerOutput {
+  APResult result{};
+  // When the tick started, in seconds on the wpi::Now clock
+  units::second_t timestamp = 0_s;
+  // Whether the runner had both a target and a state. If not, result is
+  // zero and should not be driven.
+  bool valid = false;
+  // Whether the predicted pose was within tolerance of the target
+  bool atTarget = false;
+};
+
+/**
+ * Timing statistics of an APRunner since it was last started.
+ */
+struct APRunnerStats {
+  uint64_t ticks = 0;
+  // Ticks whose work took longer than the period
+  uint64_t overruns = 0;
+  // Ticks that started more than a whole period after they were due
+  uint64_t late = 0;
+  units::second_t maxDuration = 0_s;
+  units::second_t meanDuration = 0_s;
+  // Largest difference between the time between two ticks and the period
+  units::second_t maxJitter = 0_s;
+};
+
+/**
+ * Runs an Autopilot on its own frc::Notifier thread, at a higher rate than
+ * the robot loop.
+ *
+ * Targets and robot states are handed to the runner through
+ * APTripleBuffers, and every tick publishes its output through another, so
+ * the robot loop, the runner and the drive code never wait on each other.
+ * Each tick reads the latest state, predicts the pose forward to the tick's
+ * time with the timestamped Calculate, and limits the change in velocity by
+ * the time actually elapsed since the previous tick.
+ *
+ * SetTarget and ClearTarget must be called from one thread, SetState from
+ * one thread, and Latest from one thread; they may be three different
+ * threads.
+ */
+class APRunner {
+ public:
+  APRunner() = delete;
+
+  /**
+   * Creates a stopped runner driving a copy of the given autopilot, whose
+   * period is set to the runner's.
+   *
+   * @param autopilot The autopilot to run. The copy is not attached to its
+   * telemetry ring, if any.
+   * @param period The time between ticks.
+   */
+  explicit APRunner(const Autopilot& autopilot, units::second_t period = 5_ms);
+
+  APRunner(const APRunner&) = delete;
+  APRunner& operator=(const APRunner&) = delete;
+
+  /**
+   * Stops the runner.
+   */
+  ~APRunner();
+
+  /**
+   * Starts ticking and resets the statistics. Does nothing if already
+   * running.
+   */
+  void Start();
+
+  /**
+   * Stops ticking, waiting for a tick in progress to finish. The last output
+   * stays published.
+   */
+  void Stop();
+
+  /**
+   * Returns whether the runner is ticking.
+   */
+  bool IsRunning() const;
+
+  /**
+   * Returns the time between ticks.
+   */
+  units::second_t Period() const;
+
+  /**
+   * Sets the target to drive to from the next tick on.
+   */
+  void SetTarget(const APTarget& target);
+
+  /**
+   * Stops driving to any target. Ticks publish invalid outputs until a
+   * target is set again.
+   */
+  void ClearTarget();
+
+  /**
+   * Publishes the robot's latest state.
+   *
+   * @param pose The robot's pose and when it was measured, on the FPGA
+   * clock that wpi::Now and frc::Timer::GetFPGATimestamp share.
+   * @param velocity The robot's current <b>field relative</b> velocity,
+   * including its angular velocity.
+   */
+  void SetState(const APTimestampedPose& pose,
+                const frc::ChassisSpeeds& velocity);
+
+  /**
+   * Returns the output of the most recent tick. Never waits.
+   */
+  APRunnerOutput Latest();
+
+  /**
+   * Returns the timing statistics. The fields are read one by one, so they
+   * may be from neighbouring ticks.
+   */
+  APRunnerStats Stats() const;
+
+ private:
+  struct TargetInput {
+    std::optional<APTarget> target;
+    // Incremented whenever the target is set or cleared
+    uint64_t generation = 0;
+  };
+
+  struct StateInput {
+    APTimestampedPose pose;
+    frc::ChassisSpeeds velocity;
+    bool valid = false;
+  };
+
+  /**
+   * Runs one tick on the notifier thread.
+   */
+  void Tick();
+
+  Autopilot m_autopilot;
+  units::second_t m_period;
+
+  APTripleBuffer<TargetInput> m_targets;
+  APTripleBuffer<StateInput> m_states;
+  APTripleBuffer<APRunnerOutput> m_outputs;
+  // Written by the target producer only
+  uint64_t m_targetGeneration = 0;
+
+  // Used by the notifier thread only
+  std::optional<APPreparedTarget> m_prepared;
+  uint64_t m_preparedGeneration = 0;
+  uint64_t m_lastStart = 0;
+
+  // Written by the notifier thread only, in microseconds
+  std::atomic<uint64_t> m_ticks{0};
+  std::atomic<uint64_t> m_overruns{0};
+  std::atomic<uint64_t> m_late{0};
+  std::atomic<uint64_t> m_maxDuration{0};
+  std::atomic<uint64_t> m_totalDuration{0};
+  std::atomic<uint64_t> m_maxJitter{0};
+
+  bool m_running = false;
+  frc::Notifier m_notifier{[this] { Tick(); }};
+};
+}  // namespace autopilot
@@ -0,0 +1,155 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include <frc/geometry/Pose2d.h>
+#include <frc/geometry/Rotation2d.h>
+#include <frc/geometry/Translation2d.h>
+#include <frc/kinematics/ChassisSpeeds.h>
+#include <units/acceleration.h>
+#include <units/angle.h>
+#include <units/angular_acceleration.h>
+#include <units/angular_velocity.h>
+#include <units/length.h>
+#include <units/velocity.h>
+
+#include "autopilot.h"
+#include "core.h"
+#include "prepared_target.h"
+#include "profile.h"
+#include "target.h"
+
+namespace autopilot {
+/**
+ * An Autopilot whose profile and control loop period are fixed at compile
+ * time.
+ *
+ * The limits are folded from P once, at compile time, and every call runs
+ * the same control law as Autopilot against them. Results agree with an
+ * Autopilot built from Profile(), with the same period and math mode, to
+ * within rounding.
+ *
+ * @tparam P The profile, for example
+ * <code>APStaticProfile{.velocity = 4.5, .acceleration = 3.0, .jerk = 2.0,
+ * .errorXY = 0.02, .errorTheta = 0.035, .beelineRadius = 0.08}</code>.
+ */
+template <APStaticProfile P>
+class StaticAutopilot {
+ public:
+  static_assert(P.period > 0.0, "the period must be positive");
+
+  /** The limits the control law derives from P. */
+  static constexpr core::Limits kLimits = core::Fold(P);
+
+  StaticAutopilot() = default;
+
+  /**
+   * Returns the runtime profile equivalent to P. Only needed to build an
+   * equivalent Autopilot; nothing here uses it.
+   */
+  static APProfile Profile() {
+    return APProfile(
+               APConstraints(units::meters_per_second_t{P.velocity},
+                             units::meters_per_second_squared_t{
+                                 P.acceleration},
+                             P.jerk)
+                   .withRotationVelocity(
+                       units::radians_per_second_t{P.rotationVelocity})
+                   .withRotationAcceleration(
+                       units::radians_per_second_squared_t{
+                           P.rotationAcceleration})
+                   .withRotationJerk(P.rotationJerk)
+                   .withFrictionCircle(P.frictionCircle)
+                   .withDeceleration(
+                       units::meters_per_second_squared_t{P.deceleration})
+                   .withAxisVelocity(units::meters_per_second_t{P.velocityX},
+                                     units::meters_per_second_t{P.velocityY}))
+        .WithErrorXY(units::meter_t{P.errorXY})
+        .WithErrorTheta(units::radian_t{P.errorTheta})
+        .WithBeelineRadius(units::meter_t{P.beelineRadius});
+  }
+
+  /**
+   * Prepares a target against this autopilot's profile.
+   */
+  APPreparedTarget Prepare(const APTarget& target) const noexcept {
+    return APPreparedTarget{target, P};
+  }
+
+  /**
+   * Returns the next field relative velocity for the trajectory.
+   *
+   * @see Autopilot::Calculate(const frc::Pose2d&, const frc::Translation2d&,
+   * const APTarget&)
+   */
+  APResult Calculate(const frc::Pose2d& current,
+                     const frc::Translation2d& velocity,
+                     const APTarget& target) const noexcept {
+    return Calculate(current, velocity, Prepare(target));
+  }
+
+  /**
+   * Returns the next field relative velocity for the trajectory towards a
+   * prepared target.
+   *
+   * @see Autopilot::Calculate(const frc::Pose2d&, const frc::Translation2d&,
+   * const APPreparedTarget&)
+   */
+  APResult Calculate(const frc::Pose2d& current,
+                     const frc::Translation2d& velocity,
+                     const APPreparedTarget& target) const noexcept {
+    return Calculate(
+        current,
+        frc::ChassisSpeeds{
+            .vx = units::meters_per_second_t{velocity.X().value()},
+            .vy = units::meters_per_second_t{velocity.Y().value()},
+            .omega = 0_rad_per_s},
+        target);
+  }
+
+  /**
+   * Returns the next field relative velocity and angular velocity for the
+   * trajectory towards a prepared target.
+   *
+   * @see Autopilot::Calculate(const frc::Pose2d&, const frc::ChassisSpeeds&,
+   * const APPreparedTarget&, units::second_t)
+   */
+  APResult Calculate(const frc::Pose2d& current,
+                     const frc::ChassisSpeeds& velocity,
+                     const APPreparedTarget& target) const noexcept {
+    const core::Result out = core::Calculate(
+        kLimits, ToCore(current),
+        core::Velocity{velocity.vx.value(), velocity.vy.value(),
+                       velocity.omega.value()},
+        target.m_target, P.period);
+    return APResult{.vx = units::meters_per_second_t{out.vx},
+                    .vy = units::meters_per_second_t{out.vy},
+                    .targetAngle = out.facesTarget
+                                       ? target.Reference().Rotation()
+                                       : current.Rotation(),
+                    .omega = units::radians_per_second_t{out.omega}};
+  }
+
+  /**
+   * Returns whether the given pose is within tolerance for the target
+   */
+  bool AtTarget(const frc::Pose2d& current,
+                const APTarget& target) const noexcept {
+    return core::AtTarget(P, ToCore(current), ToCore(target.Reference()));
+  }
+
+ private:
+  static core::Pose ToCore(const frc::Pose2d& pose) noexcept {
+    return core::Pose{
+        .x = pose.X().value(),
+        .y = pose.Y().value(),
+        .rotation = {pose.Rotation().Cos(), pose.Rotation().Sin()}};
+  }
+};
+}  // namespace autopilot
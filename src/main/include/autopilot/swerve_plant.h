@@ -0,0 +1,134 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include <frc/geometry/Pose2d.h>
+#include <frc/geometry/Translation2d.h>
+#include <frc/kinematics/ChassisSpeeds.h>
+#include <units/acceleration.h>
+#include <units/length.h>
+#include <units/time.h>
+#include <units/velocity.h>
+
+#include <array>
+#include <cstddef>
+
+namespace autopilot {
+/**
+ * The physical limits of a simulated swerve drivetrain.
+ */
+struct APSwervePlantConfig {
+  /** Module positions relative to the robot's center. */
+  std::array<frc::Translation2d, 4> modules = {
+      frc::Translation2d{0.3_m, 0.3_m}, frc::Translation2d{0.3_m, -0.3_m},
+      frc::Translation2d{-0.3_m, 0.3_m}, frc::Translation2d{-0.3_m, -0.3_m}};
+  /** Top speed of each module. */
+  units::meters_per_second_t maxModuleVelocity = 4.5_mps;
+  /** Largest change in each module's velocity vector per second. */
+  units::meters_per_second_squared_t maxModuleAcceleration = 10_mps_sq;
+  /**
+   * Largest change per second in each module's velocity vector against its
+   * current direction. Zero uses the acceleration limit.
+   */
+  units::meters_per_second_squared_t maxModuleDeceleration = 0_mps_sq;
+  /**
+   * Time constant of the modules' velocity loops. Zero tracks every command
+   * as fast as the acceleration limit allows.
+   */
+  units::second_t lag = 0_s;
+  /** Delay between a command being set and the modules acting on it. */
+  units::second_t latency = 0_s;
+};
+
+/**
+ * A lightweight swerve drivetrain model for closed loop simulation.
+ *
+ * Commands are field relative chassis speeds, as returned by Autopilot. After
+ * the configured latency each command is turned into module velocity
+ * vectors, scaled down together if any exceeds the module speed limit, as
+ * SwerveDriveKinematics::DesaturateWheelSpeeds does. Each module then moves
+ * towards its target through the velocity loop lag, changing by at most the
+ * acceleration limit per second. The chassis velocity is the least squares
+ * fit to the module velocities, and the pose integrates it along an arc.
+ *
+ * The plant only advances when Update is called, so it can run in step with
+ * the robot loop or many times faster than real time. It never allocates.
+ */
+class APSwervePlant {
+ public:
+  /**
+   * Creates a plant at rest at the given pose.
+   */
+  explicit APSwervePlant(const APSwervePlantConfig& config = {},
+                         const frc::Pose2d& pose = frc::Pose2d{});
+
+  /**
+   * Moves the plant to the given pose and field relative velocity, and
+   * forgets any pending commands.
+   */
+  void Reset(const frc::Pose2d& pose,
+             const frc::ChassisSpeeds& velocity = frc::ChassisSpeeds{});
+
+  /**
+   * Sets the field relative chassis speeds to drive at, effective once the
+   * configured latency has passed.
+   */
+  void SetCommand(const frc::ChassisSpeeds& velocity);
+
+  /**
+   * Advances the plant by the given time.
+   */
+  void Update(units::second_t dt);
+
+  /**
+   * Returns the robot's pose.
+   */
+  const frc::Pose2d& Pose() const;
+
+  /**
+   * Returns the robot's <b>field relative</b> velocity.
+   */
+  frc::ChassisSpeeds Velocity() const;
+
+  /**
+   * Returns the time simulated since construction.
+   */
+  units::second_t Time() const;
+
+  /**
+   * Returns the limits this plant simulates.
+   */
+  const APSwervePlantConfig& Config() const;
+
+ private:
+  // Commands in flight. When full, the oldest command is applied early.
+  static constexpr size_t kMaxPending = 64;
+
+  struct Pending {
+    units::second_t time;
+    frc::ChassisSpeeds velocity;
+  };
+
+  // Solves for the robot relative chassis speeds from the module velocities
+  frc::ChassisSpeeds FitChassisSpeeds() const;
+
+  APSwervePlantConfig m_config;
+  frc::Pose2d m_pose;
+  // Robot relative module velocities, in meters per second
+  std::array<frc::Translation2d, 4> m_moduleVelocities;
+  // Robot relative
+  frc::ChassisSpeeds m_velocity;
+  // Field relative
+  frc::ChassisSpeeds m_command;
+  std::array<Pending, kMaxPending> m_pending;
+  size_t m_pendingStart = 0;
+  size_t m_pendingCount = 0;
+  units::second_t m_time = 0_s;
+};
+}  // namespace autopilot
@@ -23,6 +23,9 @@ namespace autopilot {
  * A target may also specify an end velocity.
  *
  * The target also may have a desired end velocity.
+ *
+ * Each With* builder returns a modified copy. Targets hold no heap storage,
+ * so the builders never allocate.
  */
 class APTarget {
  protected:
@@ -40,7 +43,7 @@ class APTarget {
    *
    * @param pose The reference pose for this target.
    */
-  explicit APTarget(const frc::Pose2d& pose);
+  explicit APTarget(const frc::Pose2d& pose) noexcept;
 
   /**
    * Returns a copy of this target with the given reference.
@@ -48,7 +51,7 @@ class APTarget {
    * @param reference The reference pose for this target.
    */
   [[nodiscard]]
-  APTarget WithReference(const frc::Pose2d& reference) const;
+  APTarget WithReference(const frc::Pose2d& reference) const noexcept;
 
   /**
    * Returns a copy of this target with the given entry angle.
@@ -56,7 +59,7 @@ class APTarget {
    * @param entryAngle The entry angle for the new target.
    */
   [[nodiscard]]
-  APTarget WithEntryAngle(const frc::Rotation2d& angle) const;
+  APTarget WithEntryAngle(const frc::Rotation2d& angle) const noexcept;
 
   /**
    * Returns a copy of this target with the given end velocity. Note that if the
@@ -68,7 +71,7 @@ class APTarget {
    * target
    */
   [[nodiscard]]
-  APTarget WithVelocity(units::meters_per_second_t velocity) const;
+  APTarget WithVelocity(units::meters_per_second_t velocity) const noexcept;
 
   /**
    * Returns a copy of this target with the given rotation radius.
@@ -81,37 +84,37 @@ class APTarget {
    * @param radius The rotation radius for the new target
    */
   [[nodiscard]]
-  APTarget WithRotationRadius(units::meter_t radius) const;
+  APTarget WithRotationRadius(units::meter_t radius) const noexcept;
 
   /**
    * Returns this target's reference pose.
    */
   [[nodiscard]]
-  const frc::Pose2d& Reference() const;
+  const frc::Pose2d& Reference() const noexcept;
 
   /**
    * Returns this target's optional entry angle.
    */
   [[nodiscard]]
-  const std::optional<frc::Rotation2d>& EntryAngle() const;
+  const std::optional<frc::Rotation2d>& EntryAngle() const noexcept;
 
   /**
    * Returns this target's rotation radius.
    */
   [[nodiscard]]
-  const std::optional<units::meter_t>& RotationRadius() const;
+  const std::optional<units::meter_t>& RotationRadius() const noexcept;
 
   /**
    * Returns this target's end velocity.
    */
   [[nodiscard]]
-  units::meters_per_second_t Velocity() const;
+  units::meters_per_second_t Velocity() const noexcept;
 
   /**
    * Returns a copy of this target.
    */
   [[nodiscard]]
-  APTarget Clone() const {
+  APTarget Clone() const noexcept {
     return *this;
   }
 
@@ -120,6 +123,6 @@ class APTarget {
    * if trying to make two different targets with and without entry angle set.
    */
   [[nodiscard]]
-  APTarget WithoutEntryAngle() const;
+  APTarget WithoutEntryAngle() const noexcept;
 };
 }  // namespace autopilot
@@ -0,0 +1,101 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include <frc/geometry/Pose2d.h>
+#include <frc/geometry/Translation2d.h>
+#include <units/time.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "autopilot.h"
+#include "prepared_target.h"
+#include "target.h"
+
+namespace autopilot {
+/**
+ * The candidate an APTargetSet picked, and how long it should take to reach.
+ */
+struct APTargetChoice {
+  size_t index;
+  units::second_t time;
+};
+
+/**
+ * A fixed set of equivalent candidate targets, such as every scoring pose on
+ * the field, that can pick the one fastest to reach.
+ *
+ * The candidates are indexed in a k-d tree over their reference positions.
+ * Finding the best one visits nearer candidates first and skips any subtree
+ * whose distance alone guarantees, through Autopilot::MinimumTimeToTarget,
+ * that it is slower than the best estimate found so far. Only a fraction of
+ * the candidates are fully estimated each tick, even for large sets.
+ */
+class APTargetSet {
+ public:
+  APTargetSet() = delete;
+
+  /**
+   * Builds a set from the given candidates, prepared against the given
+   * autopilot's profile. The autopilot must outlive the set.
+   */
+  APTargetSet(Autopilot& autopilot, std::span<const APTarget> targets);
+
+  /**
+   * Returns the candidate with the lowest estimated time to reach from the
+   * given state, as computed by Autopilot::EstimateTimeToTarget. Returns
+   * nothing if the set is empty or no candidate is reachable.
+   *
+   * @param current The robot's current position.
+   * @param velocity The robot's current <b>field relative</b> velocity.
+   */
+  std::optional<APTargetChoice> Best(const frc::Pose2d& current,
+                                     const frc::Translation2d& velocity) const;
+
+  /**
+   * Returns the candidate at the given index, in the order it was added.
+   */
+  const APTarget& operator[](size_t index) const;
+
+  /**
+   * Returns the prepared form of the candidate at the given index.
+   */
+  const APPreparedTarget& Prepared(size_t index) const;
+
+  /**
+   * Returns the number of candidates in this set.
+   */
+  size_t Size() const;
+
+ private:
+  struct Node {
+    double x;
+    double y;
+    uint32_t index;
+  };
+
+  void Build(size_t lo, size_t hi, int depth);
+  void Search(size_t lo, size_t hi, int depth, const frc::Pose2d& current,
+              const frc::Translation2d& velocity,
+              std::optional<APTargetChoice>& best) const;
+
+  Autopilot& m_autopilot;
+  std::vector<APTarget> m_targets;
+  std::vector<APPreparedTarget> m_prepared;
+  // Implicit k-d tree: the median of each range is its node, split on x at
+  // even depths and y at odd depths
+  std::vector<Node> m_nodes;
+  // The highest end velocity in the set, for the travel time lower bound
+  units::meters_per_second_t m_maxEndVelocity;
+};
+}  // namespace autopilot
@@ -0,0 +1,220 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include <units/time.h>
+#include <wpi/DataLog.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <thread>
+
+#include "core.h"
+
+namespace autopilot {
+class Autopilot;
+
+/**
+ * Which part of Calculate produced a result.
+ */
+using APBranch = core::Branch;
+
+/**
+ * A fixed size snapshot of one Calculate call: its inputs, its output and the
+ * branch it took. Records are plain data so they can be copied through
+ * APTelemetryRing without allocating.
+ *
+ * Positions are in meters, angles in radians, velocities are <b>field
+ * relative</b> in meters and radians per second and times are in seconds,
+ * except the timestamp, which is in microseconds on the wpi::Now clock.
+ */
+struct APRecord {
+  /** Number of doubles in a packed record. */
+  static constexpr size_t kSize = 20;
+  /** Comma separated field names of a packed record, in order. */
+  static constexpr std::string_view kFields =
+      "x,y,heading,vx,vy,omega,targetX,targetY,targetHeading,entryAngle,"
+      "rotationRadius,endVelocity,dt,outVx,outVy,outHeading,outOmega,disp,"
+      "branch,field";
+
+  int64_t timestamp = 0;
+  double x = 0.0;
+  double y = 0.0;
+  double heading = 0.0;
+  double vx = 0.0;
+  double vy = 0.0;
+  double omega = 0.0;
+  double targetX = 0.0;
+  double targetY = 0.0;
+  double targetHeading = 0.0;
+  // NaN when the target has no entry angle
+  double entryAngle = std::numeric_limits<double>::quiet_NaN();
+  // Infinity when the target has no rotation radius
+  double rotationRadius = std::numeric_limits<double>::infinity();
+  double endVelocity = 0.0;
+  double dt = 0.0;
+  double outVx = 0.0;
+  double outVy = 0.0;
+  double outHeading = 0.0;
+  double outOmega = 0.0;
+  // Distance to the target when the branch was chosen
+  double disp = 0.0;
+  APBranch branch = APBranch::kArrived;
+  // Whether the goal velocity came from a baked APVelocityField grid
+  bool field = false;
+
+  /**
+   * Packs this record into an array of doubles, in the order of kFields. The
+   * timestamp is not included.
+   */
+  std::array<double, kSize> Pack() const;
+
+  /**
+   * Unpacks a record packed by Pack. Missing trailing fields are left at
+   * their defaults, so logs from older layouts still load.
+   */
+  static APRecord Unpack(std::span<const double> packed, int64_t timestamp);
+};
+
+/**
+ * A single producer, single consumer ring buffer of APRecords.
+ *
+ * The storage is allocated once on construction. Pushing and popping never
+ * allocate, lock or wait: a push into a full ring drops the record and counts
+ * it, so the control loop is never held up by a slow consumer.
+ *
+ * Only one thread may push and only one thread may pop at a time.
+ */
+class APTelemetryRing {
+ public:
+  APTelemetryRing() = delete;
+
+  /**
+   * Creates a ring holding at least the given number of records. The
+   * capacity is rounded up to a power of two.
+   */
+  explicit APTelemetryRing(size_t capacity);
+
+  APTelemetryRing(const APTelemetryRing&) = delete;
+  APTelemetryRing& operator=(const APTelemetryRing&) = delete;
+
+  /**
+   * Copies a record into the ring. Returns false and counts the record as
+   * dropped if the ring is full. Producer only.
+   */
+  bool TryPush(const APRecord& record) noexcept;
+
+  /**
+   * Moves the oldest record into the given one. Returns false if the ring is
+   * empty. Consumer only.
+   */
+  bool TryPop(APRecord& record) noexcept;
+
+  /**
+   * Returns the number of records the ring can hold.
+   */
+  size_t Capacity() const;
+
+  /**
+   * Returns the number of records dropped because the ring was full.
+   */
+  uint64_t Dropped() const;
+
+ private:
+  // Keeps the producer and consumer indices on separate cache lines
+  static constexpr size_t kCacheLine = 64;
+
+  std::unique_ptr<APRecord[]> m_records;
+  size_t m_mask;
+
+  // Next slot to write. Written by the producer only.
+  alignas(kCacheLine) std::atomic<size_t> m_head{0};
+  // Next slot to read. Written by the consumer only.
+  alignas(kCacheLine) std::atomic<size_t> m_tail{0};
+  // Written by the producer only.
+  alignas(kCacheLine) std::atomic<uint64_t> m_dropped{0};
+};
+
+/**
+ * Records every Calculate call of an Autopilot to a WPILib DataLog.
+ *
+ * The logger attaches a ring to the autopilot, so Calculate only copies a
+ * record into it, and drains the ring from a background thread. Each record
+ * is appended to the double array entry "<name>/record" at the time it was
+ * captured, with kFields as its metadata. The autopilot's profile is written
+ * once to "<name>/profile" and the count of dropped records to
+ * "<name>/dropped" whenever it changes.
+ *
+ * The batched Calculate is not recorded.
+ */
+class APTelemetryLogger {
+ public:
+  /** Field names of the "<name>/profile" entry, in order. */
+  static constexpr std::string_view kProfileFields =
+      "velocity,acceleration,jerk,errorXY,errorTheta,beelineRadius,"
+      "rotationVelocity,rotationAcceleration,rotationJerk,period,mathMode,"
+      "frictionCircle,deceleration,velocityX,velocityY";
+
+  APTelemetryLogger() = delete;
+
+  /**
+   * Starts recording the given autopilot. The autopilot and the log must
+   * outlive the logger, and Calculate must only be called from one thread at
+   * a time while it is recording.
+   *
+   * @param autopilot The autopilot to record.
+   * @param log The log to write to, such as frc::DataLogManager::GetLog().
+   * @param name The prefix of the log entries.
+   * @param capacity The number of records buffered between drains.
+   * @param pollPeriod How long the background thread sleeps when the ring is
+   * empty.
+   */
+  APTelemetryLogger(Autopilot& autopilot, wpi::log::DataLog& log,
+                    std::string_view name = "autopilot",
+                    size_t capacity = 1024,
+                    units::second_t pollPeriod = 5_ms);
+
+  APTelemetryLogger(const APTelemetryLogger&) = delete;
+  APTelemetryLogger& operator=(const APTelemetryLogger&) = delete;
+
+  /**
+   * Detaches from the autopilot and writes any remaining records. A
+   * Calculate running on another thread may still be recording; detaching
+   * waits for it, so the ring is never freed under it.
+   */
+  ~APTelemetryLogger();
+
+  /**
+   * Returns the number of records dropped because the background thread fell
+   * behind.
+   */
+  uint64_t Dropped() const;
+
+ private:
+  /**
+   * Writes every buffered record to the log.
+   */
+  void Drain();
+
+  Autopilot& m_autopilot;
+  APTelemetryRing m_ring;
+  wpi::log::DoubleArrayLogEntry m_recordEntry;
+  wpi::log::IntegerLogEntry m_droppedEntry;
+  uint64_t m_loggedDropped = 0;
+  units::second_t m_pollPeriod;
+  std::atomic<bool> m_running{true};
+  std::thread m_thread;
+};
+}  // namespace autopilot
@@ -0,0 +1,25 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include <frc/geometry/Pose2d.h>
+#include <units/time.h>
+
+namespace autopilot {
+/**
+ * A pose along with the time it was measured, such as a vision measurement
+ * or the output of a pose estimator fed by one.
+ */
+struct APTimestampedPose {
+  frc::Pose2d pose;
+  // When the pose was valid, on the same clock as the time passed to
+  // Calculate, usually frc::Timer::GetFPGATimestamp()
+  units::second_t timestamp = 0_s;
+};
+}  // namespace autopilot
@@ -0,0 +1,180 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace autopilot {
+/**
+ * The stages of Autopilot::Calculate timed by its trace points.
+ */
+enum class APStage : uint8_t {
+  /** The whole scalar Autopilot::Calculate call. */
+  kCalculate,
+  /** Autopilot::PredictPose, for calls with a timestamped pose. */
+  kPredict,
+  /**
+   * Moving the offset, velocity and heading into the target's frame at the
+   * start of core::Translate.
+   */
+  kFrame,
+  /**
+   * The goal velocity in core::Translate: beeline through core::MaxVelocity,
+   * swirly through core::SwirlyVelocity, or baked through core::Lookup.
+   */
+  kGoal,
+  /** core::Correct, which applies the acceleration and velocity limits. */
+  kCorrect,
+  /**
+   * Choosing the heading to hold at the end of core::Translate, from the
+   * rotation radius.
+   */
+  kRotation,
+  /** core::Omega, the rotational profile. */
+  kOmega,
+  /** Filling in and pushing the telemetry record. */
+  kTelemetry,
+  kCount
+};
+
+/**
+ * Durations of one stage, bucketed by powers of two.
+ */
+struct APStageHistogram {
+  /**
+   * Bucket 0 counts zero durations and bucket i those from 2^(i-1) up to
+   * 2^i ns. The last bucket also counts everything longer.
+   */
+  static constexpr size_t kBuckets = 32;
+
+  uint64_t count = 0;
+  uint64_t totalNanos = 0;
+  uint64_t maxNanos = 0;
+  std::array<uint64_t, kBuckets> buckets{};
+
+  /**
+   * Returns an upper bound on the given quantile, between 0 and 1, in
+   * nanoseconds: the top of the bucket it falls in, or the maximum if that
+   * is lower.
+   */
+  uint64_t Percentile(double quantile) const;
+};
+
+/**
+ * Stage level tracing of Autopilot::Calculate.
+ *
+ * The trace points are compiled in only when AUTOPILOT_TRACE is defined,
+ * which the build does when given -PautopilotTrace. Otherwise
+ * AP_TRACE_STAGE expands to nothing and Enabled returns false.
+ *
+ * Each trace point reads the steady clock, which on Linux is served from
+ * the vDSO without a system call, when its scope opens and closes. The
+ * duration goes into a histogram per stage, and the stage, start and
+ * duration into a ring of recent events. Both live in a slot that a thread
+ * claims the first time it traces, so recording takes no locks and never
+ * allocates. At most kMaxThreads threads are traced, and each keeps its
+ * last kEvents events.
+ *
+ * Read the results with Histogram and WriteChromeTrace once the traced
+ * threads are idle. The trace file opens in chrome://tracing or Perfetto.
+ */
+class APTrace {
+ public:
+  /** Threads that can be traced at once. Later threads are not traced. */
+  static constexpr size_t kMaxThreads = 16;
+  /** Events each thread keeps. Older events are overwritten. */
+  static constexpr size_t kEvents = size_t{1} << 14;
+
+  /** Names of the stages, as written to the trace file. */
+  static constexpr std::array<std::string_view,
+                              static_cast<size_t>(APStage::kCount)>
+      kStageNames = {"calculate", "predict", "frame",  "goal",
+                     "correct",   "rotation", "omega", "telemetry"};
+
+  APTrace() = delete;
+
+  /**
+   * Returns whether the trace points were compiled in.
+   */
+  static constexpr bool Enabled() {
+#ifdef AUTOPILOT_TRACE
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * Returns the steady clock in nanoseconds.
+   */
+  static int64_t Now() noexcept;
+
+  /**
+   * Records one pass through a stage on the calling thread.
+   */
+  static void Record(APStage stage, int64_t start, int64_t end) noexcept;
+
+  /**
+   * Returns the given stage's histogram, merged across every traced thread.
+   */
+  static APStageHistogram Histogram(APStage stage);
+
+  /**
+   * Writes every traced thread's recent events to the given file as Chrome
+   * trace JSON, with each stage's histogram summarized under otherData.
+   * Returns false if tracing was compiled out or the file cannot be
+   * written.
+   */
+  static bool WriteChromeTrace(std::string_view path);
+
+  /**
+   * Clears every histogram and event. Threads keep their slots.
+   */
+  static void Reset();
+};
+
+/**
+ * Records the time from its construction to its destruction as one pass
+ * through a stage. Use it through AP_TRACE_STAGE.
+ */
+class APTraceScope {
+ public:
+  explicit APTraceScope(APStage stage) noexcept
+      : m_stage(stage), m_start(APTrace::Now()) {}
+
+  ~APTraceScope() { APTrace::Record(m_stage, m_start, APTrace::Now()); }
+
+  APTraceScope(const APTraceScope&) = delete;
+  APTraceScope& operator=(const APTraceScope&) = delete;
+
+ private:
+  APStage m_stage;
+  int64_t m_start;
+};
+}  // namespace autopilot
+
+#define AP_TRACE_CONCAT_INNER(a, b) a##b
+#define AP_TRACE_CONCAT(a, b) AP_TRACE_CONCAT_INNER(a, b)
+
+/**
+ * Times the rest of the enclosing scope as a pass through the given
+ * APStage, such as AP_TRACE_STAGE(kGoal). Compiled out unless
+ * AUTOPILOT_TRACE is defined.
+ */
+#ifdef AUTOPILOT_TRACE
+#define AP_TRACE_STAGE(stage)                                          \
+  const ::autopilot::APTraceScope AP_TRACE_CONCAT(apTrace, __LINE__) { \
+    ::autopilot::APStage::stage                                        \
+  }
+#else
+#define AP_TRACE_STAGE(stage) static_cast<void>(0)
+#endif
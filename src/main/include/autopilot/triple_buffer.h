@@ -0,0 +1,95 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace autopilot {
+/**
+ * A single producer, single consumer handoff of the latest value of T.
+ *
+ * Three copies of T are kept: one the producer writes, one the consumer
+ * reads, and one in the middle holding the most recent publication. Writing
+ * and reading each swap their copy with the middle one through a single
+ * atomic exchange, so neither side ever waits for the other or allocates.
+ * Values the consumer did not read in time are overwritten, never queued.
+ *
+ * Only one thread may write and only one thread may read at a time.
+ */
+template <typename T>
+class APTripleBuffer {
+ public:
+  APTripleBuffer() = default;
+
+  /**
+   * Creates a buffer whose reads return the given value until the first
+   * write.
+   */
+  explicit APTripleBuffer(const T& initial) {
+    for (Slot& slot : m_slots) {
+      slot.value = initial;
+    }
+  }
+
+  APTripleBuffer(const APTripleBuffer&) = delete;
+  APTripleBuffer& operator=(const APTripleBuffer&) = delete;
+
+  /**
+   * Publishes a value, replacing any the consumer has not read yet.
+   * Producer only.
+   */
+  void Write(const T& value) {
+    m_slots[m_back].value = value;
+    m_back = m_middle.exchange(m_back | kFresh, std::memory_order_acq_rel) &
+             kIndex;
+  }
+
+  /**
+   * Returns the most recently published value. The reference stays valid
+   * until the next call to Read. Consumer only.
+   *
+   * @param fresh If not null, set to whether a value was published since
+   * the previous read.
+   */
+  const T& Read(bool* fresh = nullptr) {
+    const bool published =
+        (m_middle.load(std::memory_order_relaxed) & kFresh) != 0;
+    if (published) {
+      m_front =
+          m_middle.exchange(m_front, std::memory_order_acq_rel) & kIndex;
+    }
+    if (fresh) {
+      *fresh = published;
+    }
+    return m_slots[m_front].value;
+  }
+
+ private:
+  // Keeps the copies, and the producer and consumer, on separate cache lines
+  static constexpr size_t kCacheLine = 64;
+  // The middle index's low bits, and a flag set when it holds a value the
+  // consumer has not read
+  static constexpr uint8_t kIndex = 0x3;
+  static constexpr uint8_t kFresh = 0x4;
+
+  struct alignas(kCacheLine) Slot {
+    T value{};
+  };
+
+  std::array<Slot, 3> m_slots;
+  // Written by the producer only
+  alignas(kCacheLine) uint8_t m_back = 0;
+  alignas(kCacheLine) std::atomic<uint8_t> m_middle{1};
+  // Written by the consumer only
+  alignas(kCacheLine) uint8_t m_front = 2;
+};
+}  // namespace autopilot
@@ -0,0 +1,177 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include <frc/geometry/Translation2d.h>
+#include <units/length.h>
+#include <wpi/MappedFileRegion.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "core.h"
+#include "target.h"
+
+namespace autopilot {
+class Autopilot;
+
+/**
+ * The start of a velocity field file.
+ *
+ * A file is this header, then one APFieldRecord per target, then each
+ * target's samples. All values are little endian. The profile fields are the
+ * parts of the profile the goal velocity depends on, so a file baked for a
+ * different profile is never used.
+ */
+struct APFieldFileHeader {
+  static constexpr char kMagic[8] = {'A', 'P', 'V', 'F', 'I', 'E', 'L', 'D'};
+  static constexpr uint32_t kVersion = 1;
+
+  char magic[8];
+  uint32_t version;
+  uint32_t count;  // Number of records
+  double jerk;
+  double deceleration;
+  double beelineRadius;
+  uint32_t mathMode;
+  uint32_t reserved;
+};
+
+/**
+ * One baked target in a velocity field file.
+ *
+ * The samples cover the square from -extent to extent along both axes of
+ * the target's coordinate frame, in which x points along the entry angle.
+ * They are a row major grid of size by size float pairs, rows along y, each
+ * the goal velocity in that frame for the robot at that offset from the
+ * target.
+ */
+struct APFieldRecord {
+  double x;            // m
+  double y;            // m
+  double heading;      // rad
+  double entryAngle;   // rad
+  double endVelocity;  // m/s
+  double extent;       // m
+  uint32_t size;       // Samples per side
+  uint32_t reserved;
+  uint64_t offset;  // Of the first sample from the start of the file
+};
+
+static_assert(sizeof(APFieldFileHeader) == 48);
+static_assert(sizeof(APFieldRecord) == 64);
+
+/**
+ * The baked goal velocities around one target.
+ */
+class APFieldGrid {
+ public:
+  APFieldGrid(const APFieldRecord& record, const float* samples,
+              double beelineRadius);
+
+  /**
+   * Returns the goal velocity in the target's coordinate frame for the given
+   * offset from the robot to the target in that frame, interpolated
+   * bilinearly between the four surrounding samples.
+   *
+   * Returns nothing outside the grid, close to the target and along the
+   * line behind the target where the swirly path folds, where the goal
+   * velocity jumps or bends too sharply to interpolate. Calculate computes
+   * those goals exactly instead. Wherever it answers, on grids of cells up
+   * to 0.2 m, the goal is within 1% of the exact goal's speed.
+   */
+  std::optional<frc::Translation2d> Lookup(
+      const frc::Translation2d& offset) const noexcept;
+
+  /**
+   * Returns whether this grid was baked for the given target.
+   */
+  bool Matches(const APTarget& target) const noexcept;
+
+  /**
+   * Returns this grid for the core control law.
+   */
+  const core::FieldGrid& Grid() const noexcept { return m_grid; }
+
+ private:
+  const APFieldRecord* m_record;
+  core::FieldGrid m_grid;
+};
+
+/**
+ * Goal velocities precomputed offline for fixed targets.
+ *
+ * Evaluating the swirly goal velocity takes an arctangent, a logarithm and
+ * a cube root. For targets known before the match, such as scoring poses,
+ * the tools' bake command evaluates it once on a dense grid around each
+ * target and writes the grids to a file in the deploy directory. Load maps
+ * that file into memory, and an Autopilot given the field with
+ * WithVelocityField answers each tick towards a baked target with a
+ * bilinear lookup instead. The acceleration, velocity and axis limits are
+ * still applied every tick.
+ *
+ * Only the scalar Calculate uses the field. Targets without an entry angle
+ * are always driven straight at and are never baked.
+ */
+class APVelocityField {
+ public:
+  APVelocityField() = delete;
+
+  APVelocityField(APVelocityField&&) = default;
+  APVelocityField& operator=(APVelocityField&&) = default;
+
+  /**
+   * Maps the given file into memory. Returns nothing if the file cannot be
+   * read or is not a valid velocity field.
+   */
+  static std::optional<APVelocityField> Load(std::string_view path);
+
+  /**
+   * Evaluates the autopilot's goal velocity around each target on a grid
+   * covering extent in every direction with the given spacing, and writes
+   * the grids to the given file. Returns false if a target has no entry
+   * angle or the file cannot be written.
+   */
+  static bool Bake(Autopilot& autopilot, std::span<const APTarget> targets,
+                   units::meter_t extent, units::meter_t cellSize,
+                   std::string_view path);
+
+  /**
+   * Returns whether this field was baked with the parts of the autopilot's
+   * profile that shape the goal velocity.
+   */
+  bool Matches(const Autopilot& autopilot) const noexcept;
+
+  /**
+   * Returns the grid baked for the given target, or nullptr if there is
+   * none.
+   */
+  const APFieldGrid* Find(const APTarget& target) const noexcept;
+
+  /**
+   * Returns the number of baked targets.
+   */
+  size_t Size() const;
+
+  /**
+   * Returns the size of the mapped file in bytes.
+   */
+  size_t Bytes() const;
+
+ private:
+  APVelocityField(wpi::MappedFileRegion region, std::vector<APFieldGrid> grids);
+
+  wpi::MappedFileRegion m_region;
+  std::vector<APFieldGrid> m_grids;
+};
+}  // namespace autopilot
@@ -0,0 +1,385 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <numbers>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "autopilot/autopilot.h"
+#include "autopilot/rollout.h"
+#include "autopilot/static_autopilot.h"
+#include "autopilot/telemetry.h"
+#include "gtest/gtest.h"
+
+using namespace autopilot;
+
+namespace {
+APProfile RotatingProfile() {
+  return APProfile(
+             APConstraints(4.5_mps, 8_mps_sq, 12.0)
+                 .withRotationVelocity(units::radians_per_second_t{6.0})
+                 .withRotationAcceleration(
+                     units::radians_per_second_squared_t{12.0})
+                 .withRotationJerk(40.0))
+      .WithErrorXY(2_cm)
+      .WithErrorTheta(2_deg)
+      .WithBeelineRadius(8_cm);
+}
+
+// The tolerances of RotatingProfile around the given constraints
+APProfile TranslatingProfile(const APConstraints& constraints) {
+  return APProfile(constraints)
+      .WithErrorXY(2_cm)
+      .WithErrorTheta(2_deg)
+      .WithBeelineRadius(8_cm);
+}
+
+constexpr APStaticProfile kRotatingProfile{.velocity = 4.5,
+                                           .acceleration = 8.0,
+                                           .jerk = 12.0,
+                                           .errorXY = 0.02,
+                                           .errorTheta = 0.035,
+                                           .beelineRadius = 0.08,
+                                           .rotationVelocity = 6.0,
+                                           .rotationAcceleration = 12.0,
+                                           .rotationJerk = 40.0};
+
+const APTarget kTarget =
+    APTarget{frc::Pose2d{3_m, 1_m, frc::Rotation2d{units::radian_t{2.0}}}}
+        .WithEntryAngle(frc::Rotation2d{units::radian_t{0.5}});
+
+const frc::Pose2d kStart{0_m, 0_m, frc::Rotation2d{}};
+
+const frc::Translation2d kVelocity{1_m, 0.5_m};
+
+// Far enough along +x from kStart that the goal speed is the velocity limit
+const APTarget kAhead{frc::Pose2d{5_m, 0_m, frc::Rotation2d{}}};
+
+// The length of the change from the initial velocity to the result's
+double Step(const APResult& result, const frc::Translation2d& initial) {
+  return std::hypot(result.vx.value() - initial.X().value(),
+                    result.vy.value() - initial.Y().value());
+}
+}  // namespace
+
+TEST(AutopilotTest, CalculateDependsOnlyOnItsInputs) {
+  Autopilot autopilot{RotatingProfile()};
+  const APResult first = autopilot.Calculate(kStart, kVelocity, kTarget);
+  // A call for another robot in between must not change the next result
+  autopilot.Calculate(frc::Pose2d{5_m, 5_m, frc::Rotation2d{}},
+                      frc::ChassisSpeeds{.vx = 0_mps,
+                                         .vy = 0_mps,
+                                         .omega = units::radians_per_second_t{
+                                             -4.0}},
+                      kTarget);
+  const APResult second = autopilot.Calculate(kStart, kVelocity, kTarget);
+  EXPECT_EQ(first.vx, second.vx);
+  EXPECT_EQ(first.vy, second.vy);
+  EXPECT_EQ(first.omega, second.omega);
+}
+
+TEST(AutopilotTest, StaticCalculateDependsOnlyOnItsInputs) {
+  const StaticAutopilot<kRotatingProfile> autopilot;
+  const APResult first = autopilot.Calculate(kStart, kVelocity, kTarget);
+  autopilot.Calculate(
+      frc::Pose2d{5_m, 5_m, frc::Rotation2d{}},
+      frc::ChassisSpeeds{.vx = 0_mps,
+                         .vy = 0_mps,
+                         .omega = units::radians_per_second_t{-4.0}},
+      autopilot.Prepare(kTarget));
+  const APResult second = autopilot.Calculate(kStart, kVelocity, kTarget);
+  EXPECT_EQ(first.omega, second.omega);
+}
+
+TEST(AutopilotTest, StaticMatchesAutopilot) {
+  const StaticAutopilot<kRotatingProfile> fixed;
+  Autopilot autopilot{StaticAutopilot<kRotatingProfile>::Profile()};
+  std::mt19937 rng{11};
+  std::uniform_real_distribution<double> position{-8.0, 8.0};
+  std::uniform_real_distribution<double> speed{-3.0, 3.0};
+  std::uniform_real_distribution<double> angle{-std::numbers::pi,
+                                               std::numbers::pi};
+  for (int i = 0; i < 1000; ++i) {
+    const frc::Pose2d pose{units::meter_t{position(rng)},
+                           units::meter_t{position(rng)},
+                           frc::Rotation2d{units::radian_t{angle(rng)}}};
+    const frc::ChassisSpeeds velocity{
+        .vx = units::meters_per_second_t{speed(rng)},
+        .vy = units::meters_per_second_t{speed(rng)},
+        .omega = units::radians_per_second_t{speed(rng)}};
+    const APTarget target =
+        APTarget{frc::Pose2d{units::meter_t{position(rng)},
+                             units::meter_t{position(rng)},
+                             frc::Rotation2d{units::radian_t{angle(rng)}}}}
+            .WithEntryAngle(frc::Rotation2d{units::radian_t{angle(rng)}});
+    const APResult expected =
+        autopilot.Calculate(pose, velocity, autopilot.Prepare(target));
+    const APResult result =
+        fixed.Calculate(pose, velocity, fixed.Prepare(target));
+    // The compiler may round differently once the limits are constants
+    EXPECT_NEAR(result.vx.value(), expected.vx.value(), 1e-12) << i;
+    EXPECT_NEAR(result.vy.value(), expected.vy.value(), 1e-12) << i;
+    EXPECT_NEAR(result.omega.value(), expected.omega.value(), 1e-12) << i;
+    EXPECT_EQ(fixed.AtTarget(pose, target), autopilot.AtTarget(pose, target));
+  }
+}
+
+TEST(AutopilotTest, PreviewMatchesCalculateWithoutRecording) {
+  Autopilot autopilot{RotatingProfile()};
+  APTelemetryRing ring{16};
+  autopilot.WithTelemetry(&ring);
+
+  const frc::ChassisSpeeds velocity{.vx = 1_mps,
+                                    .vy = 0.5_mps,
+                                    .omega = units::radians_per_second_t{1.0}};
+  const APResult preview =
+      autopilot.Preview(kStart, velocity, autopilot.Prepare(kTarget));
+  APRecord record;
+  EXPECT_FALSE(ring.TryPop(record));
+
+  const APResult result = autopilot.Calculate(kStart, velocity, kTarget);
+  EXPECT_EQ(preview.vx, result.vx);
+  EXPECT_EQ(preview.vy, result.vy);
+  EXPECT_EQ(preview.omega, result.omega);
+  EXPECT_TRUE(ring.TryPop(record));
+  EXPECT_FALSE(ring.TryPop(record));
+}
+
+TEST(AutopilotTest, RolloutDoesNotRecord) {
+  Autopilot autopilot{RotatingProfile()};
+  APTelemetryRing ring{16};
+  autopilot.WithTelemetry(&ring);
+
+  APRolloutEngine engine{autopilot};
+  std::vector<APRolloutSample> path(1024);
+  const APRolloutResult rollout = engine.Run(kStart, kVelocity, kTarget, path);
+  EXPECT_EQ(rollout.status, APRolloutStatus::kAtTarget);
+
+  APRecord record;
+  EXPECT_FALSE(ring.TryPop(record));
+  EXPECT_EQ(ring.Dropped(), 0u);
+}
+
+TEST(AutopilotTest, DetachingWaitsForRecording) {
+  Autopilot autopilot{RotatingProfile()};
+  std::atomic<bool> running{true};
+  std::thread control{[&] {
+    while (running.load()) {
+      autopilot.Calculate(kStart, kVelocity, kTarget);
+    }
+  }};
+
+  // Every ring is freed right after it is detached, while the control
+  // thread keeps recording
+  for (int i = 0; i < 1000; ++i) {
+    auto ring = std::make_unique<APTelemetryRing>(4);
+    autopilot.WithTelemetry(ring.get());
+    autopilot.WithTelemetry(nullptr);
+  }
+  running.store(false);
+  control.join();
+}
+
+TEST(AutopilotTest, CopiesStartDetached) {
+  Autopilot autopilot{RotatingProfile()};
+  APTelemetryRing ring{16};
+  autopilot.WithTelemetry(&ring);
+
+  Autopilot copy = autopilot;
+  copy.Calculate(kStart, kVelocity, kTarget);
+  APRecord record;
+  EXPECT_FALSE(ring.TryPop(record));
+}
+
+TEST(AutopilotTest, FrictionCircleLimitsTheVelocityStep) {
+  Autopilot autopilot{TranslatingProfile(APConstraints(4.5_mps, 8_mps_sq, 12.0)
+                                             .withDeceleration(5_mps_sq)
+                                             .withFrictionCircle())};
+
+  // Speeding up towards the goal spends the acceleration step
+  const frc::Translation2d along{1_m, 0_m};
+  EXPECT_NEAR(Step(autopilot.Calculate(kStart, along, kAhead), along),
+              8.0 * 0.02, 1e-12);
+
+  // Turning a sideways velocity towards the goal works against it, so the
+  // whole 2D change is held to the deceleration step and the sideways
+  // velocity dies off gradually
+  const frc::Translation2d sideways{0_m, 2_m};
+  const APResult turned = autopilot.Calculate(kStart, sideways, kAhead);
+  EXPECT_NEAR(Step(turned, sideways), 5.0 * 0.02, 1e-12);
+  EXPECT_GT(turned.vx.value(), 0.0);
+  EXPECT_GT(turned.vy.value(), 1.9);
+
+  // Without the friction circle only the component along the goal is kept
+  Autopilot split{TranslatingProfile(
+      APConstraints(4.5_mps, 8_mps_sq, 12.0).withDeceleration(5_mps_sq))};
+  EXPECT_EQ(split.Calculate(kStart, sideways, kAhead).vy.value(), 0.0);
+}
+
+TEST(AutopilotTest, BrakesWithDecelerationAndSpeedsUpWithAcceleration) {
+  Autopilot autopilot{TranslatingProfile(
+      APConstraints(4.5_mps, 8_mps_sq, 12.0).withDeceleration(5_mps_sq))};
+  EXPECT_TRUE(autopilot.Limits().decelerating);
+
+  // Moving away from the target brakes at the deceleration limit
+  const frc::Translation2d away{-2_m, 0_m};
+  EXPECT_NEAR(autopilot.Calculate(kStart, away, kAhead).vx.value(),
+              -2.0 + 5.0 * 0.02, 1e-12);
+
+  // Moving towards it speeds up at the acceleration limit
+  const frc::Translation2d towards{1_m, 0_m};
+  EXPECT_NEAR(autopilot.Calculate(kStart, towards, kAhead).vx.value(),
+              1.0 + 8.0 * 0.02, 1e-12);
+
+  // Without a deceleration limit, braking uses the acceleration limit
+  Autopilot symmetric{
+      TranslatingProfile(APConstraints(4.5_mps, 8_mps_sq, 12.0))};
+  EXPECT_FALSE(symmetric.Limits().decelerating);
+  EXPECT_NEAR(symmetric.Calculate(kStart, away, kAhead).vx.value(),
+              -2.0 + 8.0 * 0.02, 1e-12);
+}
+
+TEST(AutopilotTest, CapsEachRobotRelativeAxis) {
+  Autopilot autopilot{TranslatingProfile(
+      APConstraints(4.5_mps, 8_mps_sq, 12.0).withAxisVelocity(3_mps, 2_mps))};
+  EXPECT_TRUE(autopilot.Limits().axisLimited);
+  const frc::Translation2d fast{4_m, 0_m};
+
+  // Driving forwards, the goal is cut to the forward limit at once
+  EXPECT_NEAR(autopilot.Calculate(kStart, fast, kAhead).vx.value(), 3.0,
+              1e-12);
+
+  // Driving sideways, to the sideways limit
+  const frc::Pose2d sideways{0_m, 0_m, frc::Rotation2d{90_deg}};
+  EXPECT_NEAR(autopilot.Calculate(sideways, fast, kAhead).vx.value(), 2.0,
+              1e-12);
+
+  // At 45 degrees both axes see the goal over sqrt(2), and the tighter
+  // sideways limit sets the scale
+  const frc::Pose2d diagonal{0_m, 0_m, frc::Rotation2d{45_deg}};
+  const APResult result = autopilot.Calculate(diagonal, fast, kAhead);
+  EXPECT_NEAR(result.vx.value(), 2.0 * std::numbers::sqrt2, 1e-12);
+  EXPECT_NEAR(result.vy.value(), 0.0, 1e-12);
+}
+
+TEST(AutopilotTest, LatencyCompensationReplaysCommands) {
+  Autopilot autopilot{RotatingProfile()};
+  const frc::ChassisSpeeds velocity{.vx = 1_mps,
+                                    .vy = 0.5_mps,
+                                    .omega = units::radians_per_second_t{1.0}};
+
+  // Without commands, the pose moves on at the measured velocity
+  const frc::Pose2d coasted =
+      autopilot.PredictPose(APTimestampedPose{kStart, 0_s}, velocity, 0.1_s);
+  EXPECT_NEAR(coasted.X().value(), 0.1, 1e-12);
+  EXPECT_NEAR(coasted.Y().value(), 0.05, 1e-12);
+  EXPECT_NEAR(coasted.Rotation().Radians().value(), 0.1, 1e-12);
+
+  // A fresh pose is used as is, and its result becomes the command from 1 s
+  const APResult command =
+      autopilot.Calculate(APTimestampedPose{kStart, 1_s}, velocity, kTarget,
+                          1_s);
+  const APResult fresh = autopilot.Calculate(kStart, velocity, kTarget);
+  EXPECT_EQ(command.vx, fresh.vx);
+  EXPECT_EQ(command.vy, fresh.vy);
+  EXPECT_EQ(command.omega, fresh.omega);
+
+  // A pose measured at 0.9 s coasts until the command took effect, then
+  // follows the command
+  const APTimestampedPose stale{kStart, 0.9_s};
+  const frc::Pose2d predicted = autopilot.PredictPose(stale, velocity, 1.1_s);
+  EXPECT_NEAR(predicted.X().value(), 0.1 + command.vx.value() * 0.1, 1e-12);
+  EXPECT_NEAR(predicted.Y().value(), 0.05 + command.vy.value() * 0.1, 1e-12);
+  EXPECT_NEAR(predicted.Rotation().Radians().value(),
+              0.1 + command.omega.value() * 0.1, 1e-12);
+
+  // The timestamped Calculate drives from the predicted pose
+  const APResult expected =
+      autopilot.Preview(predicted, velocity, autopilot.Prepare(kTarget));
+  const APResult result = autopilot.Calculate(stale, velocity, kTarget, 1.1_s);
+  EXPECT_EQ(result.vx, expected.vx);
+  EXPECT_EQ(result.vy, expected.vy);
+  EXPECT_EQ(result.omega, expected.omega);
+
+  // Once cleared, the history no longer bends the prediction
+  autopilot.ClearCommandHistory();
+  const frc::Pose2d cleared = autopilot.PredictPose(stale, velocity, 1.1_s);
+  EXPECT_NEAR(cleared.X().value(), 0.2, 1e-12);
+  EXPECT_NEAR(cleared.Y().value(), 0.1, 1e-12);
+}
+
+TEST(AutopilotTest, RotationalProfileRespectsItsLimits) {
+  Autopilot autopilot{RotatingProfile()};
+  EXPECT_TRUE(autopilot.Limits().rotating);
+  constexpr double kDt = 0.02;
+  const double maxStep = 12.0 * kDt + 1e-12;
+
+  // Sitting on the target while spinning the wrong way, so that only the
+  // heading changes
+  double heading = 0.0;
+  double omega = -5.0;
+  for (int i = 0; i < 200; ++i) {
+    const frc::Pose2d pose{kTarget.Reference().Translation(),
+                           frc::Rotation2d{units::radian_t{heading}}};
+    const APResult result = autopilot.Calculate(
+        pose,
+        frc::ChassisSpeeds{.vx = 0_mps,
+                           .vy = 0_mps,
+                           .omega = units::radians_per_second_t{omega}},
+        kTarget);
+    EXPECT_LE(std::abs(result.omega.value()), 6.0 + 1e-12) << i;
+    // Every change is held to the acceleration step, except dropping back
+    // onto the goal profile while still turning the same way
+    const bool slowing = result.omega.value() * omega > 0.0 &&
+                         std::abs(result.omega.value()) < std::abs(omega);
+    if (!slowing) {
+      EXPECT_LE(std::abs(result.omega.value() - omega), maxStep) << i;
+    }
+    omega = result.omega.value();
+    heading += omega * kDt;
+  }
+  EXPECT_TRUE(autopilot.AtTarget(
+      frc::Pose2d{kTarget.Reference().Translation(),
+                  frc::Rotation2d{units::radian_t{heading}}},
+      kTarget));
+
+  // Without the rotational constraints there is no angular velocity
+  Autopilot still{TranslatingProfile(APConstraints(4.5_mps, 8_mps_sq, 12.0))};
+  EXPECT_FALSE(still.Limits().rotating);
+  EXPECT_EQ(
+      still.Calculate(kStart, frc::ChassisSpeeds{}, kTarget).omega.value(),
+      0.0);
+}
+
+TEST(AutopilotTest, PeriodAndDtScaleTheVelocityStep) {
+  Autopilot autopilot{
+      TranslatingProfile(APConstraints(4.5_mps, 8_mps_sq, 12.0))};
+  const frc::Translation2d towards{1_m, 0_m};
+  EXPECT_EQ(autopilot.Period(), 20_ms);
+  EXPECT_NEAR(Step(autopilot.Calculate(kStart, towards, kAhead), towards),
+              8.0 * 0.02, 1e-12);
+
+  autopilot.WithPeriod(50_ms);
+  EXPECT_EQ(autopilot.Period(), 50_ms);
+  EXPECT_NEAR(Step(autopilot.Calculate(kStart, towards, kAhead), towards),
+              8.0 * 0.05, 1e-12);
+
+  // The elapsed time overrides the period, unless it is not positive
+  EXPECT_NEAR(
+      Step(autopilot.Calculate(kStart, towards, kAhead, 10_ms), towards),
+      8.0 * 0.01, 1e-12);
+  EXPECT_NEAR(Step(autopilot.Calculate(kStart, towards, kAhead, 0_s), towards),
+              8.0 * 0.05, 1e-12);
+  EXPECT_NEAR(
+      Step(autopilot.Calculate(kStart, towards, kAhead, -10_ms), towards),
+      8.0 * 0.05, 1e-12);
+}
@@ -0,0 +1,198 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include <cmath>
+#include <filesystem>
+#include <numbers>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "autopilot/autopilot.h"
+#include "autopilot/velocity_field.h"
+#include "gtest/gtest.h"
+
+using namespace autopilot;
+
+namespace {
+constexpr size_t kCount = 1000;
+// The agreement Autopilot::Calculate documents for the batch
+constexpr double kTolerance = 1e-9;
+
+struct Batch {
+  std::vector<double> x, y, heading, vx, vy, omega;
+  std::vector<APTarget> targets;
+  APTargetBatch targetBatch;
+
+  APStateBatch States() const { return {x, y, heading, vx, vy, omega}; }
+};
+
+// Random states around random targets, with every kind of target option
+Batch MakeBatch(size_t count) {
+  std::mt19937 rng{42};
+  std::uniform_real_distribution<double> position{-8.0, 8.0};
+  std::uniform_real_distribution<double> speed{-3.0, 3.0};
+  std::uniform_real_distribution<double> angle{-std::numbers::pi,
+                                               std::numbers::pi};
+  Batch batch;
+  for (size_t i = 0; i < count; ++i) {
+    batch.x.push_back(position(rng));
+    batch.y.push_back(position(rng));
+    batch.heading.push_back(angle(rng));
+    batch.vx.push_back(speed(rng));
+    batch.vy.push_back(speed(rng));
+    batch.omega.push_back(speed(rng));
+
+    APTarget target{frc::Pose2d{units::meter_t{position(rng)},
+                                units::meter_t{position(rng)},
+                                frc::Rotation2d{units::radian_t{angle(rng)}}}};
+    if (i % 2 == 0) {
+      target = target.WithEntryAngle(
+          frc::Rotation2d{units::radian_t{angle(rng)}});
+    }
+    if (i % 3 == 0) {
+      target = target.WithVelocity(units::meters_per_second_t{i % 5 * 0.25});
+    }
+    if (i % 4 == 0) {
+      target = target.WithRotationRadius(units::meter_t{i % 7 * 0.5});
+    }
+    batch.targets.push_back(target);
+    batch.targetBatch.Add(target);
+  }
+  return batch;
+}
+
+void ExpectAgrees(Autopilot& autopilot, const Batch& batch) {
+  std::vector<APResult> out(batch.targets.size());
+  autopilot.Calculate(batch.States(), batch.targetBatch, out);
+  for (size_t i = 0; i < out.size(); ++i) {
+    const APResult scalar = autopilot.Calculate(
+        frc::Pose2d{units::meter_t{batch.x[i]}, units::meter_t{batch.y[i]},
+                    frc::Rotation2d{units::radian_t{batch.heading[i]}}},
+        frc::ChassisSpeeds{
+            .vx = units::meters_per_second_t{batch.vx[i]},
+            .vy = units::meters_per_second_t{batch.vy[i]},
+            .omega = units::radians_per_second_t{batch.omega[i]}},
+        batch.targets[i]);
+    EXPECT_NEAR(out[i].vx.value(), scalar.vx.value(), kTolerance) << i;
+    EXPECT_NEAR(out[i].vy.value(), scalar.vy.value(), kTolerance) << i;
+    EXPECT_NEAR((out[i].targetAngle - scalar.targetAngle).Radians().value(),
+                0.0, kTolerance)
+        << i;
+    EXPECT_NEAR(out[i].omega.value(), scalar.omega.value(), kTolerance) << i;
+  }
+}
+
+APProfile MakeProfile(const APConstraints& constraints) {
+  return APProfile{constraints}
+      .WithErrorXY(2_cm)
+      .WithErrorTheta(1_deg)
+      .WithBeelineRadius(8_cm);
+}
+}  // namespace
+
+TEST(BatchTest, MatchesScalar) {
+  Autopilot autopilot{MakeProfile(APConstraints{4.5_mps, 8_mps_sq, 12.0})};
+  ExpectAgrees(autopilot, MakeBatch(kCount));
+}
+
+TEST(BatchTest, MatchesScalarInFastMathMode) {
+  Autopilot autopilot{MakeProfile(APConstraints{4.5_mps, 8_mps_sq, 12.0})};
+  autopilot.WithMathMode(APMathMode::kFast);
+  ExpectAgrees(autopilot, MakeBatch(kCount));
+}
+
+TEST(BatchTest, MatchesScalarWithEveryConstraint) {
+  Autopilot autopilot{MakeProfile(
+      APConstraints{4.5_mps, 8_mps_sq, 12.0}
+          .withDeceleration(5_mps_sq)
+          .withAxisVelocity(3_mps, 2_mps)
+          .withRotationVelocity(units::radians_per_second_t{6.0})
+          .withRotationAcceleration(units::radians_per_second_squared_t{12.0})
+          .withRotationJerk(40.0))};
+  ExpectAgrees(autopilot, MakeBatch(kCount));
+}
+
+TEST(BatchTest, MatchesScalarWithFrictionCircle) {
+  Autopilot autopilot{MakeProfile(APConstraints{4.5_mps, 8_mps_sq, 12.0}
+                                      .withDeceleration(5_mps_sq)
+                                      .withFrictionCircle())};
+  ExpectAgrees(autopilot, MakeBatch(kCount));
+}
+
+TEST(BatchTest, StopsAtShortestSpan) {
+  Autopilot autopilot{MakeProfile(APConstraints{4.5_mps, 8_mps_sq, 12.0})};
+  Batch batch = MakeBatch(kCount);
+  batch.vy.resize(kCount / 2);
+  EXPECT_EQ(batch.States().Size(), kCount / 2);
+
+  // A short omega span limits the batch too, but an empty one does not
+  batch.omega.resize(kCount / 4);
+  EXPECT_EQ(batch.States().Size(), kCount / 4);
+  batch.omega.clear();
+  EXPECT_EQ(batch.States().Size(), kCount / 2);
+
+  const APResult untouched{
+      .vx = 123_mps, .vy = 456_mps, .targetAngle = frc::Rotation2d{}};
+  std::vector<APResult> out(kCount, untouched);
+  autopilot.Calculate(batch.States(), batch.targetBatch, out);
+  for (size_t i = kCount / 2; i < kCount; ++i) {
+    EXPECT_EQ(out[i].vx, untouched.vx) << i;
+    EXPECT_EQ(out[i].vy, untouched.vy) << i;
+  }
+}
+
+TEST(BatchTest, IgnoresVelocityField) {
+  const APProfile profile =
+      MakeProfile(APConstraints{4.5_mps, 8_mps_sq, 12.0});
+  Autopilot exact{profile};
+  Autopilot baked{profile};
+  const Batch batch = MakeBatch(kCount / 10);
+  std::vector<APTarget> entering;
+  for (const APTarget& target : batch.targets) {
+    if (target.EntryAngle().has_value()) {
+      entering.push_back(target);
+    }
+  }
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "autopilot_batch_test.bin")
+          .string();
+  ASSERT_TRUE(APVelocityField::Bake(baked, entering, 4_m,
+                                    units::meter_t{0.1}, path));
+  std::optional<APVelocityField> velocityField = APVelocityField::Load(path);
+  ASSERT_TRUE(velocityField.has_value());
+  baked.WithVelocityField(&*velocityField);
+
+  std::vector<APResult> exactOut(batch.targets.size());
+  std::vector<APResult> bakedOut(batch.targets.size());
+  exact.Calculate(batch.States(), batch.targetBatch, exactOut);
+  baked.Calculate(batch.States(), batch.targetBatch, bakedOut);
+  size_t looked = 0;
+  for (size_t i = 0; i < exactOut.size(); ++i) {
+    EXPECT_EQ(bakedOut[i].vx.value(), exactOut[i].vx.value()) << i;
+    EXPECT_EQ(bakedOut[i].vy.value(), exactOut[i].vy.value()) << i;
+    EXPECT_EQ(bakedOut[i].omega.value(), exactOut[i].omega.value()) << i;
+
+    // The scalar Calculate does look the goals up
+    const APResult scalar = baked.Calculate(
+        frc::Pose2d{units::meter_t{batch.x[i]}, units::meter_t{batch.y[i]},
+                    frc::Rotation2d{units::radian_t{batch.heading[i]}}},
+        frc::ChassisSpeeds{
+            .vx = units::meters_per_second_t{batch.vx[i]},
+            .vy = units::meters_per_second_t{batch.vy[i]},
+            .omega = units::radians_per_second_t{batch.omega[i]}},
+        batch.targets[i]);
+    if (scalar.vx != exactOut[i].vx || scalar.vy != exactOut[i].vy) {
+      ++looked;
+    }
+  }
+  EXPECT_GT(looked, 0u);
+  ExpectAgrees(exact, batch);
+  std::filesystem::remove(path);
+}
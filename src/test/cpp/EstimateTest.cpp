@@ -0,0 +1,166 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <vector>
+
+#include "autopilot/autopilot.h"
+#include "autopilot/rollout.h"
+#include "gtest/gtest.h"
+
+using namespace autopilot;
+
+namespace {
+// The bound Autopilot::EstimateTimeToTarget documents: a relative error on
+// top of the one step a rollout can overshoot the estimate by
+constexpr double kRelativeError = 0.03;
+
+// Within this angle of directly behind the entry angle, the swirly path can
+// fold either way around the target and the estimate is not bounded
+constexpr double kFoldAngle = std::numbers::pi / 6.0;
+
+constexpr int kScenarios = 500;
+
+APProfile SlowProfile() {
+  return APProfile(APConstraints(4.5_mps, 3.0_mps_sq, 2.0))
+      .WithErrorXY(2_cm)
+      .WithErrorTheta(2_deg)
+      .WithBeelineRadius(8_cm);
+}
+
+APProfile FastProfile() {
+  return APProfile(APConstraints(4.5_mps, 8.0_mps_sq, 12.0))
+      .WithErrorXY(2_cm)
+      .WithErrorTheta(2_deg)
+      .WithBeelineRadius(8_cm);
+}
+
+/**
+ * Rolls out random starts towards a target at the origin, and checks every
+ * estimate against the rollout's time to arrive. Returns the share of the
+ * starts near the fold whose estimate was within the bound.
+ */
+double ExpectWithinBound(const APProfile& profile, bool entryAngle) {
+  Autopilot autopilot{profile};
+  APRolloutEngine engine{autopilot, APRolloutOptions{.timeout = 30_s}};
+  const double step = engine.Options().step.value();
+  std::vector<APRolloutSample> path(4096);
+
+  std::mt19937 rng{2025};
+  std::uniform_real_distribution<double> angle{-std::numbers::pi,
+                                               std::numbers::pi};
+  std::uniform_real_distribution<double> distance{0.5, 8.0};
+  std::uniform_real_distribution<double> speed{-2.0, 2.0};
+  int folded = 0;
+  int foldedWithin = 0;
+  for (int i = 0; i < kScenarios; ++i) {
+    const double bearing = angle(rng);
+    const frc::Pose2d start{
+        frc::Translation2d{units::meter_t{distance(rng)},
+                           frc::Rotation2d{units::radian_t{bearing}}},
+        frc::Rotation2d{}};
+    const frc::Translation2d velocity{units::meter_t{speed(rng)},
+                                      units::meter_t{speed(rng)}};
+    APTarget target{frc::Pose2d{}};
+    // The polar angle of the offset to the target in the target's frame,
+    // which is +-pi directly behind the entry angle
+    double theta = 0.0;
+    if (entryAngle) {
+      const double entry = angle(rng);
+      target = target.WithEntryAngle(units::radian_t{entry});
+      theta = std::remainder(bearing + std::numbers::pi - entry,
+                             2.0 * std::numbers::pi);
+    }
+
+    const APRolloutResult rollout = engine.Run(start, velocity, target, path);
+    EXPECT_EQ(rollout.status, APRolloutStatus::kAtTarget) << i;
+    const double actual = rollout.time.value();
+    const double estimate =
+        autopilot.EstimateTimeToTarget(start, velocity, target).value();
+    const double bound = kRelativeError * actual + step;
+    if (std::abs(theta) > std::numbers::pi - kFoldAngle) {
+      ++folded;
+      foldedWithin += std::abs(estimate - actual) <= bound ? 1 : 0;
+    } else {
+      EXPECT_NEAR(estimate, actual, bound) << i;
+    }
+  }
+  return folded > 0 ? static_cast<double>(foldedWithin) / folded : 1.0;
+}
+}  // namespace
+
+TEST(EstimateTest, MatchesRolloutsWithoutEntryAngle) {
+  ExpectWithinBound(SlowProfile(), false);
+  ExpectWithinBound(FastProfile(), false);
+}
+
+TEST(EstimateTest, MatchesRolloutsWithEntryAngle) {
+  // Most starts near the fold still follow the path the estimate assumes
+  EXPECT_GE(ExpectWithinBound(SlowProfile(), true), 0.9);
+  EXPECT_GE(ExpectWithinBound(FastProfile(), true), 0.9);
+}
+
+TEST(EstimateTest, IsZeroAtTarget) {
+  Autopilot autopilot{SlowProfile()};
+  const APTarget target =
+      APTarget{frc::Pose2d{1_m, 2_m, frc::Rotation2d{}}}.WithEntryAngle(
+          frc::Rotation2d{units::radian_t{1.0}});
+  EXPECT_EQ(autopilot.EstimateTimeToTarget(target.Reference(),
+                                           frc::Translation2d{}, target),
+            0_s);
+}
+
+TEST(EstimateTest, IsFiniteWithoutADirection) {
+  // Too close for the offset to have a direction, but not exactly on the
+  // target
+  Autopilot autopilot{SlowProfile()};
+  const APTarget target =
+      APTarget{frc::Pose2d{}}.WithEntryAngle(frc::Rotation2d{});
+  const units::second_t estimate = autopilot.EstimateTimeToTarget(
+      frc::Pose2d{units::meter_t{-1e-7}, 0_m, frc::Rotation2d{}},
+      frc::Translation2d{}, target);
+  EXPECT_TRUE(std::isfinite(estimate.value()));
+  EXPECT_GE(estimate, 0_s);
+}
+
+TEST(EstimateTest, IsInfiniteWithoutAcceleration) {
+  Autopilot autopilot{APProfile{APConstraints{4.5_mps, 0_mps_sq, 2.0}}};
+  const APTarget target{frc::Pose2d{}};
+  EXPECT_TRUE(std::isinf(
+      autopilot
+          .EstimateTimeToTarget(frc::Pose2d{2_m, 0_m, frc::Rotation2d{}},
+                                frc::Translation2d{}, target)
+          .value()));
+}
+
+TEST(EstimateTest, NeverBeatsMinimum) {
+  Autopilot autopilot{FastProfile()};
+  std::mt19937 rng{7};
+  std::uniform_real_distribution<double> position{-8.0, 8.0};
+  std::uniform_real_distribution<double> speed{-2.0, 2.0};
+  std::uniform_real_distribution<double> angle{-std::numbers::pi,
+                                               std::numbers::pi};
+  for (int i = 0; i < kScenarios; ++i) {
+    const frc::Pose2d start{units::meter_t{position(rng)},
+                            units::meter_t{position(rng)}, frc::Rotation2d{}};
+    const APTarget target = APTarget{frc::Pose2d{}}.WithEntryAngle(
+        frc::Rotation2d{units::radian_t{angle(rng)}});
+    const units::second_t estimate = autopilot.EstimateTimeToTarget(
+        start,
+        frc::Translation2d{units::meter_t{speed(rng)},
+                           units::meter_t{speed(rng)}},
+        target);
+    EXPECT_GE(estimate.value(),
+              autopilot.MinimumTimeToTarget(start.Translation().Norm(), 0_mps)
+                      .value() -
+                  1e-9)
+        << i;
+  }
+}
@@ -0,0 +1,97 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include <units/math.h>
+
+#include "autopilot/autopilot.h"
+#include "autopilot/intercept.h"
+#include "autopilot/moving_target.h"
+#include "gtest/gtest.h"
+
+using namespace autopilot;
+
+namespace {
+APProfile MakeProfile() {
+  return APProfile{APConstraints{4.5_mps, 8_mps_sq, 12.0}}
+      .WithErrorXY(2_cm)
+      .WithErrorTheta(2_deg)
+      .WithBeelineRadius(8_cm);
+}
+
+const APTarget kTarget =
+    APTarget{frc::Pose2d{4_m, 0_m, frc::Rotation2d{}}}.WithEntryAngle(
+        frc::Rotation2d{});
+
+// Crossing in front of the robot at a third of its top speed
+const APMovingTarget kSlow{kTarget, frc::Translation2d{0_m, 1.5_m}};
+
+// Running away from the robot at twice its top speed
+const APMovingTarget kFast{kTarget, frc::Translation2d{9_m, 0_m}};
+}  // namespace
+
+TEST(InterceptTest, ConvergesOnASlowerTarget) {
+  Autopilot autopilot{MakeProfile()};
+  APInterceptor interceptor{autopilot};
+  const APIntercept intercept =
+      interceptor.Solve(frc::Pose2d{}, frc::Translation2d{}, kSlow);
+
+  EXPECT_TRUE(intercept.converged);
+  EXPECT_LE(intercept.estimates, APInterceptor::kMaxEstimates);
+  EXPECT_GT(intercept.time, 0_s);
+  // Reaching the target as it will be then takes just that long
+  const units::second_t reach = autopilot.EstimateTimeToTarget(
+      frc::Pose2d{}, frc::Translation2d{}, kSlow.At(intercept.time));
+  EXPECT_LE(units::math::abs(reach - intercept.time),
+            APInterceptor::kTolerance);
+  EXPECT_EQ(intercept.target.Reference().Translation(),
+            kSlow.PositionAt(intercept.time));
+  ASSERT_TRUE(interceptor.Last().has_value());
+  EXPECT_EQ(interceptor.Last()->time, intercept.time);
+}
+
+TEST(InterceptTest, WarmStartNeedsFewEstimates) {
+  Autopilot autopilot{MakeProfile()};
+  APInterceptor interceptor{autopilot};
+  constexpr double kDt = 0.02;
+
+  // Drive the intercept for a second, measuring the target afresh each tick
+  frc::Pose2d pose;
+  frc::ChassisSpeeds velocity;
+  for (int i = 0; i < 50; ++i) {
+    const units::second_t elapsed{i * kDt};
+    const APMovingTarget measured{kSlow.At(elapsed), kSlow.Velocity()};
+    const APResult result = interceptor.Calculate(pose, velocity, measured);
+    const APIntercept& intercept = *interceptor.Last();
+    EXPECT_TRUE(intercept.converged) << i;
+    if (i > 0) {
+      EXPECT_LE(intercept.estimates, 2) << i;
+    }
+
+    velocity = frc::ChassisSpeeds{.vx = result.vx, .vy = result.vy};
+    pose = frc::Pose2d{pose.X() + result.vx * units::second_t{kDt},
+                       pose.Y() + result.vy * units::second_t{kDt},
+                       pose.Rotation()};
+  }
+
+  // After a reset the solve starts cold again
+  interceptor.Reset();
+  EXPECT_FALSE(interceptor.Last().has_value());
+}
+
+TEST(InterceptTest, GivesUpAtTheHorizonForAFasterTarget) {
+  Autopilot autopilot{MakeProfile()};
+  APInterceptor interceptor{autopilot, 3_s};
+  const APIntercept intercept =
+      interceptor.Solve(frc::Pose2d{}, frc::Translation2d{}, kFast);
+
+  EXPECT_FALSE(intercept.converged);
+  EXPECT_LE(intercept.estimates, APInterceptor::kMaxEstimates);
+  EXPECT_EQ(intercept.time, 3_s);
+  EXPECT_EQ(intercept.target.Reference().Translation(),
+            kFast.PositionAt(3_s));
+}
@@ -0,0 +1,367 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <numbers>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "allocation_guard.h"
+#include "autopilot/autopilot.h"
+#include "autopilot/batch.h"
+#include "autopilot/intercept.h"
+#include "autopilot/moving_target.h"
+#include "autopilot/static_autopilot.h"
+#include "autopilot/telemetry.h"
+#include "autopilot/velocity_field.h"
+#include "gtest/gtest.h"
+
+using namespace autopilot;
+
+namespace {
+// Randomized calls per configuration
+constexpr size_t kCalls = 20000;
+
+// Records buffered for the telemetry configuration. Kept small so that the
+// ring also fills up and drops records.
+constexpr size_t kRingCapacity = 64;
+
+constexpr size_t kBakedTargets = 4;
+
+constexpr APStaticProfile kStaticProfile{
+    .velocity = 4.5,
+    .acceleration = 3.0,
+    .jerk = 2.0,
+    .errorXY = 0.02,
+    .errorTheta = 2.0 * std::numbers::pi / 180.0,
+    .beelineRadius = 0.08,
+    .rotationVelocity = 6.0,
+    .rotationAcceleration = 12.0,
+    .rotationJerk = 40.0,
+    .frictionCircle = true,
+    .deceleration = 8.0,
+    .velocityX = 3.0,
+    .velocityY = 1.5};
+
+// Every call the per-tick path is made of must be noexcept
+static_assert(noexcept(std::declval<Autopilot&>().Calculate(
+    std::declval<const frc::Pose2d&>(),
+    std::declval<const frc::Translation2d&>(),
+    std::declval<const APTarget&>())));
+static_assert(noexcept(std::declval<Autopilot&>().Calculate(
+    std::declval<const frc::Pose2d&>(),
+    std::declval<const frc::ChassisSpeeds&>(),
+    std::declval<const APPreparedTarget&>(),
+    std::declval<units::second_t>())));
+static_assert(noexcept(std::declval<Autopilot&>().Calculate(
+    std::declval<const APTimestampedPose&>(),
+    std::declval<const frc::ChassisSpeeds&>(),
+    std::declval<const APTarget&>(), std::declval<units::second_t>(),
+    std::declval<units::second_t>())));
+static_assert(noexcept(std::declval<Autopilot&>().Calculate(
+    std::declval<const APStateBatch&>(), std::declval<const APTargetBatch&>(),
+    std::declval<std::span<APResult>>())));
+static_assert(noexcept(
+    std::declval<const Autopilot&>().Prepare(std::declval<const APTarget&>())));
+static_assert(noexcept(std::declval<const Autopilot&>().AtTarget(
+    std::declval<const frc::Pose2d&>(), std::declval<const APTarget&>())));
+static_assert(noexcept(
+    std::declval<const StaticAutopilot<kStaticProfile>&>().Calculate(
+        std::declval<const frc::Pose2d&>(),
+        std::declval<const frc::ChassisSpeeds&>(),
+        std::declval<const APPreparedTarget&>())));
+static_assert(noexcept(std::declval<APInterceptor&>().Calculate(
+    std::declval<const frc::Pose2d&>(),
+    std::declval<const frc::ChassisSpeeds&>(),
+    std::declval<const APMovingTarget&>(),
+    std::declval<units::second_t>())));
+static_assert(noexcept(std::declval<const APTarget&>().WithEntryAngle(
+    std::declval<const frc::Rotation2d&>())));
+
+// The fast math tables are constants, so the first fast call does no more
+// work than any other and no call is made to warm them up
+static_assert(fast::detail::kSwirlyTable<double>[0].value == 1.0);
+static_assert(fast::detail::kSwirlyTable<float>[0].value == 1.0f);
+static_assert(fast::detail::kSwirlyTable<core::Fixed>[0].value ==
+              core::Fixed{1});
+
+APProfile BaseProfile() {
+  return APProfile(APConstraints(4.5_mps, 3.0_mps_sq, 2.0))
+      .WithErrorXY(2_cm)
+      .WithErrorTheta(2_deg)
+      .WithBeelineRadius(8_cm);
+}
+
+// Every constraint at once. Without a beeline radius the swirly path runs
+// all the way into the target.
+APProfile LimitedProfile() {
+  return APProfile(BaseProfile())
+      .WithBeelineRadius(0_m)
+      .WithConstraints(
+          APConstraints(4.5_mps, 3.0_mps_sq, 2.0)
+              .withRotationVelocity(units::radians_per_second_t{6.0})
+              .withRotationAcceleration(
+                  units::radians_per_second_squared_t{12.0})
+              .withRotationJerk(40.0)
+              .withFrictionCircle(true)
+              .withDeceleration(8.0_mps_sq)
+              .withAxisVelocity(3.0_mps, 1.5_mps));
+}
+
+struct Call {
+  frc::Pose2d pose;
+  frc::ChassisSpeeds velocity;
+  APTarget target;
+  // For the interceptor, which moves the target
+  frc::Translation2d targetVelocity;
+  units::second_t measuredAt;
+  units::second_t dt;
+  // Picks the Calculate overload
+  uint32_t overload;
+};
+
+// Draws one call. Targets are built with every With* builder, so drawing is
+// part of what is checked. Offsets are mostly spread over the field, with
+// some vanishingly small or exactly zero, where direction vectors
+// degenerate.
+Call Draw(std::mt19937& rng, std::span<const APTarget> baked) {
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  std::uniform_real_distribution<double> field(-8.0, 8.0);
+  std::uniform_real_distribution<double> angle(-std::numbers::pi,
+                                               std::numbers::pi);
+  std::uniform_real_distribution<double> speed(-4.0, 4.0);
+
+  const APTarget base{
+      frc::Pose2d{units::meter_t{field(rng)}, units::meter_t{field(rng)},
+                  frc::Rotation2d{units::radian_t{angle(rng)}}}};
+  std::optional<APTarget> target;
+  const double pick = unit(rng);
+  if (!baked.empty() && pick < 0.75) {
+    target = baked[rng() % baked.size()];
+  } else if (pick < 0.4) {
+    target = APTarget{base.Reference()}
+                 .WithEntryAngle(frc::Rotation2d{units::radian_t{angle(rng)}})
+                 .WithVelocity(units::meters_per_second_t{unit(rng)})
+                 .WithRotationRadius(units::meter_t{2.0 * unit(rng)});
+  } else if (pick < 0.7) {
+    target = base.WithEntryAngle(frc::Rotation2d{units::radian_t{angle(rng)}})
+                 .WithReference(base.Reference());
+  } else if (pick < 0.85) {
+    target = base.WithVelocity(units::meters_per_second_t{unit(rng)})
+                 .WithoutEntryAngle();
+  } else {
+    target = base.WithRotationRadius(units::meter_t{unit(rng)});
+  }
+
+  const double placement = unit(rng);
+  double radius = 8.0 * unit(rng);
+  if (placement < 0.02) {
+    radius = 0.0;
+  } else if (placement < 0.12) {
+    radius = std::pow(10.0, -12.0 + 9.0 * unit(rng));
+  }
+  const double direction = angle(rng);
+  const frc::Pose2d& reference = target->Reference();
+  return Call{
+      .pose = frc::Pose2d{reference.X() -
+                              units::meter_t{radius * std::cos(direction)},
+                          reference.Y() -
+                              units::meter_t{radius * std::sin(direction)},
+                          frc::Rotation2d{units::radian_t{angle(rng)}}},
+      .velocity =
+          frc::ChassisSpeeds{
+              .vx = units::meters_per_second_t{speed(rng)},
+              .vy = units::meters_per_second_t{speed(rng)},
+              .omega = units::radians_per_second_t{1.5 * speed(rng)}},
+      .target = *target,
+      .targetVelocity = frc::Translation2d{units::meter_t{0.5 * speed(rng)},
+                                           units::meter_t{0.5 * speed(rng)}},
+      // Mostly in the past, sometimes slightly in the future
+      .measuredAt = units::second_t{0.3 * unit(rng) - 0.25},
+      .dt = unit(rng) < 0.5 ? 0_s : units::second_t{0.005 + 0.03 * unit(rng)},
+      .overload = static_cast<uint32_t>(rng() % 6)};
+}
+
+// Makes one call through the overload the call picks, as the robot would on
+// a tick, and returns a value that depends on its result
+double Tick(Autopilot& autopilot, const Call& call, units::second_t now) {
+  const APTimestampedPose measured{call.pose, now + call.measuredAt};
+  const frc::Translation2d velocity{
+      units::meter_t{call.velocity.vx.value()},
+      units::meter_t{call.velocity.vy.value()}};
+  APResult result;
+  switch (call.overload) {
+    case 0:
+      result = autopilot.Calculate(call.pose, velocity, call.target);
+      break;
+    case 1:
+      result = autopilot.Calculate(call.pose, velocity, call.target, call.dt);
+      break;
+    case 2:
+      result =
+          autopilot.Calculate(call.pose, call.velocity, call.target, call.dt);
+      break;
+    case 3:
+      result = autopilot.Calculate(call.pose, call.velocity,
+                                   autopilot.Prepare(call.target), call.dt);
+      break;
+    case 4:
+      result = autopilot.Calculate(measured, call.velocity, call.target, now,
+                                   call.dt);
+      break;
+    default:
+      result = autopilot.Calculate(measured, call.velocity,
+                                   autopilot.Prepare(call.target), now,
+                                   call.dt);
+      break;
+  }
+  return result.vx.value() + result.omega.value() +
+         (autopilot.AtTarget(call.pose, call.target) ? 1 : 0);
+}
+
+/**
+ * Draws the calls, then makes them all with the guard up and expects none
+ * of them to allocate.
+ */
+template <typename F>
+void ExpectNoAllocations(F&& run, std::span<const APTarget> baked = {}) {
+  std::mt19937 rng{5805};
+  std::vector<Call> calls;
+  calls.reserve(kCalls);
+  for (size_t i = 0; i < kCalls; ++i) {
+    calls.push_back(Draw(rng, baked));
+  }
+
+  // Keeps the calls from being optimized away
+  volatile double sink = 0.0;
+  size_t count = 0;
+  size_t firstSize = 0;
+  {
+    AllocationGuard guard;
+    for (size_t i = 0; i < calls.size(); ++i) {
+      sink = sink + run(calls[i], units::second_t{0.02 * i});
+    }
+    count = guard.Count();
+    firstSize = guard.FirstSize();
+  }
+  EXPECT_EQ(count, 0u) << "the first allocation was " << firstSize
+                       << " bytes";
+}
+}  // namespace
+
+TEST(RealtimeTest, ExactDoesNotAllocate) {
+  Autopilot autopilot{BaseProfile()};
+  ExpectNoAllocations([&](const Call& call, units::second_t now) {
+    return Tick(autopilot, call, now);
+  });
+}
+
+TEST(RealtimeTest, FastDoesNotAllocate) {
+  Autopilot autopilot{BaseProfile()};
+  autopilot.WithMathMode(APMathMode::kFast);
+  ExpectNoAllocations([&](const Call& call, units::second_t now) {
+    return Tick(autopilot, call, now);
+  });
+}
+
+TEST(RealtimeTest, LimitedDoesNotAllocate) {
+  Autopilot autopilot{LimitedProfile()};
+  ExpectNoAllocations([&](const Call& call, units::second_t now) {
+    return Tick(autopilot, call, now);
+  });
+}
+
+TEST(RealtimeTest, RecordingDoesNotAllocate) {
+  Autopilot autopilot{LimitedProfile()};
+  APTelemetryRing ring{kRingCapacity};
+  autopilot.WithTelemetry(&ring);
+  size_t calls = 0;
+  ExpectNoAllocations([&](const Call& call, units::second_t now) {
+    const double result = Tick(autopilot, call, now);
+    // Drain the ring now and then, as a logger would from its own thread
+    if (++calls % (2 * kRingCapacity) == 0) {
+      APRecord record;
+      while (ring.TryPop(record)) {
+      }
+    }
+    return result;
+  });
+  EXPECT_GT(ring.Dropped(), 0u);
+}
+
+TEST(RealtimeTest, BakedDoesNotAllocate) {
+  Autopilot autopilot{BaseProfile()};
+  std::mt19937 rng{5805};
+  std::uniform_real_distribution<double> field(-6.0, 6.0);
+  std::uniform_real_distribution<double> angle(-std::numbers::pi,
+                                               std::numbers::pi);
+  std::vector<APTarget> baked;
+  for (size_t i = 0; i < kBakedTargets; ++i) {
+    baked.push_back(
+        APTarget{frc::Pose2d{units::meter_t{field(rng)},
+                             units::meter_t{field(rng)},
+                             frc::Rotation2d{units::radian_t{angle(rng)}}}}
+            .WithEntryAngle(frc::Rotation2d{units::radian_t{angle(rng)}}));
+  }
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "autopilot_realtime_test.bin")
+          .string();
+  ASSERT_TRUE(APVelocityField::Bake(autopilot, baked, 4_m,
+                                    units::meter_t{0.1}, path));
+  std::optional<APVelocityField> velocityField = APVelocityField::Load(path);
+  ASSERT_TRUE(velocityField.has_value());
+  autopilot.WithVelocityField(&*velocityField);
+
+  ExpectNoAllocations(
+      [&](const Call& call, units::second_t now) {
+        return Tick(autopilot, call, now);
+      },
+      baked);
+  std::filesystem::remove(path);
+}
+
+TEST(RealtimeTest, StaticDoesNotAllocate) {
+  const StaticAutopilot<kStaticProfile> autopilot;
+  ExpectNoAllocations([&](const Call& call, units::second_t) {
+    const frc::Translation2d velocity{
+        units::meter_t{call.velocity.vx.value()},
+        units::meter_t{call.velocity.vy.value()}};
+    const APResult result =
+        call.overload % 2 == 0
+            ? autopilot.Calculate(call.pose, call.velocity,
+                                  autopilot.Prepare(call.target))
+            : autopilot.Calculate(call.pose, velocity, call.target);
+    return result.vx.value() + result.omega.value() +
+           (autopilot.AtTarget(call.pose, call.target) ? 1 : 0);
+  });
+}
+
+TEST(RealtimeTest, InterceptDoesNotAllocate) {
+  Autopilot autopilot{BaseProfile()};
+  APInterceptor interceptor{autopilot};
+  ExpectNoAllocations([&](const Call& call, units::second_t) {
+    // Some solves start cold, and some targets also accelerate
+    if (call.overload == 0) {
+      interceptor.Reset();
+    }
+    const APMovingTarget moving{call.target, call.targetVelocity};
+    const APResult result = interceptor.Calculate(
+        call.pose, call.velocity,
+        call.overload == 1
+            ? moving.WithAcceleration(call.targetVelocity * 0.5)
+            : moving,
+        call.dt);
+    return result.vx.value() + result.omega.value();
+  });
+}
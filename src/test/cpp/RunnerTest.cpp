@@ -0,0 +1,124 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include <wpi/timestamp.h>
+
+#include <chrono>
+#include <functional>
+#include <thread>
+
+#include "autopilot/autopilot.h"
+#include "autopilot/runner.h"
+#include "autopilot/triple_buffer.h"
+#include "gtest/gtest.h"
+
+using namespace autopilot;
+
+namespace {
+// Two halves that a torn read would leave out of step
+struct Pair {
+  int value = 0;
+  int negated = 0;
+};
+
+APProfile MakeProfile() {
+  return APProfile{APConstraints{4.5_mps, 8_mps_sq, 12.0}}
+      .WithErrorXY(2_cm)
+      .WithErrorTheta(2_deg)
+      .WithBeelineRadius(8_cm);
+}
+
+// Polls the runner until its latest output satisfies done, for up to two
+// seconds
+bool WaitFor(APRunner& runner,
+             const std::function<bool(const APRunnerOutput&)>& done) {
+  for (int i = 0; i < 400; ++i) {
+    if (done(runner.Latest())) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds{5});
+  }
+  return false;
+}
+
+units::second_t Now() {
+  return units::second_t{static_cast<double>(wpi::Now()) * 1e-6};
+}
+}  // namespace
+
+TEST(RunnerTest, TripleBufferReadsTheLatestWrite) {
+  APTripleBuffer<int> buffer{7};
+  bool fresh = true;
+  EXPECT_EQ(buffer.Read(&fresh), 7);
+  EXPECT_FALSE(fresh);
+
+  // Values the consumer missed are overwritten, not queued
+  buffer.Write(1);
+  buffer.Write(2);
+  EXPECT_EQ(buffer.Read(&fresh), 2);
+  EXPECT_TRUE(fresh);
+  EXPECT_EQ(buffer.Read(&fresh), 2);
+  EXPECT_FALSE(fresh);
+
+  buffer.Write(3);
+  EXPECT_EQ(buffer.Read(), 3);
+}
+
+TEST(RunnerTest, TripleBufferHandsOffAcrossThreads) {
+  constexpr int kWrites = 200000;
+  APTripleBuffer<Pair> buffer;
+  std::thread producer{[&] {
+    for (int i = 1; i <= kWrites; ++i) {
+      buffer.Write(Pair{i, -i});
+    }
+  }};
+
+  // Every read is a whole value, and never older than the one before
+  int last = 0;
+  while (last < kWrites) {
+    const Pair& pair = buffer.Read();
+    ASSERT_EQ(pair.value, -pair.negated);
+    ASSERT_GE(pair.value, last);
+    last = pair.value;
+  }
+  producer.join();
+  EXPECT_EQ(buffer.Read().value, kWrites);
+}
+
+TEST(RunnerTest, RunnerPublishesTicks) {
+  const Autopilot autopilot{MakeProfile()};
+  APRunner runner{autopilot, 5_ms};
+  EXPECT_EQ(runner.Period(), 5_ms);
+  EXPECT_FALSE(runner.IsRunning());
+
+  runner.Start();
+  EXPECT_TRUE(runner.IsRunning());
+  // Without a target and a state, ticks publish invalid outputs
+  ASSERT_TRUE(WaitFor(runner, [](const APRunnerOutput& output) {
+    return output.timestamp > 0_s && !output.valid;
+  }));
+
+  runner.SetTarget(APTarget{frc::Pose2d{5_m, 0_m, frc::Rotation2d{}}});
+  runner.SetState(APTimestampedPose{frc::Pose2d{}, Now()},
+                  frc::ChassisSpeeds{});
+  ASSERT_TRUE(WaitFor(runner, [](const APRunnerOutput& output) {
+    return output.valid;
+  }));
+  const APRunnerOutput output = runner.Latest();
+  EXPECT_GT(output.result.vx.value(), 0.0);
+  EXPECT_FALSE(output.atTarget);
+
+  runner.ClearTarget();
+  EXPECT_TRUE(WaitFor(runner, [](const APRunnerOutput& output) {
+    return !output.valid;
+  }));
+
+  runner.Stop();
+  EXPECT_FALSE(runner.IsRunning());
+  EXPECT_GT(runner.Stats().ticks, 0u);
+}
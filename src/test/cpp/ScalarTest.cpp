@@ -0,0 +1,184 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "autopilot/core.h"
+#include "autopilot/scalar.h"
+#include "gtest/gtest.h"
+
+using namespace autopilot;
+using core::Fixed;
+
+namespace {
+constexpr Fixed kMax = std::numeric_limits<Fixed>::max();
+constexpr Fixed kLowest = std::numeric_limits<Fixed>::lowest();
+
+// Half a unit of Fixed's resolution, the most rounding to nearest can lose
+constexpr double kHalfUnit = 0.5 / Fixed::kOne;
+
+// The bounds on core::Calculate against double that core::scalar documents
+// for 99% of inputs
+constexpr double kFloatVelocity = 1e-6;
+constexpr double kFixedVelocity = 2e-4;
+constexpr double kFloatOmega = 5e-7;
+constexpr double kFixedOmega = 2.5e-4;
+
+constexpr int kSamples = 10000;
+
+core::Rotation FromAngle(double angle) {
+  return core::Rotation{std::cos(angle), std::sin(angle)};
+}
+
+struct Error {
+  double velocity = 0.0;
+  double omega = 0.0;
+};
+
+double Percentile99(std::vector<double>& errors) {
+  const auto nth = errors.begin() + errors.size() * 99 / 100;
+  std::nth_element(errors.begin(), nth, errors.end());
+  return *nth;
+}
+
+/**
+ * Runs core::Calculate in T and in double over random states around a
+ * target with an entry angle, and returns the 99th percentiles of the
+ * absolute errors of the velocity, as a vector, and of the angular velocity.
+ */
+template <typename T>
+Error CalculateError() {
+  const core::Profile profile{.velocity = 4.5,
+                              .acceleration = 3.0,
+                              .jerk = 2.0,
+                              .errorXY = 0.02,
+                              .errorTheta = 2.0 * std::numbers::pi / 180.0,
+                              .beelineRadius = 0.08,
+                              .rotationVelocity = 6.0,
+                              .rotationAcceleration = 12.0,
+                              .rotationJerk = 30.0};
+  const core::Target target =
+      core::Prepare(profile, core::Pose{.rotation = FromAngle(0.4)}, 0.0,
+                    FromAngle(0.7), std::nullopt);
+  const core::Limits exactLimits = core::Fold(profile);
+  const core::BasicLimits<T> limits = core::Fold<T>(profile);
+  const core::BasicTarget<T> cast = core::Cast<T>(target);
+  const T dt = core::detail::Narrow<T>(profile.period);
+
+  std::mt19937 rng{254};
+  std::uniform_real_distribution<double> angle(-std::numbers::pi,
+                                               std::numbers::pi);
+  std::uniform_real_distribution<double> dist(0.1, 6.0);
+  std::uniform_real_distribution<double> speed(-4.0, 4.0);
+  std::vector<double> velocityErrors;
+  std::vector<double> omegaErrors;
+  for (int i = 0; i < kSamples; ++i) {
+    const core::Rotation direction = FromAngle(angle(rng));
+    const double d = dist(rng);
+    const core::Pose pose{d * direction.cos, d * direction.sin,
+                          FromAngle(angle(rng))};
+    const core::Velocity velocity{speed(rng), speed(rng), speed(rng)};
+
+    const core::Result exact = core::Calculate(exactLimits, pose, velocity,
+                                               target, profile.period);
+    const core::BasicResult<T> approx = core::Calculate(
+        limits, core::Cast<T>(pose), core::Cast<T>(velocity), cast, dt);
+    velocityErrors.push_back(
+        std::hypot(static_cast<double>(approx.vx) - exact.vx,
+                   static_cast<double>(approx.vy) - exact.vy));
+    omegaErrors.push_back(
+        std::abs(static_cast<double>(approx.omega) - exact.omega));
+  }
+  return Error{.velocity = Percentile99(velocityErrors),
+               .omega = Percentile99(omegaErrors)};
+}
+}  // namespace
+
+TEST(ScalarTest, FixedSaturates) {
+  EXPECT_EQ(Fixed{40000.0}, kMax);
+  EXPECT_EQ(Fixed{-40000.0}, kLowest);
+  EXPECT_EQ(Fixed{40000}, kMax);
+  EXPECT_EQ(Fixed{-40000}, kLowest);
+  EXPECT_EQ(kMax + Fixed{1}, kMax);
+  EXPECT_EQ(kLowest - Fixed{1}, kLowest);
+  EXPECT_EQ(-kLowest, kMax);
+  EXPECT_EQ(kMax * Fixed{2}, kMax);
+  EXPECT_EQ(kMax * Fixed{-2}, kLowest);
+  EXPECT_EQ(Fixed{20000} / Fixed{0.5}, kMax);
+  EXPECT_EQ(Fixed{-20000} / Fixed{0.5}, kLowest);
+}
+
+TEST(ScalarTest, FixedFromDoubleRoundsToNearest) {
+  EXPECT_EQ(Fixed{1.5}.Raw(), 3 * Fixed::kOne / 2);
+  EXPECT_EQ(Fixed{0.4 / Fixed::kOne}.Raw(), 0);
+  EXPECT_EQ(Fixed{0.6 / Fixed::kOne}.Raw(), 1);
+  EXPECT_EQ(Fixed{-0.4 / Fixed::kOne}.Raw(), 0);
+  EXPECT_EQ(Fixed{-0.6 / Fixed::kOne}.Raw(), -1);
+  EXPECT_EQ(Fixed{std::numeric_limits<double>::quiet_NaN()}, Fixed{});
+  EXPECT_EQ(Fixed{std::numeric_limits<double>::infinity()}, kMax);
+  EXPECT_EQ(Fixed{-std::numeric_limits<double>::infinity()}, kLowest);
+  EXPECT_EQ(static_cast<int>(Fixed{-2.75}), -2);
+}
+
+TEST(ScalarTest, FixedArithmeticRoundsToNearest) {
+  std::mt19937 rng{16};
+  std::uniform_real_distribution<double> value(-100.0, 100.0);
+  for (int i = 0; i < kSamples; ++i) {
+    const Fixed a{value(rng)};
+    const Fixed b{value(rng)};
+    const double x = static_cast<double>(a);
+    const double y = static_cast<double>(b);
+    EXPECT_EQ(static_cast<double>(a + b), x + y);
+    EXPECT_EQ(static_cast<double>(a - b), x - y);
+    EXPECT_NEAR(static_cast<double>(a * b), x * y, kHalfUnit) << x << " " << y;
+    // Quotients out of range saturate, which FixedSaturates covers
+    if (b != Fixed{} && std::abs(x / y) < 30000.0) {
+      EXPECT_NEAR(static_cast<double>(a / b), x / y, kHalfUnit)
+          << x << " " << y;
+    }
+  }
+
+  // Products round half up, quotients half away from zero
+  EXPECT_EQ((Fixed::FromRaw(3) * Fixed{0.5}).Raw(), 2);
+  EXPECT_EQ((Fixed::FromRaw(-3) * Fixed{0.5}).Raw(), -1);
+  EXPECT_EQ((Fixed::FromRaw(1) / Fixed{2}).Raw(), 1);
+  EXPECT_EQ((Fixed::FromRaw(-1) / Fixed{2}).Raw(), -1);
+}
+
+TEST(ScalarTest, FixedDivides) {
+  EXPECT_EQ(Fixed{7} / Fixed{2}, Fixed{3.5});
+  EXPECT_EQ(Fixed{-7} / Fixed{2}, Fixed{-3.5});
+  EXPECT_EQ(Fixed{7} / Fixed{-0.25}, Fixed{-28});
+  EXPECT_EQ(Fixed{1} / Fixed{3}, Fixed::FromRaw(21845));
+  EXPECT_EQ(Fixed{2} / Fixed{3}, Fixed::FromRaw(43691));
+}
+
+TEST(ScalarTest, FixedDivisionByZeroSaturates) {
+  EXPECT_EQ(Fixed{3} / Fixed{}, kMax);
+  EXPECT_EQ(Fixed{-3} / Fixed{}, kLowest);
+  EXPECT_EQ(Fixed::FromRaw(1) / Fixed{}, kMax);
+  EXPECT_EQ(Fixed{} / Fixed{}, Fixed{});
+}
+
+TEST(ScalarTest, FloatCalculateIsWithinBound) {
+  const Error error = CalculateError<float>();
+  EXPECT_LE(error.velocity, kFloatVelocity);
+  EXPECT_LE(error.omega, kFloatOmega);
+}
+
+TEST(ScalarTest, FixedCalculateIsWithinBound) {
+  const Error error = CalculateError<Fixed>();
+  EXPECT_LE(error.velocity, kFixedVelocity);
+  EXPECT_LE(error.omega, kFixedOmega);
+}
@@ -0,0 +1,93 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include <limits>
+#include <numbers>
+#include <optional>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "autopilot/autopilot.h"
+#include "autopilot/target_set.h"
+#include "gtest/gtest.h"
+
+using namespace autopilot;
+
+namespace {
+APProfile MakeProfile() {
+  return APProfile{APConstraints{4.5_mps, 8_mps_sq, 12.0}}
+      .WithErrorXY(2_cm)
+      .WithErrorTheta(2_deg)
+      .WithBeelineRadius(8_cm);
+}
+
+// Candidates spread over the field, with every kind of end state
+std::vector<APTarget> MakeTargets(size_t count) {
+  std::mt19937 rng{8};
+  std::uniform_real_distribution<double> x{0.0, 16.0};
+  std::uniform_real_distribution<double> y{0.0, 8.0};
+  std::uniform_real_distribution<double> angle{-std::numbers::pi,
+                                               std::numbers::pi};
+  std::vector<APTarget> targets;
+  for (size_t i = 0; i < count; ++i) {
+    APTarget target{frc::Pose2d{units::meter_t{x(rng)}, units::meter_t{y(rng)},
+                                frc::Rotation2d{units::radian_t{angle(rng)}}}};
+    if (i % 2 == 0) {
+      target = target.WithEntryAngle(
+          frc::Rotation2d{units::radian_t{angle(rng)}});
+    }
+    if (i % 3 == 0) {
+      target = target.WithVelocity(units::meters_per_second_t{i % 4 * 0.5});
+    }
+    targets.push_back(target);
+  }
+  return targets;
+}
+}  // namespace
+
+TEST(TargetSetTest, BestMatchesBruteForce) {
+  Autopilot autopilot{MakeProfile()};
+  const std::vector<APTarget> targets = MakeTargets(200);
+  const APTargetSet set{autopilot, targets};
+  ASSERT_EQ(set.Size(), targets.size());
+
+  std::mt19937 rng{17};
+  std::uniform_real_distribution<double> x{0.0, 16.0};
+  std::uniform_real_distribution<double> y{0.0, 8.0};
+  std::uniform_real_distribution<double> speed{-3.0, 3.0};
+  for (int i = 0; i < 200; ++i) {
+    const frc::Pose2d pose{units::meter_t{x(rng)}, units::meter_t{y(rng)},
+                           frc::Rotation2d{}};
+    const frc::Translation2d velocity{units::meter_t{speed(rng)},
+                                      units::meter_t{speed(rng)}};
+
+    size_t index = 0;
+    double time = std::numeric_limits<double>::infinity();
+    for (size_t j = 0; j < targets.size(); ++j) {
+      const double estimate =
+          autopilot.EstimateTimeToTarget(pose, velocity, targets[j]).value();
+      if (estimate < time) {
+        index = j;
+        time = estimate;
+      }
+    }
+
+    const std::optional<APTargetChoice> best = set.Best(pose, velocity);
+    ASSERT_TRUE(best.has_value()) << i;
+    EXPECT_EQ(best->index, index) << i;
+    EXPECT_EQ(best->time.value(), time) << i;
+  }
+}
+
+TEST(TargetSetTest, EmptySetHasNoBest) {
+  Autopilot autopilot{MakeProfile()};
+  const APTargetSet set{autopilot, std::span<const APTarget>{}};
+  EXPECT_EQ(set.Size(), 0u);
+  EXPECT_FALSE(set.Best(frc::Pose2d{}, frc::Translation2d{}).has_value());
+}
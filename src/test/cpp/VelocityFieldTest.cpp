@@ -0,0 +1,156 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include <cmath>
+#include <filesystem>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "autopilot/autopilot.h"
+#include "autopilot/core.h"
+#include "autopilot/velocity_field.h"
+#include "gtest/gtest.h"
+
+using namespace autopilot;
+
+namespace {
+// The error APFieldGrid::Lookup documents, relative to the exact speed
+constexpr double kLookupError = 0.01;
+
+APConstraints MakeConstraints() {
+  return APConstraints{4.5_mps, 8_mps_sq, 12.0};
+}
+
+APProfile MakeProfile(const APConstraints& constraints) {
+  return APProfile{constraints}
+      .WithErrorXY(2_cm)
+      .WithErrorTheta(2_deg)
+      .WithBeelineRadius(8_cm);
+}
+
+const std::vector<APTarget> kTargets{
+    APTarget{frc::Pose2d{3_m, 1_m, frc::Rotation2d{units::radian_t{2.0}}}}
+        .WithEntryAngle(frc::Rotation2d{units::radian_t{0.5}}),
+    APTarget{frc::Pose2d{-2_m, 4_m, frc::Rotation2d{}}}
+        .WithEntryAngle(frc::Rotation2d{units::radian_t{-2.0}})
+        .WithVelocity(1_mps)};
+
+// Bakes kTargets for the autopilot into a temporary file and loads it back
+class VelocityFieldTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(APVelocityField::Bake(m_autopilot, kTargets, 4_m,
+                                      units::meter_t{0.1}, m_path));
+    m_field = APVelocityField::Load(m_path);
+    ASSERT_TRUE(m_field.has_value());
+  }
+
+  void TearDown() override { std::filesystem::remove(m_path); }
+
+  Autopilot m_autopilot{MakeProfile(MakeConstraints())};
+  const std::string m_path =
+      (std::filesystem::temp_directory_path() / "autopilot_field_test.bin")
+          .string();
+  std::optional<APVelocityField> m_field;
+};
+}  // namespace
+
+TEST_F(VelocityFieldTest, LoadsWhatWasBaked) {
+  EXPECT_EQ(m_field->Size(), kTargets.size());
+  EXPECT_TRUE(m_field->Matches(m_autopilot));
+  for (const APTarget& target : kTargets) {
+    const APFieldGrid* grid = m_field->Find(target);
+    ASSERT_NE(grid, nullptr);
+    EXPECT_TRUE(grid->Matches(target));
+  }
+
+  // Another target, even at a baked pose, has no grid
+  EXPECT_EQ(m_field->Find(kTargets[0].WithVelocity(2_mps)), nullptr);
+  EXPECT_EQ(m_field->Find(APTarget{frc::Pose2d{}}.WithEntryAngle(
+                frc::Rotation2d{})),
+            nullptr);
+}
+
+TEST_F(VelocityFieldTest, LookupIsCloseToTheExactGoal) {
+  std::mt19937 rng{20};
+  std::uniform_real_distribution<double> offset{-4.0, 4.0};
+  size_t lookups = 0;
+  for (int i = 0; i < 10000; ++i) {
+    const APTarget& target = kTargets[i % kTargets.size()];
+    const frc::Translation2d local{units::meter_t{offset(rng)},
+                                   units::meter_t{offset(rng)}};
+    const std::optional<frc::Translation2d> baked =
+        m_field->Find(target)->Lookup(local);
+    if (!baked) {
+      continue;
+    }
+    ++lookups;
+    const core::Vector exact = core::SwirlyVelocity(
+        m_autopilot.Limits(),
+        core::Vector{local.X().value(), local.Y().value()},
+        target.Velocity().value());
+    EXPECT_LE(std::hypot(baked->X().value() - exact.x,
+                         baked->Y().value() - exact.y),
+              kLookupError * std::hypot(exact.x, exact.y))
+        << local.X().value() << " " << local.Y().value();
+  }
+  // Most of the square is outside the guard around the target
+  EXPECT_GT(lookups, 9000u);
+
+  // Outside the grid and on the target, the goal is computed exactly
+  EXPECT_FALSE(m_field->Find(kTargets[0])->Lookup(
+      frc::Translation2d{5_m, 0_m}).has_value());
+  EXPECT_FALSE(m_field->Find(kTargets[0])->Lookup(
+      frc::Translation2d{}).has_value());
+}
+
+TEST_F(VelocityFieldTest, MatchesRejectsAnotherProfile) {
+  // The velocity limit is applied after the lookup, so it may differ
+  EXPECT_TRUE(m_field->Matches(Autopilot{
+      MakeProfile(MakeConstraints().withVelocity(3_mps))}));
+
+  EXPECT_FALSE(m_field->Matches(
+      Autopilot{MakeProfile(MakeConstraints().withJerk(10.0))}));
+  EXPECT_FALSE(m_field->Matches(
+      Autopilot{MakeProfile(MakeConstraints().withDeceleration(5_mps_sq))}));
+  EXPECT_FALSE(m_field->Matches(
+      Autopilot{MakeProfile(MakeConstraints()).WithBeelineRadius(20_cm)}));
+  Autopilot fast{MakeProfile(MakeConstraints())};
+  fast.WithMathMode(APMathMode::kFast);
+  EXPECT_FALSE(m_field->Matches(fast));
+
+  // An autopilot the field does not match computes every goal exactly
+  Autopilot other{MakeProfile(MakeConstraints().withJerk(10.0))};
+  const Autopilot exact = other;
+  other.WithVelocityField(&*m_field);
+  const frc::Pose2d pose{1_m, -1_m, frc::Rotation2d{}};
+  const frc::Translation2d velocity{0.5_m, 0.5_m};
+  const APResult result = other.Calculate(pose, velocity, kTargets[0]);
+  const APResult expected =
+      exact.Preview(pose, frc::ChassisSpeeds{.vx = 0.5_mps, .vy = 0.5_mps},
+                    exact.Prepare(kTargets[0]));
+  EXPECT_EQ(result.vx, expected.vx);
+  EXPECT_EQ(result.vy, expected.vy);
+}
+
+TEST(VelocityFieldFileTest, RejectsBadInput) {
+  Autopilot autopilot{MakeProfile(MakeConstraints())};
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "autopilot_field_bad.bin")
+          .string();
+  // Targets without an entry angle are never baked
+  const std::vector<APTarget> straight{APTarget{frc::Pose2d{}}};
+  EXPECT_FALSE(APVelocityField::Bake(autopilot, straight, 4_m,
+                                     units::meter_t{0.1}, path));
+  EXPECT_FALSE(APVelocityField::Bake(autopilot, kTargets, 4_m,
+                                     units::meter_t{0.0}, path));
+  EXPECT_FALSE(APVelocityField::Load(path + ".missing").has_value());
+  std::filesystem::remove(path);
+}
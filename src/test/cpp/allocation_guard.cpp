@@ -0,0 +1,152 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include "allocation_guard.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+#ifdef __GLIBC__
+// glibc's own entry points, which the replacements below forward to
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+}
+#endif
+
+namespace {
+struct Counter {
+  bool armed;
+  size_t count;
+  size_t firstSize;
+};
+
+// Constant initialized, so reading it from inside malloc never allocates
+constinit thread_local Counter tCounter{false, 0, 0};
+
+void Note(size_t size) {
+  if (tCounter.armed) {
+    if (tCounter.count == 0) {
+      tCounter.firstSize = size;
+    }
+    ++tCounter.count;
+  }
+}
+
+void* Allocate(size_t size) {
+  Note(size);
+#ifdef __GLIBC__
+  return __libc_malloc(size == 0 ? 1 : size);
+#else
+  return std::malloc(size == 0 ? 1 : size);
+#endif
+}
+}  // namespace
+
+AllocationGuard::AllocationGuard() {
+  tCounter = Counter{true, 0, 0};
+}
+
+AllocationGuard::~AllocationGuard() {
+  tCounter.armed = false;
+}
+
+size_t AllocationGuard::Count() const {
+  return tCounter.count;
+}
+
+size_t AllocationGuard::FirstSize() const {
+  return tCounter.firstSize;
+}
+
+void* operator new(size_t size) {
+  void* pointer = Allocate(size);
+  if (!pointer) {
+    throw std::bad_alloc{};
+  }
+  return pointer;
+}
+
+void* operator new[](size_t size) {
+  return ::operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return Allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return Allocate(size);
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+  std::free(pointer);
+}
+
+#ifdef __GLIBC__
+// The C allocator is only replaceable with glibc. Everything still frees
+// through glibc's free, which owns every block handed out here.
+extern "C" {
+void* malloc(size_t size) noexcept {
+  Note(size);
+  return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) noexcept {
+  Note(count * size);
+  return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) noexcept {
+  Note(size);
+  return __libc_realloc(pointer, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept {
+  Note(size);
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** pointer, size_t alignment, size_t size) noexcept {
+  if (alignment % sizeof(void*) != 0 ||
+      (alignment & (alignment - 1)) != 0) {
+    return EINVAL;
+  }
+  Note(size);
+  void* block = __libc_memalign(alignment, size);
+  if (!block) {
+    return ENOMEM;
+  }
+  *pointer = block;
+  return 0;
+}
+}
+#endif
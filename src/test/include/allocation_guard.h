@@ -0,0 +1,49 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include <cstddef>
+
+/**
+ * Counts the heap allocations made by the calling thread while it is alive.
+ *
+ * The tests replace the global operator new, and with glibc also malloc,
+ * calloc, realloc, aligned_alloc and posix_memalign, with versions that count
+ * every call made on a thread with a live guard before forwarding to the
+ * real allocator. Other threads, and calls outside a guard, only pay for a
+ * thread local check.
+ *
+ * Only one guard may be alive per thread at a time.
+ */
+class AllocationGuard {
+ public:
+  /**
+   * Starts counting the calling thread's allocations.
+   */
+  AllocationGuard();
+
+  /**
+   * Stops counting.
+   */
+  ~AllocationGuard();
+
+  AllocationGuard(const AllocationGuard&) = delete;
+  AllocationGuard& operator=(const AllocationGuard&) = delete;
+
+  /**
+   * Returns the number of allocations since the guard was created.
+   */
+  size_t Count() const;
+
+  /**
+   * Returns the size in bytes of the first allocation counted, or zero if
+   * there was none.
+   */
+  size_t FirstSize() const;
+};
@@ -0,0 +1,260 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <numbers>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "autopilot/autopilot.h"
+#include "autopilot/velocity_field.h"
+#include "tools.h"
+
+using namespace tools;
+using namespace autopilot;
+
+namespace {
+// Random states drawn to compare the baked field with the exact one
+constexpr size_t kSamples = 100000;
+
+struct BakeOptions {
+  double jerk = 2.0;
+  double deceleration = 0.0;
+  double beeline = 0.08;
+  bool fast = false;
+  double extent = 8.0;
+  double cell = 0.1;
+  std::string targets = "src/main/deploy/autopilot/targets.csv";
+  std::string out = "src/main/deploy/autopilot/velocity_field.bin";
+  uint32_t seed = 5805;
+};
+
+double Radians(double degrees) {
+  return degrees * std::numbers::pi / 180.0;
+}
+
+// Reads one target per line: x,y,heading,entryAngle[,endVelocity], with
+// angles in degrees. Blank lines and lines starting with # are skipped.
+std::optional<std::vector<APTarget>> LoadTargets(const std::string& path) {
+  std::ifstream file{path};
+  if (!file) {
+    return std::nullopt;
+  }
+
+  std::vector<APTarget> targets;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line.front() == '#') {
+      continue;
+    }
+
+    double fields[5];
+    size_t count = 0;
+    const char* cursor = line.c_str();
+    while (count < std::size(fields)) {
+      char* end;
+      fields[count] = std::strtod(cursor, &end);
+      if (end == cursor) {
+        break;
+      }
+      ++count;
+      cursor = end;
+      if (*cursor != ',') {
+        break;
+      }
+      ++cursor;
+    }
+    if (count < 4) {
+      return std::nullopt;
+    }
+
+    targets.push_back(
+        APTarget{frc::Pose2d{
+                     units::meter_t{fields[0]}, units::meter_t{fields[1]},
+                     frc::Rotation2d{units::radian_t{Radians(fields[2])}}}}
+            .WithEntryAngle(
+                frc::Rotation2d{units::radian_t{Radians(fields[3])}})
+            .WithVelocity(
+                units::meters_per_second_t{count == 5 ? fields[4] : 0.0}));
+  }
+  return targets;
+}
+
+std::optional<BakeOptions> ParseOptions(Args args) {
+  BakeOptions options;
+  while (!args.empty()) {
+    const std::string_view flag = args.front();
+    if (flag == "--fast") {
+      options.fast = true;
+      args = args.subspan(1);
+      continue;
+    }
+    if (args.size() < 2 || !flag.starts_with("--")) {
+      std::fprintf(stderr, "bake: unexpected argument %.*s\n",
+                   static_cast<int>(flag.size()), flag.data());
+      return std::nullopt;
+    }
+    const std::string value{args[1]};
+    args = args.subspan(2);
+
+    const double number = std::strtod(value.c_str(), nullptr);
+    if (flag == "--jerk") {
+      options.jerk = number;
+    } else if (flag == "--deceleration") {
+      options.deceleration = number;
+    } else if (flag == "--beeline") {
+      options.beeline = number;
+    } else if (flag == "--extent") {
+      options.extent = number;
+    } else if (flag == "--cell") {
+      options.cell = number;
+    } else if (flag == "--targets") {
+      options.targets = value;
+    } else if (flag == "--out") {
+      options.out = value;
+    } else if (flag == "--seed") {
+      options.seed = static_cast<uint32_t>(number);
+    } else {
+      std::fprintf(stderr, "bake: unknown option %.*s\n",
+                   static_cast<int>(flag.size()), flag.data());
+      return std::nullopt;
+    }
+  }
+  return options;
+}
+
+// An autopilot with the given limits on the goal velocity. The velocity,
+// acceleration and axis limits are left off so that Calculate returns the
+// goal itself.
+Autopilot MakeAutopilot(const BakeOptions& options) {
+  Autopilot autopilot{
+      APProfile(APConstraints(units::meters_per_second_squared_t{
+                                  std::numeric_limits<double>::max()},
+                              options.jerk)
+                    .withDeceleration(units::meters_per_second_squared_t{
+                        options.deceleration}))
+          .WithBeelineRadius(units::meter_t{options.beeline})};
+  autopilot.WithMathMode(options.fast ? APMathMode::kFast
+                                      : APMathMode::kExact);
+  return autopilot;
+}
+
+double NanosPerCall(Autopilot& autopilot,
+                    const std::vector<APPreparedTarget>& targets,
+                    const std::vector<frc::Pose2d>& poses) {
+  double sink = 0.0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < poses.size(); ++i) {
+    APResult result = autopilot.Calculate(
+        poses[i], frc::Translation2d{}, targets[i % targets.size()]);
+    sink += result.vx.value();
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  // Keeps the calls from being optimized away
+  if (sink == std::numeric_limits<double>::infinity()) {
+    std::printf("\n");
+  }
+  return std::chrono::duration<double, std::nano>(elapsed).count() /
+         poses.size();
+}
+}  // namespace
+
+int tools::Bake(Args args) {
+  std::optional<BakeOptions> options = ParseOptions(args);
+  if (!options) {
+    return 2;
+  }
+  std::optional<std::vector<APTarget>> targets = LoadTargets(options->targets);
+  if (!targets || targets->empty()) {
+    std::fprintf(stderr, "bake: cannot read targets from %s\n",
+                 options->targets.c_str());
+    return 2;
+  }
+
+  Autopilot exact = MakeAutopilot(*options);
+  auto start = std::chrono::steady_clock::now();
+  if (!APVelocityField::Bake(exact, *targets, units::meter_t{options->extent},
+                             units::meter_t{options->cell}, options->out)) {
+    std::fprintf(stderr, "bake: cannot write %s\n", options->out.c_str());
+    return 1;
+  }
+  const double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+
+  std::optional<APVelocityField> field = APVelocityField::Load(options->out);
+  if (!field) {
+    std::fprintf(stderr, "bake: cannot load %s back\n", options->out.c_str());
+    return 1;
+  }
+  std::printf("baked %zu targets into %s: %.1f KiB in %.2f s\n",
+              field->Size(), options->out.c_str(), field->Bytes() / 1024.0,
+              seconds);
+
+  // Compare the goal velocities at random offsets within the grids
+  Autopilot baked = MakeAutopilot(*options);
+  baked.WithVelocityField(&*field);
+  std::vector<APPreparedTarget> exactTargets;
+  std::vector<APPreparedTarget> bakedTargets;
+  for (const APTarget& target : *targets) {
+    exactTargets.push_back(exact.Prepare(target));
+    bakedTargets.push_back(baked.Prepare(target));
+  }
+
+  std::mt19937 rng{options->seed};
+  std::uniform_real_distribution<double> offset(-options->extent,
+                                                options->extent);
+  std::vector<frc::Pose2d> poses;
+  poses.reserve(kSamples);
+  double maxError = 0.0;
+  double sumError = 0.0;
+  double maxRelative = 0.0;
+  size_t lookups = 0;
+  for (size_t i = 0; i < kSamples; ++i) {
+    const APTarget& target = (*targets)[i % targets->size()];
+    const frc::Pose2d pose{
+        target.Reference().X() - units::meter_t{offset(rng)},
+        target.Reference().Y() - units::meter_t{offset(rng)},
+        frc::Rotation2d{}};
+    poses.push_back(pose);
+
+    const frc::Translation2d local =
+        (target.Reference().Translation() - pose.Translation())
+            .RotateBy(-*target.EntryAngle());
+    const APFieldGrid* grid = field->Find(target);
+    lookups += grid && grid->Lookup(local) ? 1 : 0;
+
+    APResult want = exact.Calculate(pose, frc::Translation2d{},
+                                    exactTargets[i % targets->size()]);
+    APResult got = baked.Calculate(pose, frc::Translation2d{},
+                                   bakedTargets[i % targets->size()]);
+    const double error = std::hypot((got.vx - want.vx).value(),
+                                    (got.vy - want.vy).value());
+    const double speed = std::hypot(want.vx.value(), want.vy.value());
+    maxError = std::max(maxError, error);
+    sumError += error;
+    maxRelative = std::max(maxRelative, speed > 0.0 ? error / speed : 0.0);
+  }
+  std::printf("goal velocity error over %zu offsets: max %.4f m/s, mean "
+              "%.5f m/s, max relative %.4f, %zu looked up\n",
+              kSamples, maxError, sumError / kSamples, maxRelative, lookups);
+
+  const double exactNanos = NanosPerCall(exact, exactTargets, poses);
+  const double bakedNanos = NanosPerCall(baked, bakedTargets, poses);
+  std::printf("Calculate: exact %.1f ns/call, baked %.1f ns/call, %.2fx\n",
+              exactNanos, bakedNanos, exactNanos / bakedNanos);
+  return 0;
+}
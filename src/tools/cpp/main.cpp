@@ -0,0 +1,53 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+#include "tools.h"
+
+namespace {
+struct Command {
+  std::string_view name;
+  int (*run)(tools::Args);
+};
+
+constexpr Command kCommands[] = {
+    {"replay", tools::Replay},
+    {"tune", tools::Tune},
+    {"montecarlo", tools::MonteCarlo},
+    {"bake", tools::Bake},
+    {"realtime", tools::Realtime},
+};
+}  // namespace
+
+/**
+ * Usage: frcUserProgramTools <command> [args...]
+ *
+ * Offline tools for Autopilot. See tools.h for each command's arguments.
+ */
+int main(int argc, char** argv) {
+  std::vector<std::string_view> args(argv + 1, argv + argc);
+  if (!args.empty()) {
+    for (const Command& command : kCommands) {
+      if (command.name == args.front()) {
+        return command.run(tools::Args{args}.subspan(1));
+      }
+    }
+  }
+
+  std::fprintf(stderr, "usage: frcUserProgramTools <command> [args...]\n");
+  std::fprintf(stderr, "commands:");
+  for (const Command& command : kCommands) {
+    std::fprintf(stderr, " %.*s", static_cast<int>(command.name.size()),
+                 command.name.data());
+  }
+  std::fprintf(stderr, "\n");
+  return 2;
+}
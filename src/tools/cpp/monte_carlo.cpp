@@ -0,0 +1,289 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <numbers>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "autopilot/autopilot.h"
+#include "simulation.h"
+#include "tools.h"
+#include "work_stealing_pool.h"
+
+using namespace tools;
+using namespace autopilot;
+
+namespace {
+struct MonteCarloOptions {
+  double velocity = 4.5;
+  double acceleration = 3.0;
+  double deceleration = 0.0;
+  double velocityX = std::numeric_limits<double>::max();
+  double velocityY = std::numeric_limits<double>::max();
+  double jerk = 2.0;
+  double beeline = 0.08;
+  bool frictionCircle = false;
+  double errorXY = 0.02;
+  double errorTheta = 2.0;
+  size_t scenarioCount = 8;
+  std::string scenarioFile;
+  size_t rollouts = 1000;
+  double poseNoise = 0.02;
+  double headingNoise = 1.0;
+  double delayMin = 0.04;
+  double delayMax = 0.08;
+  double poseLatency = 0.0;
+  bool compensate = false;
+  uint32_t seed = 5805;
+  unsigned jobs = 0;
+  SimOptions sim;
+};
+
+// Percentiles of one metric over a set of rollouts
+struct Distribution {
+  double p5;
+  double p50;
+  double p95;
+  double max;
+  double mean;
+};
+
+Distribution Summarize(std::vector<double> values) {
+  if (values.empty()) {
+    return Distribution{0, 0, 0, 0, 0};
+  }
+  std::sort(values.begin(), values.end());
+  auto percentile = [&](double p) {
+    return values[static_cast<size_t>(p * (values.size() - 1))];
+  };
+  double sum = 0.0;
+  for (double value : values) {
+    sum += value;
+  }
+  return Distribution{percentile(0.05), percentile(0.50), percentile(0.95),
+                      values.back(), sum / values.size()};
+}
+
+void PrintDistribution(const char* name, const Distribution& d,
+                       double scale) {
+  std::printf("  %-18s p5 %8.3f  p50 %8.3f  p95 %8.3f  max %8.3f  mean %8.3f\n",
+              name, d.p5 * scale, d.p50 * scale, d.p95 * scale, d.max * scale,
+              d.mean * scale);
+}
+
+// Mixes the run's seed with the scenario and rollout, so every rollout draws
+// the same noise no matter which thread runs it
+uint64_t RolloutSeed(uint32_t seed, size_t scenario, size_t rollout) {
+  uint64_t z = (static_cast<uint64_t>(seed) << 40) ^
+               (static_cast<uint64_t>(scenario) << 20) ^ rollout;
+  // splitmix64 finalizer
+  z += 0x9e3779b97f4a7c15;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+std::optional<MonteCarloOptions> ParseOptions(Args args) {
+  MonteCarloOptions options;
+  while (!args.empty()) {
+    const std::string_view flag = args.front();
+    if (args.size() < 2 || !flag.starts_with("--")) {
+      std::fprintf(stderr, "montecarlo: unexpected argument %.*s\n",
+                   static_cast<int>(flag.size()), flag.data());
+      return std::nullopt;
+    }
+    const std::string value{args[1]};
+    args = args.subspan(2);
+
+    const double number = std::strtod(value.c_str(), nullptr);
+    if (flag == "--velocity") {
+      options.velocity = number;
+    } else if (flag == "--acceleration") {
+      options.acceleration = number;
+    } else if (flag == "--deceleration") {
+      options.deceleration = number;
+    } else if (flag == "--velocity-x") {
+      options.velocityX = number;
+    } else if (flag == "--velocity-y") {
+      options.velocityY = number;
+    } else if (flag == "--jerk") {
+      options.jerk = number;
+    } else if (flag == "--beeline") {
+      options.beeline = number;
+    } else if (flag == "--friction-circle") {
+      options.frictionCircle = number != 0.0;
+    } else if (flag == "--error-xy") {
+      options.errorXY = number;
+    } else if (flag == "--error-theta") {
+      options.errorTheta = number;
+    } else if (flag == "--scenarios") {
+      options.scenarioCount = static_cast<size_t>(number);
+    } else if (flag == "--scenario-file") {
+      options.scenarioFile = value;
+    } else if (flag == "--rollouts") {
+      options.rollouts = static_cast<size_t>(number);
+    } else if (flag == "--pose-noise") {
+      options.poseNoise = number;
+    } else if (flag == "--heading-noise") {
+      options.headingNoise = number;
+    } else if (flag == "--delay-min") {
+      options.delayMin = number;
+    } else if (flag == "--delay-max") {
+      options.delayMax = number;
+    } else if (flag == "--pose-latency") {
+      options.poseLatency = number;
+    } else if (flag == "--compensate") {
+      options.compensate = number != 0.0;
+    } else if (flag == "--lag") {
+      options.sim.plant.lag = units::second_t{number};
+    } else if (flag == "--plant-accel") {
+      options.sim.plant.maxModuleAcceleration =
+          units::meters_per_second_squared_t{number};
+    } else if (flag == "--plant-decel") {
+      options.sim.plant.maxModuleDeceleration =
+          units::meters_per_second_squared_t{number};
+    } else if (flag == "--plant-velocity") {
+      options.sim.plant.maxModuleVelocity =
+          units::meters_per_second_t{number};
+    } else if (flag == "--seed") {
+      options.seed = static_cast<uint32_t>(number);
+    } else if (flag == "--jobs") {
+      options.jobs = static_cast<unsigned>(number);
+    } else {
+      std::fprintf(stderr, "montecarlo: unknown option %.*s\n",
+                   static_cast<int>(flag.size()), flag.data());
+      return std::nullopt;
+    }
+  }
+  options.delayMax = std::max(options.delayMin, options.delayMax);
+  return options;
+}
+}  // namespace
+
+int tools::MonteCarlo(Args args) {
+  std::optional<MonteCarloOptions> options = ParseOptions(args);
+  if (!options) {
+    return 2;
+  }
+
+  std::vector<Scenario> scenarios;
+  if (options->scenarioFile.empty()) {
+    scenarios = MakeScenarios(options->scenarioCount, options->seed);
+  } else if (auto loaded = LoadScenarios(options->scenarioFile)) {
+    scenarios = std::move(*loaded);
+  } else {
+    std::fprintf(stderr, "montecarlo: cannot read scenarios from %s\n",
+                 options->scenarioFile.c_str());
+    return 2;
+  }
+  if (scenarios.empty() || options->rollouts == 0) {
+    std::fprintf(stderr, "montecarlo: nothing to simulate\n");
+    return 2;
+  }
+
+  const APProfile profile =
+      APProfile(APConstraints(
+                    units::meters_per_second_t{options->velocity},
+                    units::meters_per_second_squared_t{options->acceleration},
+                    options->jerk)
+                    .withFrictionCircle(options->frictionCircle)
+                    .withDeceleration(units::meters_per_second_squared_t{
+                        options->deceleration})
+                    .withAxisVelocity(
+                        units::meters_per_second_t{options->velocityX},
+                        units::meters_per_second_t{options->velocityY}))
+          .WithErrorXY(units::meter_t{options->errorXY})
+          .WithErrorTheta(units::radian_t{options->errorTheta *
+                                          std::numbers::pi / 180.0})
+          .WithBeelineRadius(units::meter_t{options->beeline});
+
+  WorkStealingPool pool{options->jobs};
+  const size_t rollouts = options->rollouts;
+  std::vector<SimResult> results(scenarios.size() * rollouts);
+
+  auto start = std::chrono::steady_clock::now();
+  pool.ParallelFor(results.size(), [&](size_t i) {
+    const size_t scenario = i / rollouts;
+    const uint64_t seed = RolloutSeed(options->seed, scenario, i % rollouts);
+
+    // The plant's latency is drawn per rollout, the measurement noise per
+    // tick
+    SimOptions sim = options->sim;
+    sim.noise.pose = units::meter_t{options->poseNoise};
+    sim.noise.heading = units::radian_t{options->headingNoise *
+                                        std::numbers::pi / 180.0};
+    sim.noise.latency = units::second_t{options->poseLatency};
+    sim.compensateLatency = options->compensate;
+    std::mt19937_64 rng{seed};
+    sim.plant.latency = units::second_t{std::uniform_real_distribution<double>{
+        options->delayMin, options->delayMax}(rng)};
+
+    Autopilot autopilot{profile};
+    results[i] = Simulate(autopilot, scenarios[scenario], sim, rng());
+  });
+  const double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+
+  auto report = [&](size_t begin, size_t end) {
+    std::vector<double> times;
+    std::vector<double> errors;
+    std::vector<double> oscillations;
+    std::vector<double> exits;
+    size_t arrived = 0;
+    size_t settled = 0;
+    for (size_t i = begin; i < end; ++i) {
+      const SimResult& result = results[i];
+      arrived += result.arrived ? 1 : 0;
+      settled += result.settled ? 1 : 0;
+      if (result.arrived) {
+        times.push_back(result.time.value());
+      }
+      errors.push_back(result.finalError.value());
+      oscillations.push_back(result.oscillations);
+      exits.push_back(result.exits);
+    }
+    const double count = static_cast<double>(end - begin);
+    std::printf("  arrived %.1f%%, settled %.1f%%\n", 100.0 * arrived / count,
+                100.0 * settled / count);
+    PrintDistribution("time to target s", Summarize(times), 1.0);
+    PrintDistribution("final error cm", Summarize(errors), 100.0);
+    PrintDistribution("oscillations", Summarize(oscillations), 1.0);
+    PrintDistribution("tolerance exits", Summarize(exits), 1.0);
+  };
+
+  for (size_t scenario = 0; scenario < scenarios.size(); ++scenario) {
+    const Scenario& s = scenarios[scenario];
+    std::printf("scenario %zu: (%.2f, %.2f) -> (%.2f, %.2f)%s\n", scenario,
+                s.start.X().value(), s.start.Y().value(),
+                s.target.Reference().X().value(),
+                s.target.Reference().Y().value(),
+                s.target.EntryAngle() ? " with entry angle" : "");
+    report(scenario * rollouts, (scenario + 1) * rollouts);
+  }
+  std::printf("all scenarios:\n");
+  report(0, results.size());
+
+  double simulated = 0.0;
+  for (const SimResult& result : results) {
+    simulated += result.simulated.value();
+  }
+  std::printf("%zu rollouts in %.2f s on %u threads: %.0f rollouts/s\n",
+              results.size(), seconds, pool.Size(), results.size() / seconds);
+  std::printf("simulated %.0f s of driving, %.0fx real time\n", simulated,
+              simulated / seconds);
+  return 0;
+}
@@ -0,0 +1,496 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <numbers>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+#include "autopilot/autopilot.h"
+#include "autopilot/intercept.h"
+#include "autopilot/moving_target.h"
+#include "autopilot/static_autopilot.h"
+#include "autopilot/telemetry.h"
+#include "autopilot/trace.h"
+#include "autopilot/velocity_field.h"
+#include "tools.h"
+
+using namespace tools;
+using namespace autopilot;
+
+namespace {
+// Distinct calls cycled through while timing, enough to cover every
+// configuration and overload many times over
+constexpr size_t kLatencyCases = 4096;
+
+// Records buffered for the telemetry configuration. Kept small so that the
+// ring also fills up and drops records.
+constexpr size_t kRingCapacity = 64;
+
+// Targets baked into the velocity field configuration
+constexpr size_t kBakedTargets = 4;
+
+constexpr APStaticProfile kStaticProfile{
+    .velocity = 4.5,
+    .acceleration = 3.0,
+    .jerk = 2.0,
+    .errorXY = 0.02,
+    .errorTheta = 2.0 * std::numbers::pi / 180.0,
+    .beelineRadius = 0.08,
+    .rotationVelocity = 6.0,
+    .rotationAcceleration = 12.0,
+    .rotationJerk = 40.0,
+    .frictionCircle = true,
+    .deceleration = 8.0,
+    .velocityX = 3.0,
+    .velocityY = 1.5};
+
+struct RealtimeOptions {
+  size_t calls = 1000000;
+  uint32_t seed = 5805;
+  int priority = 80;
+  std::string trace;
+};
+
+std::optional<RealtimeOptions> ParseOptions(Args args) {
+  RealtimeOptions options;
+  while (!args.empty()) {
+    const std::string_view flag = args.front();
+    if (args.size() < 2 || !flag.starts_with("--")) {
+      std::fprintf(stderr, "realtime: unexpected argument %.*s\n",
+                   static_cast<int>(flag.size()), flag.data());
+      return std::nullopt;
+    }
+    const std::string value{args[1]};
+    args = args.subspan(2);
+
+    const double number = std::strtod(value.c_str(), nullptr);
+    if (flag == "--calls") {
+      options.calls = static_cast<size_t>(number);
+    } else if (flag == "--seed") {
+      options.seed = static_cast<uint32_t>(number);
+    } else if (flag == "--priority") {
+      options.priority = static_cast<int>(number);
+    } else if (flag == "--trace") {
+      options.trace = value;
+    } else {
+      std::fprintf(stderr, "realtime: unknown option %.*s\n",
+                   static_cast<int>(flag.size()), flag.data());
+      return std::nullopt;
+    }
+  }
+  return options;
+}
+
+APProfile BaseProfile() {
+  return APProfile(APConstraints(4.5_mps, 3.0_mps_sq, 2.0))
+      .WithErrorXY(2_cm)
+      .WithErrorTheta(2_deg)
+      .WithBeelineRadius(8_cm);
+}
+
+// Every constraint at once. Without a beeline radius the swirly path runs
+// all the way into the target.
+APProfile LimitedProfile() {
+  return APProfile(BaseProfile())
+      .WithBeelineRadius(0_m)
+      .WithConstraints(
+          APConstraints(4.5_mps, 3.0_mps_sq, 2.0)
+              .withRotationVelocity(units::radians_per_second_t{6.0})
+              .withRotationAcceleration(
+                  units::radians_per_second_squared_t{12.0})
+              .withRotationJerk(40.0)
+              .withFrictionCircle(true)
+              .withDeceleration(8.0_mps_sq)
+              .withAxisVelocity(3.0_mps, 1.5_mps));
+}
+
+// Every way of driving an autopilot that is timed
+enum class Config : uint8_t {
+  kExact,
+  kFast,
+  kLimited,
+  kTelemetry,
+  kBaked,
+  kStatic,
+  kIntercept,
+  kCount
+};
+
+constexpr std::array<const char*, static_cast<size_t>(Config::kCount)>
+    kConfigNames = {"exact", "fast",   "limited",  "telemetry",
+                    "baked", "static", "intercept"};
+
+// Which Calculate overload a call goes through
+enum class Overload : uint8_t {
+  kTranslation,
+  kTranslationDt,
+  kSpeeds,
+  kPrepared,
+  kTimestamped,
+  kTimestampedPrepared,
+  kCount
+};
+
+struct Call {
+  Config config;
+  Overload overload;
+  frc::Pose2d pose;
+  frc::ChassisSpeeds velocity;
+  APTarget target;
+  // For the intercept configuration, which moves the target
+  frc::Translation2d targetVelocity;
+  units::second_t measuredAt;
+  units::second_t dt;
+};
+
+struct Autopilots {
+  std::array<std::optional<Autopilot>, static_cast<size_t>(Config::kCount)>
+      dynamic;
+  StaticAutopilot<kStaticProfile> fixed;
+  APTelemetryRing ring{kRingCapacity};
+  std::vector<APTarget> baked;
+  std::optional<APInterceptor> interceptor;
+  units::second_t now = 0_s;
+  size_t calls = 0;
+};
+
+// Draws one call. Targets are built with every With* builder, on both named
+// targets and temporaries. Offsets are mostly spread over the field, with
+// some vanishingly small or exactly zero, where direction vectors
+// degenerate.
+Call Draw(std::mt19937& rng, const Autopilots& autopilots) {
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  std::uniform_real_distribution<double> field(-8.0, 8.0);
+  std::uniform_real_distribution<double> angle(-std::numbers::pi,
+                                               std::numbers::pi);
+  std::uniform_real_distribution<double> speed(-4.0, 4.0);
+
+  const auto config = static_cast<Config>(
+      rng() % static_cast<uint32_t>(Config::kCount));
+  const auto overload = static_cast<Overload>(
+      rng() % static_cast<uint32_t>(Overload::kCount));
+
+  const APTarget base{
+      frc::Pose2d{units::meter_t{field(rng)}, units::meter_t{field(rng)},
+                  frc::Rotation2d{units::radian_t{angle(rng)}}}};
+  std::optional<APTarget> target;
+  const double pick = unit(rng);
+  if (config == Config::kBaked && pick < 0.75) {
+    target = autopilots.baked[rng() % autopilots.baked.size()];
+  } else if (pick < 0.4) {
+    target = APTarget{base.Reference()}
+                 .WithEntryAngle(frc::Rotation2d{units::radian_t{angle(rng)}})
+                 .WithVelocity(units::meters_per_second_t{unit(rng)})
+                 .WithRotationRadius(units::meter_t{2.0 * unit(rng)});
+  } else if (pick < 0.7) {
+    target = base.WithEntryAngle(frc::Rotation2d{units::radian_t{angle(rng)}})
+                 .WithReference(base.Reference());
+  } else if (pick < 0.85) {
+    target = base.WithVelocity(units::meters_per_second_t{unit(rng)})
+                 .WithoutEntryAngle();
+  } else {
+    target = base.WithRotationRadius(units::meter_t{unit(rng)});
+  }
+
+  const double placement = unit(rng);
+  double radius = 8.0 * unit(rng);
+  if (placement < 0.02) {
+    radius = 0.0;
+  } else if (placement < 0.12) {
+    radius = std::pow(10.0, -12.0 + 9.0 * unit(rng));
+  }
+  const double direction = angle(rng);
+  const frc::Pose2d& reference = target->Reference();
+  const frc::Pose2d pose{
+      reference.X() - units::meter_t{radius * std::cos(direction)},
+      reference.Y() - units::meter_t{radius * std::sin(direction)},
+      frc::Rotation2d{units::radian_t{angle(rng)}}};
+
+  return Call{
+      .config = config,
+      .overload = overload,
+      .pose = pose,
+      .velocity =
+          frc::ChassisSpeeds{
+              .vx = units::meters_per_second_t{speed(rng)},
+              .vy = units::meters_per_second_t{speed(rng)},
+              .omega = units::radians_per_second_t{1.5 * speed(rng)}},
+      .target = *target,
+      .targetVelocity = frc::Translation2d{units::meter_t{0.5 * speed(rng)},
+                                           units::meter_t{0.5 * speed(rng)}},
+      // Mostly in the past, sometimes slightly in the future
+      .measuredAt = units::second_t{0.3 * unit(rng) - 0.25},
+      .dt = unit(rng) < 0.5 ? 0_s : units::second_t{0.005 + 0.03 * unit(rng)}};
+}
+
+// Makes one call, as the robot would on a tick, and returns a value that
+// depends on its result
+double Run(Autopilots& autopilots, const Call& call) {
+  autopilots.now += 20_ms;
+  const APTimestampedPose measured{call.pose,
+                                   autopilots.now + call.measuredAt};
+  const frc::Translation2d velocity{
+      units::meter_t{call.velocity.vx.value()},
+      units::meter_t{call.velocity.vy.value()}};
+
+  if (call.config == Config::kStatic) {
+    StaticAutopilot<kStaticProfile>& ap = autopilots.fixed;
+    APResult result =
+        call.overload == Overload::kPrepared
+            ? ap.Calculate(call.pose, call.velocity, ap.Prepare(call.target))
+            : ap.Calculate(call.pose, velocity, call.target);
+    return result.vx.value() + (ap.AtTarget(call.pose, call.target) ? 1 : 0);
+  }
+
+  Autopilot& ap = *autopilots.dynamic[static_cast<size_t>(call.config)];
+  if (call.config == Config::kIntercept) {
+    // Some solves start cold, and some targets also accelerate
+    APInterceptor& interceptor = *autopilots.interceptor;
+    if (call.overload == Overload::kTimestamped) {
+      interceptor.Reset();
+    }
+    const APMovingTarget moving{call.target, call.targetVelocity};
+    const APResult result = interceptor.Calculate(
+        call.pose, call.velocity,
+        call.overload == Overload::kTranslation
+            ? moving.WithAcceleration(call.targetVelocity * 0.5)
+            : moving,
+        call.dt);
+    return result.vx.value() + result.omega.value() +
+           (ap.AtTarget(call.pose, call.target) ? 1 : 0);
+  }
+
+  APResult result;
+  switch (call.overload) {
+    case Overload::kTranslation:
+      result = ap.Calculate(call.pose, velocity, call.target);
+      break;
+    case Overload::kTranslationDt:
+      result = ap.Calculate(call.pose, velocity, call.target, call.dt);
+      break;
+    case Overload::kSpeeds:
+      result = ap.Calculate(call.pose, call.velocity, call.target, call.dt);
+      break;
+    case Overload::kPrepared:
+      result = ap.Calculate(call.pose, call.velocity, ap.Prepare(call.target),
+                            call.dt);
+      break;
+    case Overload::kTimestamped:
+      result = ap.Calculate(measured, call.velocity, call.target,
+                            autopilots.now, call.dt);
+      break;
+    default:
+      result = ap.Calculate(measured, call.velocity, ap.Prepare(call.target),
+                            autopilots.now, call.dt);
+      break;
+  }
+
+  // Drain the ring now and then, as a logger would from its own thread
+  if (call.config == Config::kTelemetry &&
+      ++autopilots.calls % (2 * kRingCapacity) == 0) {
+    APRecord record;
+    while (autopilots.ring.TryPop(record)) {
+    }
+  }
+  return result.vx.value() + result.omega.value() +
+         (ap.AtTarget(call.pose, call.target) ? 1 : 0);
+}
+
+// Tries to run the calling thread as a locked in memory SCHED_FIFO thread,
+// and returns a description of what the timing ran under
+std::string EnterRealtime(int priority) {
+#ifdef __linux__
+  std::string policy;
+  sched_param param{};
+  param.sched_priority = priority;
+  const int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+  if (error == 0) {
+    policy = "SCHED_FIFO priority " + std::to_string(priority);
+  } else {
+    policy = std::string{"default policy, SCHED_FIFO unavailable: "} +
+             std::strerror(error);
+  }
+  if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+    policy += ", memory locked";
+  }
+  return policy;
+#else
+  static_cast<void>(priority);
+  return "default policy, SCHED_FIFO is Linux only";
+#endif
+}
+
+void LeaveRealtime() {
+#ifdef __linux__
+  sched_param param{};
+  pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+  munlockall();
+#endif
+}
+
+double Percentile(const std::vector<double>& sorted, double p) {
+  return sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+}
+}  // namespace
+
+int tools::Realtime(Args args) {
+  std::optional<RealtimeOptions> options = ParseOptions(args);
+  if (!options) {
+    return 2;
+  }
+  if (options->calls == 0) {
+    std::fprintf(stderr, "realtime: nothing to run\n");
+    return 2;
+  }
+  if (!options->trace.empty() && !APTrace::Enabled()) {
+    std::fprintf(stderr,
+                 "realtime: --trace needs a build with AUTOPILOT_TRACE\n");
+    return 2;
+  }
+
+  Autopilots autopilots;
+  auto& dynamic = autopilots.dynamic;
+  dynamic[static_cast<size_t>(Config::kExact)].emplace(BaseProfile());
+  dynamic[static_cast<size_t>(Config::kFast)].emplace(BaseProfile());
+  dynamic[static_cast<size_t>(Config::kFast)]->WithMathMode(APMathMode::kFast);
+  dynamic[static_cast<size_t>(Config::kLimited)].emplace(LimitedProfile());
+  dynamic[static_cast<size_t>(Config::kTelemetry)].emplace(LimitedProfile());
+  dynamic[static_cast<size_t>(Config::kTelemetry)]->WithTelemetry(
+      &autopilots.ring);
+  dynamic[static_cast<size_t>(Config::kBaked)].emplace(BaseProfile());
+  dynamic[static_cast<size_t>(Config::kIntercept)].emplace(BaseProfile());
+  autopilots.interceptor.emplace(
+      *dynamic[static_cast<size_t>(Config::kIntercept)]);
+
+  // Bake a few targets, so that the field's lookups are exercised too
+  std::mt19937 rng{options->seed};
+  std::uniform_real_distribution<double> field(-6.0, 6.0);
+  std::uniform_real_distribution<double> angle(-std::numbers::pi,
+                                               std::numbers::pi);
+  for (size_t i = 0; i < kBakedTargets; ++i) {
+    autopilots.baked.push_back(
+        APTarget{frc::Pose2d{units::meter_t{field(rng)},
+                             units::meter_t{field(rng)},
+                             frc::Rotation2d{units::radian_t{angle(rng)}}}}
+            .WithEntryAngle(frc::Rotation2d{units::radian_t{angle(rng)}}));
+  }
+  const std::string fieldPath =
+      (std::filesystem::temp_directory_path() / "autopilot_realtime_field.bin")
+          .string();
+  Autopilot& bakedAp = *dynamic[static_cast<size_t>(Config::kBaked)];
+  std::optional<APVelocityField> velocityField;
+  if (APVelocityField::Bake(bakedAp, autopilots.baked, 4_m,
+                            units::meter_t{0.1}, fieldPath)) {
+    velocityField = APVelocityField::Load(fieldPath);
+  }
+  if (!velocityField) {
+    std::fprintf(stderr, "realtime: cannot bake %s\n", fieldPath.c_str());
+    return 1;
+  }
+  bakedAp.WithVelocityField(&*velocityField);
+
+  double sink = 0.0;
+  std::vector<Call> calls;
+  calls.reserve(kLatencyCases);
+  for (size_t i = 0; i < kLatencyCases; ++i) {
+    calls.push_back(Draw(rng, autopilots));
+  }
+  std::vector<double> nanos(options->calls);
+  std::array<double, static_cast<size_t>(Config::kCount)> worst{};
+  for (const Call& call : calls) {
+    sink += Run(autopilots, call);
+  }
+
+  using Clock = std::chrono::steady_clock;
+  APTrace::Reset();
+  const std::string policy = EnterRealtime(options->priority);
+  for (size_t i = 0; i < options->calls; ++i) {
+    const Call& call = calls[i % kLatencyCases];
+    const auto start = Clock::now();
+    sink += Run(autopilots, call);
+    const auto end = Clock::now();
+    nanos[i] = std::chrono::duration<double, std::nano>(end - start).count();
+    double& configWorst = worst[static_cast<size_t>(call.config)];
+    configWorst = std::max(configWorst, nanos[i]);
+  }
+  // Two clock reads back to back, the floor under every sample above
+  double overhead = std::numeric_limits<double>::infinity();
+  for (size_t i = 0; i < kLatencyCases; ++i) {
+    const auto start = Clock::now();
+    const auto end = Clock::now();
+    overhead = std::min(
+        overhead,
+        std::chrono::duration<double, std::nano>(end - start).count());
+  }
+  LeaveRealtime();
+
+  std::sort(nanos.begin(), nanos.end());
+  std::printf("latency under %s, in ns per call including %.0f ns of clock "
+              "overhead:\n",
+              policy.c_str(), overhead);
+  std::printf("  p50 %.0f, p99 %.0f, p99.9 %.0f, p99.99 %.0f, max %.0f\n",
+              Percentile(nanos, 0.5), Percentile(nanos, 0.99),
+              Percentile(nanos, 0.999), Percentile(nanos, 0.9999),
+              nanos.back());
+  std::printf("  worst by configuration:");
+  for (size_t i = 0; i < worst.size(); ++i) {
+    std::printf(" %s %.0f", kConfigNames[i], worst[i]);
+  }
+  std::printf("\n");
+
+  if (!options->trace.empty()) {
+    std::printf("stages, in ns with percentiles rounded up to powers of "
+                "two:\n");
+    for (size_t i = 0; i < APTrace::kStageNames.size(); ++i) {
+      const APStageHistogram histogram =
+          APTrace::Histogram(static_cast<APStage>(i));
+      if (histogram.count == 0) {
+        continue;
+      }
+      std::printf("  %-10.*s %10llu calls, mean %6.0f, p50 %6llu, p99 %6llu, "
+                  "max %llu\n",
+                  static_cast<int>(APTrace::kStageNames[i].size()),
+                  APTrace::kStageNames[i].data(),
+                  static_cast<unsigned long long>(histogram.count),
+                  static_cast<double>(histogram.totalNanos) / histogram.count,
+                  static_cast<unsigned long long>(histogram.Percentile(0.5)),
+                  static_cast<unsigned long long>(histogram.Percentile(0.99)),
+                  static_cast<unsigned long long>(histogram.maxNanos));
+    }
+    if (!APTrace::WriteChromeTrace(options->trace)) {
+      std::fprintf(stderr, "realtime: cannot write %s\n",
+                   options->trace.c_str());
+      return 1;
+    }
+    std::printf("wrote the last %zu events per thread to %s\n",
+                APTrace::kEvents, options->trace.c_str());
+  }
+
+  // Keeps the calls from being optimized away
+  if (sink == std::numeric_limits<double>::infinity()) {
+    std::printf("\n");
+  }
+  return 0;
+}
@@ -0,0 +1,254 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <numbers>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "autopilot/autopilot.h"
+#include "autopilot/telemetry.h"
+#include "telemetry_log.h"
+#include "tools.h"
+
+using namespace tools;
+using namespace autopilot;
+
+namespace {
+struct ReplayOptions {
+  unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+  double tolerance = 1e-9;
+  bool fast = false;
+};
+
+struct LogResult {
+  std::string error;
+  size_t bytes = 0;
+  size_t records = 0;
+  // Records logged before any profile, which cannot be replayed
+  size_t skipped = 0;
+  // Records whose goal came from a velocity field, which replay does not load
+  size_t fieldBacked = 0;
+  size_t mismatched = 0;
+  size_t branchChanges = 0;
+  double maxVelocity = 0.0;
+  double maxHeading = 0.0;
+  double maxOmega = 0.0;
+  std::optional<int64_t> firstMismatch;
+};
+
+// Replays the records of one logger
+struct Replayer {
+  std::optional<Autopilot> autopilot;
+  // Receives the branch the replayed Calculate took
+  APTelemetryRing ring{1};
+  std::optional<APPreparedTarget> prepared;
+  APRecord target;
+};
+
+bool Same(double a, double b) {
+  return std::bit_cast<uint64_t>(a) == std::bit_cast<uint64_t>(b);
+}
+
+// Whether two records were calculated against the same target
+bool SameTarget(const APRecord& a, const APRecord& b) {
+  return Same(a.targetX, b.targetX) && Same(a.targetY, b.targetY) &&
+         Same(a.targetHeading, b.targetHeading) &&
+         Same(a.entryAngle, b.entryAngle) &&
+         Same(a.rotationRadius, b.rotationRadius) &&
+         Same(a.endVelocity, b.endVelocity);
+}
+
+LogResult ReplayLog(std::string_view path, const ReplayOptions& options) {
+  LogResult result;
+  TelemetryLog log{path};
+  if (!log.IsValid()) {
+    result.error = log.Error();
+    return result;
+  }
+  result.bytes = log.Size();
+
+  std::unordered_map<std::string, Replayer> replayers;
+  auto onProfile = [&](std::string_view name,
+                       std::span<const double> profile) {
+    Replayer& replayer = replayers.try_emplace(std::string{name}).first->second;
+    replayer.autopilot = MakeAutopilot(profile);
+    replayer.prepared.reset();
+    if (replayer.autopilot) {
+      if (options.fast) {
+        replayer.autopilot->WithMathMode(APMathMode::kFast);
+      }
+      replayer.autopilot->WithTelemetry(&replayer.ring);
+    }
+  };
+
+  auto onRecord = [&](std::string_view name, const APRecord& record) {
+    ++result.records;
+    if (record.field) {
+      ++result.fieldBacked;
+      return;
+    }
+    auto it = replayers.find(std::string{name});
+    if (it == replayers.end() || !it->second.autopilot) {
+      ++result.skipped;
+      return;
+    }
+
+    Replayer& replayer = it->second;
+    if (!replayer.prepared || !SameTarget(record, replayer.target)) {
+      replayer.prepared.emplace(
+          replayer.autopilot->Prepare(MakeTarget(record)));
+      replayer.target = record;
+    }
+
+    APResult out = replayer.autopilot->Calculate(
+        frc::Pose2d{units::meter_t{record.x}, units::meter_t{record.y},
+                    frc::Rotation2d{units::radian_t{record.heading}}},
+        frc::ChassisSpeeds{
+            .vx = units::meters_per_second_t{record.vx},
+            .vy = units::meters_per_second_t{record.vy},
+            .omega = units::radians_per_second_t{record.omega}},
+        *replayer.prepared, units::second_t{record.dt});
+    APRecord replayed;
+    replayer.ring.TryPop(replayed);
+
+    const double velocity =
+        std::max(std::abs(out.vx.value() - record.outVx),
+                 std::abs(out.vy.value() - record.outVy));
+    const double heading = std::abs(
+        std::remainder(out.targetAngle.Radians().value() - record.outHeading,
+                       2.0 * std::numbers::pi));
+    const double omega = std::abs(out.omega.value() - record.outOmega);
+    result.maxVelocity = std::max(result.maxVelocity, velocity);
+    result.maxHeading = std::max(result.maxHeading, heading);
+    result.maxOmega = std::max(result.maxOmega, omega);
+    result.branchChanges += replayed.branch != record.branch ? 1 : 0;
+
+    // Written so that NaN outputs count as mismatches
+    if (!(std::max({velocity, heading, omega}) <= options.tolerance)) {
+      ++result.mismatched;
+      if (!result.firstMismatch) {
+        result.firstMismatch = record.timestamp;
+      }
+    }
+  };
+
+  log.Read(onProfile, onRecord);
+  return result;
+}
+
+std::optional<ReplayOptions> ParseOptions(Args& args) {
+  ReplayOptions options;
+  while (!args.empty() && args.front().starts_with("--")) {
+    const std::string_view flag = args.front();
+    args = args.subspan(1);
+    if (flag == "--fast") {
+      options.fast = true;
+      continue;
+    }
+    if (args.empty()) {
+      std::fprintf(stderr, "replay: %.*s needs a value\n",
+                   static_cast<int>(flag.size()), flag.data());
+      return std::nullopt;
+    }
+    const std::string value{args.front()};
+    args = args.subspan(1);
+    if (flag == "--jobs") {
+      options.jobs = std::max(1ul, std::strtoul(value.c_str(), nullptr, 10));
+    } else if (flag == "--tolerance") {
+      options.tolerance = std::strtod(value.c_str(), nullptr);
+    } else {
+      std::fprintf(stderr, "replay: unknown option %.*s\n",
+                   static_cast<int>(flag.size()), flag.data());
+      return std::nullopt;
+    }
+  }
+  return options;
+}
+}  // namespace
+
+int tools::Replay(Args args) {
+  std::optional<ReplayOptions> options = ParseOptions(args);
+  if (!options) {
+    return 2;
+  }
+  if (args.empty()) {
+    std::fprintf(stderr,
+                 "usage: replay [--jobs N] [--tolerance T] [--fast] "
+                 "<log.wpilog>...\n");
+    return 2;
+  }
+
+  // Workers claim logs one at a time, so one long log does not hold up the
+  // rest
+  std::vector<LogResult> results(args.size());
+  std::atomic<size_t> next{0};
+  const unsigned jobs =
+      std::min<unsigned>(options->jobs, static_cast<unsigned>(args.size()));
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> workers;
+  for (unsigned i = 0; i < jobs; ++i) {
+    workers.emplace_back([&] {
+      for (size_t log = next++; log < args.size(); log = next++) {
+        results[log] = ReplayLog(args[log], *options);
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  const double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+
+  size_t records = 0;
+  size_t bytes = 0;
+  bool failed = false;
+  for (size_t i = 0; i < args.size(); ++i) {
+    const LogResult& result = results[i];
+    const int nameLength = static_cast<int>(args[i].size());
+    if (!result.error.empty()) {
+      std::printf("%.*s: %s\n", nameLength, args[i].data(),
+                  result.error.c_str());
+      failed = true;
+      continue;
+    }
+    records += result.records;
+    bytes += result.bytes;
+    failed = failed || result.mismatched > 0;
+    std::printf(
+        "%.*s: %zu records, %zu mismatched, %zu branch changes, %zu skipped, "
+        "%zu field backed, max |dv| %.3g m/s, max |dtheta| %.3g rad, "
+        "max |domega| %.3g rad/s\n",
+        nameLength, args[i].data(), result.records, result.mismatched,
+        result.branchChanges, result.skipped, result.fieldBacked,
+        result.maxVelocity,
+        result.maxHeading, result.maxOmega);
+    if (result.firstMismatch) {
+      std::printf("  first mismatch at %.6f s\n",
+                  static_cast<double>(*result.firstMismatch) / 1e6);
+    }
+  }
+
+  std::printf("%zu logs, %zu records in %.3f s on %u threads: "
+              "%.3g records/s, %.1f MB/s\n",
+              args.size(), records, seconds, jobs, records / seconds,
+              bytes / seconds / 1e6);
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,256 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include "simulation.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <numbers>
+#include <random>
+#include <string>
+
+using namespace tools;
+using namespace autopilot;
+
+namespace {
+// Length of the pose history, which bounds the measurement latency
+constexpr size_t kPoseHistory = 64;
+
+// Commanded speeds towards the target below this do not count towards
+// oscillations, in meters per second
+constexpr double kMinOscillationSpeed = 0.01;
+
+double Radians(double degrees) {
+  return degrees * std::numbers::pi / 180.0;
+}
+}  // namespace
+
+SimResult tools::Simulate(Autopilot& autopilot, const Scenario& scenario,
+                          const SimOptions& options, uint64_t seed) {
+  autopilot.WithPeriod(options.step);
+  autopilot.ClearCommandHistory();
+  const APPreparedTarget prepared = autopilot.Prepare(scenario.target);
+  const bool rotating = autopilot.Limits().rotating;
+  const int substeps = std::max(options.substeps, 1);
+  const units::second_t substep = options.step / substeps;
+  const double maxOmega = options.maxOmega.value();
+  const double targetX = scenario.target.Reference().X().value();
+  const double targetY = scenario.target.Reference().Y().value();
+
+  std::mt19937_64 rng{seed};
+  std::normal_distribution<double> poseNoise{0.0,
+                                             options.noise.pose.value()};
+  std::normal_distribution<double> headingNoise{
+      0.0, options.noise.heading.value()};
+  const bool noisy =
+      options.noise.pose > 0_m || options.noise.heading > 0_rad;
+
+  // Poses are measured from a short history of true poses
+  const size_t latencyTicks = std::min<size_t>(
+      static_cast<size_t>(std::max(
+          std::round(options.noise.latency / options.step), 0.0)),
+      kPoseHistory - 1);
+  const units::second_t latency = options.step * latencyTicks;
+  std::array<frc::Pose2d, kPoseHistory> poses;
+  poses.fill(scenario.start);
+
+  APSwervePlant plant{options.plant};
+  plant.Reset(scenario.start,
+              frc::ChassisSpeeds{.vx = scenario.velocity.X() / 1_s,
+                                 .vy = scenario.velocity.Y() / 1_s});
+
+  // Approach direction, once captured
+  std::optional<std::pair<double, double>> approach;
+  SimResult result;
+  units::second_t arrivedAt = 0_s;
+  bool wasAtTarget = false;
+  int lastDirection = 0;
+
+  size_t tick = 0;
+  units::second_t time = 0_s;
+  for (; time < options.timeout; time += options.step, ++tick) {
+    poses[tick % kPoseHistory] = plant.Pose();
+    const frc::Pose2d& pose = plant.Pose();
+    const frc::Pose2d& stale =
+        tick < latencyTicks
+            ? scenario.start
+            : poses[(tick - latencyTicks) % kPoseHistory];
+    const frc::ChassisSpeeds velocity = plant.Velocity();
+    const double vx = velocity.vx.value();
+    const double vy = velocity.vy.value();
+    const double ex = pose.X().value() - targetX;
+    const double ey = pose.Y().value() - targetY;
+    const double dist = std::hypot(ex, ey);
+    if (!approach && dist <= options.captureRadius.value()) {
+      const double speed = std::hypot(vx, vy);
+      if (speed > 1e-6) {
+        approach.emplace(vx / speed, vy / speed);
+      } else if (dist > 1e-6) {
+        approach.emplace(-ex / dist, -ey / dist);
+      }
+    }
+    if (approach) {
+      const double past = ex * approach->first + ey * approach->second;
+      result.overshoot = std::max(result.overshoot, units::meter_t{past});
+    }
+
+    const frc::Pose2d measured =
+        noisy ? frc::Pose2d{stale.X() + units::meter_t{poseNoise(rng)},
+                            stale.Y() + units::meter_t{poseNoise(rng)},
+                            stale.Rotation() +
+                                frc::Rotation2d{units::radian_t{
+                                    headingNoise(rng)}}}
+              : stale;
+    const bool atTarget = autopilot.AtTarget(measured, scenario.target);
+    if (atTarget && !result.arrived) {
+      result.arrived = true;
+      result.time = time;
+      arrivedAt = time;
+    }
+    if (wasAtTarget && !atTarget) {
+      ++result.exits;
+    }
+    wasAtTarget = atTarget;
+    if (result.arrived && time - arrivedAt >= options.settle) {
+      break;
+    }
+
+    APResult out =
+        options.compensateLatency
+            ? autopilot.Calculate(APTimestampedPose{measured, time - latency},
+                                  velocity, prepared, time, options.step)
+            : autopilot.Calculate(measured, velocity, prepared,
+                                  options.step);
+
+    // A reversal is a sign change of the speed towards the target, ignoring
+    // speeds too small to matter
+    if (dist > 1e-9) {
+      const double towards =
+          -(out.vx.value() * ex + out.vy.value() * ey) / dist;
+      const int direction = towards > kMinOscillationSpeed    ? 1
+                            : towards < -kMinOscillationSpeed ? -1
+                                                              : 0;
+      if (direction != 0) {
+        result.oscillations += lastDirection == -direction ? 1 : 0;
+        lastDirection = direction;
+      }
+    }
+
+    const double omega =
+        rotating ? out.omega.value()
+                 : options.headingGain *
+                       (out.targetAngle - measured.Rotation())
+                           .Radians()
+                           .value();
+    plant.SetCommand(frc::ChassisSpeeds{
+        .vx = out.vx,
+        .vy = out.vy,
+        .omega = units::radians_per_second_t{
+            std::clamp(omega, -maxOmega, maxOmega)}});
+    for (int i = 0; i < substeps; ++i) {
+      plant.Update(substep);
+    }
+  }
+
+  result.settled = result.arrived && result.exits == 0 &&
+                   time - arrivedAt >= options.settle;
+  if (!result.arrived) {
+    result.time = options.timeout;
+  }
+  result.finalError =
+      units::meter_t{std::hypot(plant.Pose().X().value() - targetX,
+                                plant.Pose().Y().value() - targetY)};
+  result.simulated = plant.Time();
+  return result;
+}
+
+std::vector<Scenario> tools::MakeScenarios(size_t count, uint32_t seed) {
+  std::mt19937 rng{seed};
+  std::uniform_real_distribution<double> fieldX(1.0, 15.0);
+  std::uniform_real_distribution<double> fieldY(1.0, 7.0);
+  std::uniform_real_distribution<double> angle(-std::numbers::pi,
+                                               std::numbers::pi);
+  std::uniform_real_distribution<double> dist(0.5, 8.0);
+  std::uniform_real_distribution<double> speed(0.0, 2.0);
+
+  std::vector<Scenario> scenarios;
+  scenarios.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    const frc::Rotation2d targetHeading{units::radian_t{angle(rng)}};
+    APTarget target{frc::Pose2d{units::meter_t{fieldX(rng)},
+                                units::meter_t{fieldY(rng)}, targetHeading}};
+    if (i % 4 != 0) {
+      target = target.WithEntryAngle(targetHeading);
+    }
+    const frc::Translation2d offset{units::meter_t{dist(rng)},
+                                    frc::Rotation2d{units::radian_t{
+                                        angle(rng)}}};
+    const frc::Translation2d velocity{units::meter_t{speed(rng)},
+                                      frc::Rotation2d{units::radian_t{
+                                          angle(rng)}}};
+    scenarios.push_back(Scenario{
+        frc::Pose2d{target.Reference().Translation() + offset,
+                    frc::Rotation2d{units::radian_t{angle(rng)}}},
+        velocity, std::move(target)});
+  }
+  return scenarios;
+}
+
+std::optional<std::vector<Scenario>> tools::LoadScenarios(
+    std::string_view path) {
+  std::ifstream file{std::string{path}};
+  if (!file) {
+    return std::nullopt;
+  }
+
+  std::vector<Scenario> scenarios;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line.front() == '#') {
+      continue;
+    }
+
+    double fields[9];
+    size_t count = 0;
+    const char* cursor = line.c_str();
+    while (count < std::size(fields)) {
+      char* end;
+      fields[count] = std::strtod(cursor, &end);
+      if (end == cursor) {
+        break;
+      }
+      ++count;
+      cursor = end;
+      if (*cursor != ',') {
+        break;
+      }
+      ++cursor;
+    }
+    if (count < 8) {
+      return std::nullopt;
+    }
+
+    APTarget target{frc::Pose2d{
+        units::meter_t{fields[5]}, units::meter_t{fields[6]},
+        frc::Rotation2d{units::radian_t{Radians(fields[7])}}}};
+    if (count == 9) {
+      target = target.WithEntryAngle(
+          frc::Rotation2d{units::radian_t{Radians(fields[8])}});
+    }
+    scenarios.push_back(Scenario{
+        frc::Pose2d{units::meter_t{fields[0]}, units::meter_t{fields[1]},
+                    frc::Rotation2d{units::radian_t{Radians(fields[2])}}},
+        frc::Translation2d{units::meter_t{fields[3]},
+                           units::meter_t{fields[4]}},
+        std::move(target)});
+  }
+  return scenarios;
+}
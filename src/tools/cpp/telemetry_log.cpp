@@ -0,0 +1,164 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include "telemetry_log.h"
+
+#include <wpi/MemoryBuffer.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+
+using namespace tools;
+using namespace autopilot;
+
+namespace {
+// Number of fields in APTelemetryLogger::kProfileFields
+constexpr size_t kProfileSize = 15;
+
+// Copies up to N doubles out of a raw record payload. Payloads are not
+// aligned for doubles, so they cannot be viewed in place.
+template <size_t N>
+std::span<const double> Decode(std::span<const uint8_t> raw,
+                               std::array<double, N>& out) {
+  const size_t count = std::min(N, raw.size() / sizeof(double));
+  std::memcpy(out.data(), raw.data(), count * sizeof(double));
+  return std::span<const double>{out.data(), count};
+}
+
+enum class EntryKind { kProfile, kRecord };
+}  // namespace
+
+TelemetryLog::TelemetryLog(std::string_view path) {
+  auto buffer = wpi::MemoryBuffer::GetFile(path);
+  if (!buffer) {
+    m_error = buffer.error().message();
+    return;
+  }
+  m_size = (*buffer)->size();
+  m_reader.emplace(std::move(*buffer));
+  if (!m_reader->IsValid()) {
+    m_reader.reset();
+    m_error = "not a WPILog file";
+  }
+}
+
+bool TelemetryLog::IsValid() const {
+  return m_reader.has_value();
+}
+
+const std::string& TelemetryLog::Error() const {
+  return m_error;
+}
+
+size_t TelemetryLog::Size() const {
+  return m_size;
+}
+
+void TelemetryLog::Read(const ProfileHandler& onProfile,
+                        const RecordHandler& onRecord) {
+  if (!m_reader) {
+    return;
+  }
+
+  // Entry id to the kind of entry and the name of the logger that wrote it
+  std::unordered_map<int, std::pair<EntryKind, std::string>> entries;
+  std::array<double, APRecord::kSize> fields;
+  std::array<double, kProfileSize> profile;
+
+  for (const wpi::log::DataLogRecord& record : *m_reader) {
+    if (record.IsStart()) {
+      wpi::log::StartRecordData start;
+      if (!record.GetStartData(&start) || start.type != "double[]") {
+        continue;
+      }
+      const size_t slash = start.name.rfind('/');
+      if (slash == std::string_view::npos) {
+        continue;
+      }
+      const std::string_view suffix = start.name.substr(slash + 1);
+      const std::string name{start.name.substr(0, slash)};
+      if (suffix == "profile") {
+        entries[start.entry] = {EntryKind::kProfile, name};
+      } else if (suffix == "record") {
+        entries[start.entry] = {EntryKind::kRecord, name};
+      }
+      continue;
+    }
+    if (record.IsFinish()) {
+      int entry;
+      if (record.GetFinishEntry(&entry)) {
+        entries.erase(entry);
+      }
+      continue;
+    }
+    if (record.IsControl()) {
+      continue;
+    }
+
+    auto it = entries.find(record.GetEntry());
+    if (it == entries.end()) {
+      continue;
+    }
+    const auto& [kind, name] = it->second;
+    if (kind == EntryKind::kProfile) {
+      onProfile(name, Decode(record.GetRaw(), profile));
+    } else {
+      onRecord(name, APRecord::Unpack(Decode(record.GetRaw(), fields),
+                                      record.GetTimestamp()));
+    }
+  }
+}
+
+std::optional<Autopilot> tools::MakeAutopilot(
+    std::span<const double> profile) {
+  if (profile.size() < kProfileSize) {
+    return std::nullopt;
+  }
+
+  APConstraints constraints =
+      APConstraints(units::meters_per_second_t{profile[0]},
+                    units::meters_per_second_squared_t{profile[1]},
+                    profile[2])
+          .withRotationVelocity(units::radians_per_second_t{profile[6]})
+          .withRotationAcceleration(
+              units::radians_per_second_squared_t{profile[7]})
+          .withRotationJerk(profile[8])
+          .withFrictionCircle(profile[11] != 0.0)
+          .withDeceleration(units::meters_per_second_squared_t{profile[12]})
+          .withAxisVelocity(units::meters_per_second_t{profile[13]},
+                            units::meters_per_second_t{profile[14]});
+  Autopilot autopilot{APProfile(constraints)
+                          .WithErrorXY(units::meter_t{profile[3]})
+                          .WithErrorTheta(units::radian_t{profile[4]})
+                          .WithBeelineRadius(units::meter_t{profile[5]})};
+  autopilot.WithPeriod(units::second_t{profile[9]})
+      .WithMathMode(static_cast<APMathMode>(profile[10]));
+  return autopilot;
+}
+
+APTarget tools::MakeTarget(const APRecord& record) {
+  APTarget target =
+      APTarget{frc::Pose2d{units::meter_t{record.targetX},
+                           units::meter_t{record.targetY},
+                           frc::Rotation2d{
+                               units::radian_t{record.targetHeading}}}}
+          .WithVelocity(units::meters_per_second_t{record.endVelocity});
+  if (!std::isnan(record.entryAngle)) {
+    target = target.WithEntryAngle(
+        frc::Rotation2d{units::radian_t{record.entryAngle}});
+  }
+  if (std::isfinite(record.rotationRadius)) {
+    target = target.WithRotationRadius(
+        units::meter_t{record.rotationRadius});
+  }
+  return target;
+}
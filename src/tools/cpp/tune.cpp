@@ -0,0 +1,322 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numbers>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "autopilot/autopilot.h"
+#include "simulation.h"
+#include "tools.h"
+#include "work_stealing_pool.h"
+
+using namespace tools;
+using namespace autopilot;
+
+namespace {
+// Velocity, acceleration, jerk and beeline radius
+constexpr size_t kParams = 4;
+constexpr const char* kParamNames[kParams] = {"velocity", "acceleration",
+                                              "jerk", "beeline"};
+using Params = std::array<double, kParams>;
+
+struct Range {
+  double min;
+  double max;
+  int steps;
+
+  double At(int i) const {
+    return steps <= 1 ? min : min + (max - min) * i / (steps - 1);
+  }
+};
+
+struct TuneOptions {
+  std::array<Range, kParams> ranges = {Range{3.0, 5.0, 5},
+                                       Range{2.0, 6.0, 5},
+                                       Range{1.0, 5.0, 5},
+                                       Range{0.04, 0.24, 5}};
+  double errorXY = 0.02;
+  double errorTheta = 2.0;
+  double maxOvershoot = 0.03;
+  size_t scenarioCount = 64;
+  uint32_t seed = 5805;
+  std::string scenarioFile;
+  unsigned jobs = 0;
+  int refineRounds = 8;
+  SimOptions sim;
+};
+
+struct Score {
+  double totalTime = 0.0;
+  double maxOvershoot = 0.0;
+  // Scenarios that never arrived or did not settle
+  size_t failures = 0;
+  // Scenarios that overshot by more than the limit
+  size_t violations = 0;
+
+  bool Feasible() const { return failures == 0 && violations == 0; }
+
+  // Feasible scores first, then fewest problems, then fastest
+  bool operator<(const Score& other) const {
+    return std::make_tuple(!Feasible(), failures + violations, totalTime) <
+           std::make_tuple(!other.Feasible(),
+                           other.failures + other.violations,
+                           other.totalTime);
+  }
+};
+
+APProfile MakeProfile(const Params& params, const TuneOptions& options) {
+  return APProfile(APConstraints(units::meters_per_second_t{params[0]},
+                                 units::meters_per_second_squared_t{
+                                     params[1]},
+                                 params[2]))
+      .WithErrorXY(units::meter_t{options.errorXY})
+      .WithErrorTheta(
+          units::radian_t{options.errorTheta * std::numbers::pi / 180.0})
+      .WithBeelineRadius(units::meter_t{params[3]});
+}
+
+// Simulates every candidate on every scenario, one task per pair
+std::vector<Score> Evaluate(WorkStealingPool& pool,
+                            const std::vector<Params>& candidates,
+                            const std::vector<Scenario>& scenarios,
+                            const TuneOptions& options) {
+  std::vector<SimResult> results(candidates.size() * scenarios.size());
+  pool.ParallelFor(results.size(), [&](size_t i) {
+    Autopilot autopilot{
+        MakeProfile(candidates[i / scenarios.size()], options)};
+    results[i] =
+        Simulate(autopilot, scenarios[i % scenarios.size()], options.sim);
+  });
+
+  std::vector<Score> scores(candidates.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    Score& score = scores[i / scenarios.size()];
+    const SimResult& result = results[i];
+    score.totalTime += result.time.value();
+    score.maxOvershoot =
+        std::max(score.maxOvershoot, result.overshoot.value());
+    score.failures += result.settled ? 0 : 1;
+    score.violations +=
+        result.overshoot.value() > options.maxOvershoot ? 1 : 0;
+  }
+  return scores;
+}
+
+std::optional<Range> ParseRange(const std::string& value) {
+  Range range{0.0, 0.0, 1};
+  char* end;
+  range.min = range.max = std::strtod(value.c_str(), &end);
+  if (end == value.c_str()) {
+    return std::nullopt;
+  }
+  if (*end == ':') {
+    const char* cursor = end + 1;
+    range.max = std::strtod(cursor, &end);
+    if (end == cursor || *end != ':') {
+      return std::nullopt;
+    }
+    range.steps = std::max(1, std::atoi(end + 1));
+  }
+  return range;
+}
+
+std::optional<TuneOptions> ParseOptions(Args args) {
+  TuneOptions options;
+  while (!args.empty()) {
+    const std::string_view flag = args.front();
+    if (args.size() < 2 || !flag.starts_with("--")) {
+      std::fprintf(stderr, "tune: unexpected argument %.*s\n",
+                   static_cast<int>(flag.size()), flag.data());
+      return std::nullopt;
+    }
+    const std::string value{args[1]};
+    args = args.subspan(2);
+
+    bool known = false;
+    for (size_t i = 0; i < kParams; ++i) {
+      if (flag.substr(2) == kParamNames[i]) {
+        std::optional<Range> range = ParseRange(value);
+        if (!range) {
+          std::fprintf(stderr, "tune: expected min:max:steps for %s\n",
+                       kParamNames[i]);
+          return std::nullopt;
+        }
+        options.ranges[i] = *range;
+        known = true;
+      }
+    }
+    if (known) {
+      continue;
+    }
+
+    const double number = std::strtod(value.c_str(), nullptr);
+    if (flag == "--error-xy") {
+      options.errorXY = number;
+    } else if (flag == "--error-theta") {
+      options.errorTheta = number;
+    } else if (flag == "--max-overshoot") {
+      options.maxOvershoot = number;
+    } else if (flag == "--scenarios") {
+      options.scenarioCount = static_cast<size_t>(number);
+    } else if (flag == "--scenario-file") {
+      options.scenarioFile = value;
+    } else if (flag == "--seed") {
+      options.seed = static_cast<uint32_t>(number);
+    } else if (flag == "--jobs") {
+      options.jobs = static_cast<unsigned>(number);
+    } else if (flag == "--refine") {
+      options.refineRounds = static_cast<int>(number);
+    } else if (flag == "--lag") {
+      options.sim.plant.lag = units::second_t{number};
+    } else if (flag == "--plant-accel") {
+      options.sim.plant.maxModuleAcceleration =
+          units::meters_per_second_squared_t{number};
+    } else if (flag == "--plant-velocity") {
+      options.sim.plant.maxModuleVelocity =
+          units::meters_per_second_t{number};
+    } else if (flag == "--latency") {
+      options.sim.plant.latency = units::second_t{number};
+    } else {
+      std::fprintf(stderr, "tune: unknown option %.*s\n",
+                   static_cast<int>(flag.size()), flag.data());
+      return std::nullopt;
+    }
+  }
+  return options;
+}
+
+void PrintScore(const char* label, const Params& params, const Score& score,
+                size_t scenarios) {
+  std::printf("%s: velocity %.3g, acceleration %.3g, jerk %.3g, beeline "
+              "%.3g m -> %.2f s total (%.3f s mean), max overshoot %.1f cm, "
+              "%zu failed, %zu overshot\n",
+              label, params[0], params[1], params[2], params[3],
+              score.totalTime, score.totalTime / scenarios,
+              score.maxOvershoot * 100.0, score.failures, score.violations);
+}
+}  // namespace
+
+int tools::Tune(Args args) {
+  std::optional<TuneOptions> options = ParseOptions(args);
+  if (!options) {
+    return 2;
+  }
+
+  std::vector<Scenario> scenarios;
+  if (options->scenarioFile.empty()) {
+    scenarios = MakeScenarios(options->scenarioCount, options->seed);
+  } else if (auto loaded = LoadScenarios(options->scenarioFile)) {
+    scenarios = std::move(*loaded);
+  } else {
+    std::fprintf(stderr, "tune: cannot read scenarios from %s\n",
+                 options->scenarioFile.c_str());
+    return 2;
+  }
+  if (scenarios.empty()) {
+    std::fprintf(stderr, "tune: no scenarios\n");
+    return 2;
+  }
+
+  WorkStealingPool pool{options->jobs};
+  auto start = std::chrono::steady_clock::now();
+  size_t simulations = 0;
+
+  // Sweep the full grid
+  std::vector<Params> grid;
+  const auto& r = options->ranges;
+  for (int a = 0; a < r[0].steps; ++a) {
+    for (int b = 0; b < r[1].steps; ++b) {
+      for (int c = 0; c < r[2].steps; ++c) {
+        for (int d = 0; d < r[3].steps; ++d) {
+          grid.push_back(Params{r[0].At(a), r[1].At(b), r[2].At(c),
+                                r[3].At(d)});
+        }
+      }
+    }
+  }
+  std::vector<Score> scores = Evaluate(pool, grid, scenarios, *options);
+  simulations += grid.size() * scenarios.size();
+  const size_t bestIndex =
+      std::min_element(scores.begin(), scores.end()) - scores.begin();
+  Params best = grid[bestIndex];
+  Score bestScore = scores[bestIndex];
+  PrintScore("grid best", best, bestScore, scenarios.size());
+
+  // Refine with a pattern search around the best grid point, starting from
+  // the grid spacing and halving it whenever no neighbour improves. The
+  // search stays within the ranges.
+  Params step;
+  for (size_t i = 0; i < kParams; ++i) {
+    step[i] = r[i].steps > 1 ? (r[i].max - r[i].min) / (r[i].steps - 1)
+                             : 0.1 * r[i].min;
+  }
+  for (int round = 0; round < options->refineRounds; ++round) {
+    std::vector<Params> neighbours;
+    for (size_t i = 0; i < kParams; ++i) {
+      for (double sign : {-1.0, 1.0}) {
+        Params candidate = best;
+        candidate[i] = std::clamp(best[i] + sign * step[i], r[i].min,
+                                  r[i].max);
+        if (candidate[i] != best[i]) {
+          neighbours.push_back(candidate);
+        }
+      }
+    }
+    std::vector<Score> neighbourScores =
+        Evaluate(pool, neighbours, scenarios, *options);
+    simulations += neighbours.size() * scenarios.size();
+
+    auto it = std::min_element(neighbourScores.begin(), neighbourScores.end());
+    if (it != neighbourScores.end() && *it < bestScore) {
+      best = neighbours[it - neighbourScores.begin()];
+      bestScore = *it;
+    } else {
+      for (double& s : step) {
+        s *= 0.5;
+      }
+    }
+  }
+  PrintScore("refined", best, bestScore, scenarios.size());
+
+  const double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  std::printf("%zu simulations of %zu scenarios in %.2f s on %u threads\n",
+              simulations, scenarios.size(), seconds, pool.Size());
+
+  if (!bestScore.Feasible()) {
+    std::printf("no candidate met the overshoot and tolerance limits\n");
+    return 1;
+  }
+
+  std::printf(
+      "\nAPProfile(APConstraints(%.3g_mps, %.3g_mps_sq, %.3g))\n"
+      "    .WithErrorXY(%.3g_m)\n"
+      "    .WithErrorTheta(%.3g_deg)\n"
+      "    .WithBeelineRadius(%.3g_m)\n",
+      best[0], best[1], best[2], options->errorXY, options->errorTheta,
+      best[3]);
+  std::printf(
+      "\nAPStaticProfile{.velocity = %.3g,\n"
+      "                .acceleration = %.3g,\n"
+      "                .jerk = %.3g,\n"
+      "                .errorXY = %.3g,\n"
+      "                .errorTheta = %.6g,\n"
+      "                .beelineRadius = %.3g}\n",
+      best[0], best[1], best[2], options->errorXY,
+      options->errorTheta * std::numbers::pi / 180.0, best[3]);
+  return 0;
+}
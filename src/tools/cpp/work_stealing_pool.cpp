@@ -0,0 +1,158 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace tools;
+
+namespace {
+// Chunks queued per worker by ParallelFor, enough for stealing to even out
+// tasks of uneven length
+constexpr size_t kChunksPerWorker = 8;
+}  // namespace
+
+WorkStealingPool::WorkStealingPool(unsigned threads) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (unsigned i = 0; i < threads; ++i) {
+    m_workers.push_back(std::make_unique<Worker>());
+  }
+  for (unsigned i = 0; i < threads; ++i) {
+    m_threads.emplace_back([this, i] { Run(i); });
+  }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    std::scoped_lock lock{m_sleepMutex};
+    m_stopping = true;
+  }
+  m_wake.notify_all();
+  for (std::thread& thread : m_threads) {
+    thread.join();
+  }
+}
+
+unsigned WorkStealingPool::Size() const {
+  return static_cast<unsigned>(m_workers.size());
+}
+
+void WorkStealingPool::ParallelFor(size_t count,
+                                   const std::function<void(size_t)>& fn) {
+  if (count == 0) {
+    return;
+  }
+
+  const size_t chunks = std::min(count, m_workers.size() * kChunksPerWorker);
+  // Only touched under doneMutex, so once the caller sees zero no task will
+  // touch doneMutex or done again, and both may go out of scope
+  size_t remaining = chunks;
+  std::mutex doneMutex;
+  std::condition_variable done;
+
+  for (size_t chunk = 0; chunk < chunks; ++chunk) {
+    const size_t begin = count * chunk / chunks;
+    const size_t end = count * (chunk + 1) / chunks;
+    Push(chunk % m_workers.size(), [&, begin, end] {
+      for (size_t i = begin; i < end; ++i) {
+        fn(i);
+      }
+      std::scoped_lock lock{doneMutex};
+      if (--remaining == 0) {
+        done.notify_all();
+      }
+    });
+  }
+
+  // Help out instead of sleeping while there is work to steal
+  Task task;
+  while (true) {
+    {
+      std::scoped_lock lock{doneMutex};
+      if (remaining == 0) {
+        return;
+      }
+    }
+    if (Steal(m_workers.size(), task)) {
+      task();
+      task = nullptr;
+      continue;
+    }
+    std::unique_lock lock{doneMutex};
+    done.wait(lock, [&] {
+      return remaining == 0 || m_pending.load(std::memory_order_acquire) > 0;
+    });
+  }
+}
+
+void WorkStealingPool::Push(size_t worker, Task task) {
+  {
+    std::scoped_lock lock{m_workers[worker]->mutex};
+    m_workers[worker]->tasks.push_back(std::move(task));
+  }
+  {
+    // Taking the lock orders the increment with a sleeping worker's check
+    std::scoped_lock lock{m_sleepMutex};
+    m_pending.fetch_add(1, std::memory_order_release);
+  }
+  m_wake.notify_one();
+}
+
+bool WorkStealingPool::PopLocal(size_t worker, Task& task) {
+  Worker& self = *m_workers[worker];
+  std::scoped_lock lock{self.mutex};
+  if (self.tasks.empty()) {
+    return false;
+  }
+  task = std::move(self.tasks.back());
+  self.tasks.pop_back();
+  m_pending.fetch_sub(1, std::memory_order_acq_rel);
+  return true;
+}
+
+bool WorkStealingPool::Steal(size_t thief, Task& task) {
+  const size_t count = m_workers.size();
+  for (size_t offset = 1; offset <= count; ++offset) {
+    const size_t victim = (thief + offset) % count;
+    if (victim == thief) {
+      continue;
+    }
+    Worker& other = *m_workers[victim];
+    std::scoped_lock lock{other.mutex};
+    if (other.tasks.empty()) {
+      continue;
+    }
+    task = std::move(other.tasks.front());
+    other.tasks.pop_front();
+    m_pending.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+  }
+  return false;
+}
+
+void WorkStealingPool::Run(size_t worker) {
+  Task task;
+  while (true) {
+    if (PopLocal(worker, task) || Steal(worker, task)) {
+      task();
+      task = nullptr;
+      continue;
+    }
+    std::unique_lock lock{m_sleepMutex};
+    m_wake.wait(lock, [&] {
+      return m_stopping || m_pending.load(std::memory_order_acquire) > 0;
+    });
+    if (m_stopping && m_pending.load(std::memory_order_acquire) == 0) {
+      return;
+    }
+  }
+}
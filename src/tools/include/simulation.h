@@ -0,0 +1,133 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include <frc/geometry/Pose2d.h>
+#include <frc/geometry/Translation2d.h>
+#include <units/acceleration.h>
+#include <units/angle.h>
+#include <units/angular_velocity.h>
+#include <units/length.h>
+#include <units/time.h>
+#include <units/velocity.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "autopilot/autopilot.h"
+#include "autopilot/swerve_plant.h"
+#include "autopilot/target.h"
+
+namespace tools {
+/**
+ * A start state and the target to drive to from it.
+ */
+struct Scenario {
+  frc::Pose2d start;
+  // Field relative, in meters per second
+  frc::Translation2d velocity;
+  autopilot::APTarget target;
+};
+
+/**
+ * Imperfect sensing. Everything defaults to zero, which gives a
+ * deterministic simulation.
+ */
+struct NoiseOptions {
+  // Standard deviation of the measured position along each axis
+  units::meter_t pose = 0_m;
+  // Standard deviation of the measured heading
+  units::radian_t heading = 0_rad;
+  // Age of the measured pose, rounded to whole steps. Up to 63 steps.
+  units::second_t latency = 0_s;
+};
+
+/**
+ * Parameters for a closed loop simulation.
+ */
+struct SimOptions {
+  units::second_t step = 20_ms;
+  units::second_t timeout = 10_s;
+  // How long the robot must stay within tolerance after arriving
+  units::second_t settle = 250_ms;
+  // Distance from the target at which the approach direction is captured
+  // for measuring overshoot
+  units::meter_t captureRadius = 30_cm;
+  // Plant updates per control step
+  int substeps = 4;
+  // The drivetrain. Its latency is the transport delay between Calculate
+  // and the modules acting on the result.
+  autopilot::APSwervePlantConfig plant{.maxModuleVelocity = 5_mps,
+                                       .maxModuleAcceleration = 8_mps_sq,
+                                       .lag = 50_ms};
+  // Without a rotational profile, the heading is driven towards the target
+  // angle by a proportional controller with this gain, in radians per second
+  // per radian of error
+  double headingGain = 8.0;
+  units::radians_per_second_t maxOmega = units::radians_per_second_t{12.0};
+  NoiseOptions noise;
+  // Whether to pass the measured pose's timestamp to Calculate, so it is
+  // predicted forward through the measurement latency
+  bool compensateLatency = false;
+};
+
+/**
+ * The outcome of a closed loop simulation.
+ */
+struct SimResult {
+  // Whether the robot reached the target within the profile's tolerances
+  bool arrived = false;
+  // Whether it then stayed within them for the settle time
+  bool settled = false;
+  // Time of the first arrival, or the timeout
+  units::second_t time = 0_s;
+  // Farthest the robot went past the target along its approach direction
+  units::meter_t overshoot = 0_m;
+  // True distance from the target when the simulation ended
+  units::meter_t finalError = 0_m;
+  // Times the commanded speed towards the target reversed
+  int oscillations = 0;
+  // Times AtTarget went from true back to false
+  int exits = 0;
+  // Total time simulated, including the settle time
+  units::second_t simulated = 0_s;
+};
+
+/**
+ * Drives an APSwervePlant with the given autopilot, from the scenario's
+ * start until the settle time has passed since it first arrived, or the
+ * timeout runs out. The autopilot's period is set to the simulation step.
+ * Nothing waits on the wall clock, so a simulation runs as fast as the
+ * plant can be stepped.
+ *
+ * Calculate and AtTarget see the measured pose, while the result is judged
+ * on the true pose. The measurement noise is drawn from the given seed, so
+ * a simulation is repeatable.
+ */
+SimResult Simulate(autopilot::Autopilot& autopilot, const Scenario& scenario,
+                   const SimOptions& options, uint64_t seed = 0);
+
+/**
+ * Generates scenarios on a 16 x 8 m field: starts up to 8 m from their
+ * targets with random headings and velocities of up to 2 m/s, and targets
+ * of which three quarters have entry angles.
+ */
+std::vector<Scenario> MakeScenarios(size_t count, uint32_t seed);
+
+/**
+ * Loads scenarios from a CSV file with one scenario per line:
+ * x,y,heading,vx,vy,targetX,targetY,targetHeading[,entryAngle]. Angles are
+ * in degrees. Blank lines and lines starting with # are skipped. Returns
+ * nothing if the file cannot be read or a line is malformed.
+ */
+std::optional<std::vector<Scenario>> LoadScenarios(std::string_view path);
+}  // namespace tools
@@ -0,0 +1,90 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include <wpi/DataLogReader.h>
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "autopilot/autopilot.h"
+#include "autopilot/telemetry.h"
+
+namespace tools {
+/**
+ * Streams the Autopilot telemetry written by APTelemetryLogger out of a
+ * WPILog file.
+ *
+ * The file is memory mapped rather than read into memory, and records are
+ * decoded one at a time straight from the mapping, so logs of any size are
+ * replayed in constant memory.
+ */
+class TelemetryLog {
+ public:
+  /**
+   * Called with the logger's name and the fields of a "<name>/profile"
+   * entry, in the order of APTelemetryLogger::kProfileFields.
+   */
+  using ProfileHandler =
+      std::function<void(std::string_view, std::span<const double>)>;
+
+  /**
+   * Called with the logger's name and a decoded "<name>/record" entry.
+   */
+  using RecordHandler =
+      std::function<void(std::string_view, const autopilot::APRecord&)>;
+
+  /**
+   * Opens the given file. Check IsValid before reading.
+   */
+  explicit TelemetryLog(std::string_view path);
+
+  /**
+   * Returns whether the file could be opened and is a WPILog.
+   */
+  bool IsValid() const;
+
+  /**
+   * Returns why the file could not be opened, if it could not.
+   */
+  const std::string& Error() const;
+
+  /**
+   * Returns the size of the file in bytes.
+   */
+  size_t Size() const;
+
+  /**
+   * Calls the handlers for every profile and record in the log, in log order.
+   * Entries not written by an APTelemetryLogger are skipped.
+   */
+  void Read(const ProfileHandler& onProfile, const RecordHandler& onRecord);
+
+ private:
+  std::optional<wpi::log::DataLogReader> m_reader;
+  std::string m_error;
+  size_t m_size = 0;
+};
+
+/**
+ * Rebuilds the Autopilot described by the fields of a "<name>/profile" entry.
+ * Returns nullopt if there are too few fields.
+ */
+std::optional<autopilot::Autopilot> MakeAutopilot(
+    std::span<const double> profile);
+
+/**
+ * Rebuilds the target a record was calculated against.
+ */
+autopilot::APTarget MakeTarget(const autopilot::APRecord& record);
+}  // namespace tools
@@ -0,0 +1,123 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include <span>
+#include <string_view>
+
+namespace tools {
+/**
+ * The arguments following a subcommand's name.
+ */
+using Args = std::span<const std::string_view>;
+
+/**
+ * Usage: replay [--jobs N] [--tolerance T] [--fast] <log.wpilog>...
+ *
+ * Replays the Autopilot telemetry recorded by APTelemetryLogger through the
+ * current Autopilot and reports every output that differs from the recorded
+ * one by more than the tolerance, along with the throughput reached. Logs are
+ * replayed in parallel on N threads. --fast replays with APMathMode::kFast
+ * regardless of the recorded mode.
+ *
+ * Replay does not load velocity fields, so records whose goal came from an
+ * APVelocityField are counted as field backed and not compared.
+ *
+ * Returns zero if every record matched.
+ */
+int Replay(Args args);
+
+/**
+ * Usage: tune [--velocity MIN:MAX:STEPS] [--acceleration MIN:MAX:STEPS]
+ *             [--jerk MIN:MAX:STEPS] [--beeline MIN:MAX:STEPS]
+ *             [--error-xy M] [--error-theta DEG] [--max-overshoot M]
+ *             [--scenarios N | --scenario-file FILE] [--seed S]
+ *             [--refine ROUNDS] [--lag S] [--plant-accel A]
+ *             [--plant-velocity V] [--latency S] [--jobs N]
+ *
+ * Searches for the constraints and beeline radius that minimize the total
+ * time to drive a library of scenarios on a simulated swerve drivetrain,
+ * without overshooting any target by more than the limit or failing to
+ * settle within tolerance. Every grid point is simulated on every scenario
+ * across a work stealing pool, then the best point is refined with a
+ * pattern search. Prints the result as a ready to use APProfile and
+ * APStaticProfile.
+ *
+ * Returns zero if a feasible profile was found.
+ */
+int Tune(Args args);
+
+/**
+ * Usage: montecarlo [--velocity V] [--acceleration A] [--jerk J]
+ *                   [--deceleration A] [--velocity-x V] [--velocity-y V]
+ *                   [--beeline M] [--friction-circle 0|1]
+ *                   [--error-xy M] [--error-theta DEG]
+ *                   [--scenarios N | --scenario-file FILE] [--rollouts N]
+ *                   [--pose-noise M] [--heading-noise DEG]
+ *                   [--delay-min S] [--delay-max S] [--lag S]
+ *                   [--plant-accel A] [--plant-decel A] [--plant-velocity V]
+ *                   [--pose-latency S] [--compensate 0|1] [--seed S]
+ *                   [--jobs N]
+ *
+ * Runs many noisy closed loop rollouts of one profile per scenario across
+ * a work stealing pool. Calculate and AtTarget see poses jittered by
+ * Gaussian noise, and every rollout draws its own transport delay between
+ * Calculate and the drivetrain, 40 to 80 ms by default. Poses can also be
+ * measured a fixed time late, and with --compensate 1 their timestamps are
+ * passed to Calculate to predict them forward. Reports the distributions of
+ * time to target, final error, oscillations and tolerance exits per
+ * scenario and overall, and the rollouts per second and multiple of real
+ * time reached. Results are repeatable for a given seed regardless of the
+ * thread count.
+ */
+int MonteCarlo(Args args);
+
+/**
+ * Usage: bake [--jerk J] [--deceleration A] [--beeline M] [--fast]
+ *             [--extent M] [--cell M] [--targets FILE] [--out FILE]
+ *             [--seed S]
+ *
+ * Bakes the goal velocity field of every fixed target listed in the targets
+ * file into an APVelocityField file for the robot to load at startup. The
+ * targets file has one target per line, x,y,heading,entryAngle[,endVelocity]
+ * with angles in degrees, and defaults to
+ * src/main/deploy/autopilot/targets.csv. The output defaults to
+ * velocity_field.bin next to it. Each grid covers the given extent around
+ * its target, 8 m by default, with samples the given cell size apart, 10 cm
+ * by default. The profile options must match the robot's profile, or the
+ * robot ignores the file.
+ *
+ * Loads the file back and reports its size, the goal velocity error against
+ * the exact field at random offsets, and the time per Calculate with and
+ * without the field.
+ */
+int Bake(Args args);
+
+/**
+ * Usage: realtime [--calls N] [--seed S] [--priority P] [--trace FILE]
+ *
+ * Measures the latency of Autopilot's per-tick path as a real time loop
+ * would see it. Times N randomized calls one by one, one million by
+ * default: targets built with each With* builder are driven through every
+ * scalar Calculate overload and AtTarget, on exact, fast, fully
+ * constrained, recording and baked autopilots, on a StaticAutopilot and
+ * through an APInterceptor towards moving targets, from anywhere on the
+ * field down to vanishingly small offsets. Runs as a SCHED_FIFO thread of
+ * the given priority, 80 by default, with its memory locked where the
+ * system allows, and reports the latency percentiles and the worst case per
+ * configuration. RealtimeTest checks that the same calls never allocate.
+ *
+ * --trace, in builds with AUTOPILOT_TRACE, also reports the time spent in
+ * each stage of Calculate while timing and writes the most recent stages to
+ * FILE as Chrome trace JSON. The trace points add to the latency.
+ *
+ * Returns zero unless an option is bad or a file cannot be written.
+ */
+int Realtime(Args args);
+}  // namespace tools
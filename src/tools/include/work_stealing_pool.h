@@ -0,0 +1,79 @@
+// Copyright (c) 2025 Dan Peled
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+//
+// Inspired by the Autopilot project in Java:
+// https://github.com/therekrab/autopilot/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tools {
+/**
+ * A fixed set of worker threads, each with its own task deque.
+ *
+ * Workers run their own tasks newest first and, once out of work, steal the
+ * oldest tasks from the other workers, so uneven tasks such as simulations
+ * of different lengths still keep every core busy.
+ */
+class WorkStealingPool {
+ public:
+  /**
+   * Starts the given number of workers. Zero uses one per hardware thread.
+   */
+  explicit WorkStealingPool(unsigned threads = 0);
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  /**
+   * Waits for queued tasks and stops the workers.
+   */
+  ~WorkStealingPool();
+
+  /**
+   * Returns the number of workers.
+   */
+  unsigned Size() const;
+
+  /**
+   * Calls fn(i) for every i in [0, count) across the workers and returns
+   * once every call has. The range is split into several chunks per worker,
+   * and the calling thread runs chunks too while it waits.
+   */
+  void ParallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+ private:
+  using Task = std::function<void()>;
+
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void Push(size_t worker, Task task);
+  // Pops from the back of the given worker's deque
+  bool PopLocal(size_t worker, Task& task);
+  // Pops from the front of any deque but the given worker's
+  bool Steal(size_t thief, Task& task);
+  void Run(size_t worker);
+
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  std::vector<std::thread> m_threads;
+  // Tasks queued but not yet popped
+  std::atomic<size_t> m_pending{0};
+  std::mutex m_sleepMutex;
+  std::condition_variable m_wake;
+  bool m_stopping = false;
+};
+}  // namespace tools